@@ -0,0 +1,78 @@
+#ifndef PERIPH_BACKEND_HPP
+#define PERIPH_BACKEND_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace periph {
+
+    /**
+     * Access a peripheral at a fixed address, e.g. on a bare-metal target or an identity mapping.
+     * 
+     * \tparam T The peripheral class to access.
+     * 
+     * \param address The address of the peripheral's first register.
+     * 
+     * \return Returns the peripheral at the given address.
+     */
+    template<typename T>
+    T& at( std::uintptr_t address ) {
+        return *reinterpret_cast<T*>( address );
+    }
+
+    /**
+     * A memory mapping of a window of peripheral registers into this process.
+     * 
+     * The window is mapped from a device file, either /dev/mem, in which case the offset is the
+     * physical address of the window, or a UIO device, in which case the offset selects the UIO
+     * memory map and must be the map index times the page size.
+     */
+    class device_map {
+        public:
+            /**
+             * Map a window of peripheral registers.
+             * 
+             * \param[in] path   The device file to map the window from.
+             * \param     offset The offset of the window within the device file.
+             * \param     size   The size of the window, in bytes.
+             */
+            device_map( const char* path, std::uint64_t offset, std::size_t size );
+
+            /**
+             * Unmap the window. Peripherals accessed through the window must not be used after.
+             */
+            ~device_map();
+
+            device_map( const device_map& ) = delete;            //!< Disallow copying.
+            device_map& operator=( const device_map& ) = delete; //!< Disallow copying.
+
+            /**
+             * Check whether or not the window was mapped successfully.
+             * 
+             * \retval true  The window is mapped.
+             * \retval false Opening or mapping the device file failed.
+             */
+            bool valid() const { return base != nullptr; }
+
+            /**
+             * Access a peripheral within the window.
+             * 
+             * \tparam T The peripheral class to access.
+             * 
+             * \param offset The offset of the peripheral's first register within the window.
+             * 
+             * \return Returns the peripheral at the given offset.
+             */
+            template<typename T>
+            T& at( std::size_t offset = 0 ) const {
+                return *reinterpret_cast<T*>( static_cast<std::byte*>( base ) + offset );
+            }
+
+        private:
+            void*       base; //!< The start of the mapped window, or null if mapping failed.
+            std::size_t size; //!< The size of the mapped window, in bytes.
+    };
+
+}
+
+#endif // #ifndef PERIPH_BACKEND_HPP
@@ -0,0 +1,180 @@
+#ifndef PERIPH_DMA_HPP
+#define PERIPH_DMA_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <span>
+
+namespace periph {
+
+    constexpr std::size_t   dma_size       = 48;        //!< The size of the DMA MM2S register block.
+    constexpr std::size_t   dma_desc_align = 64;        //!< The alignment of DMA descriptors.
+    constexpr std::uint32_t dma_max_length = 0x3FFFFFF; //!< The maximum buffer length, in bytes.
+
+    /**
+     * A scatter-gather DMA descriptor, laid out as an AXI DMA memory-to-stream descriptor.
+     * 
+     * The descriptors must be placed in memory the DMA engine can read and write, without CPU
+     * caching or with coherent DMA. The stream destination is kept in the low byte of the
+     * sideband word, and is forwarded as TDEST by DMA engines configured to do so.
+     */
+    struct alignas( dma_desc_align ) dma_desc {
+        volatile std::uint32_t next;       //!< Physical address of the next descriptor, low word.
+        volatile std::uint32_t next_msb;   //!< Physical address of the next descriptor, high word.
+        volatile std::uint32_t buffer;     //!< Physical address of the buffer, low word.
+        volatile std::uint32_t buffer_msb; //!< Physical address of the buffer, high word.
+        volatile std::uint32_t sideband;   //!< Stream sideband signals, including TDEST.
+        volatile std::uint32_t RESERVED_0; //!< Reserved word.
+        volatile std::uint32_t control;    //!< Buffer length and frame start/end flags.
+        volatile std::uint32_t status;     //!< Transferred length and completion flags.
+
+        std::array<volatile std::uint32_t,5> app; //!< User application words.
+    };
+
+    /**
+     * A ring of scatter-gather DMA descriptors, feeding buffers to a DMA engine in order.
+     * 
+     * The ring is circularly linked when created. Buffers are queued with
+     * submit( std::uint64_t, std::uint32_t, std::uint32_t ) and handed to the DMA engine with
+     * dma::kick( const dma_ring& ). Descriptors are reused once reclaim() has found their
+     * transfers complete. Each buffer is sent as one stream frame.
+     */
+    class dma_ring {
+        public:
+            /**
+             * Create an empty ring.
+             * 
+             * \param[in] descs     The descriptors making up the ring, which must stay valid for the
+             *                      lifetime of the ring.
+             * \param     phys_base The physical address of the first descriptor, as seen by the
+             *                      DMA engine.
+             */
+            dma_ring( std::span<dma_desc> descs, std::uint64_t phys_base );
+
+            /**
+             * Queue a buffer for transfer.
+             * 
+             * \param buffer_phys The physical address of the buffer, as seen by the DMA engine.
+             * \param length      The length of the buffer, in bytes, from one to dma_max_length.
+             * \param channel     The stream destination to send the buffer to, e.g. the index of
+             *                    the pulse-width-bit output to transmit it on.
+             * 
+             * \retval true  The buffer was queued.
+             * \retval false The ring is full or the length is out of range.
+             */
+            bool submit( std::uint64_t buffer_phys, std::uint32_t length, std::uint32_t channel );
+
+            /**
+             * Release the descriptors of completed transfers, oldest first.
+             * 
+             * \return Returns the number of transfers completed since the last call.
+             */
+            std::size_t reclaim( void );
+
+            /**
+             * Read the number of queued transfers not yet reclaimed.
+             * 
+             * \return Returns the number of descriptors in use.
+             */
+            std::size_t pending( void ) const { return num_pending; }
+
+            /**
+             * Check whether or not a transfer failed.
+             * 
+             * \retval true  The DMA engine flagged an error on a descriptor since the last reset.
+             * \retval false All reclaimed transfers succeeded.
+             */
+            bool failed( void ) const { return error; }
+
+            /**
+             * Read the physical address of the oldest descriptor not yet reclaimed.
+             * 
+             * \return Returns the physical address to start the DMA engine at.
+             */
+            std::uint64_t head_phys( void ) const { return phys( head ); }
+
+            /**
+             * Read the physical address of the most recently queued descriptor.
+             * 
+             * \return Returns the physical address to hand to the DMA engine as its tail.
+             */
+            std::uint64_t tail_phys( void ) const;
+
+        private:
+            std::span<dma_desc> descs;       //!< The descriptors making up the ring.
+            std::uint64_t       phys_base;   //!< The physical address of the first descriptor.
+            std::size_t         head;        //!< The index of the oldest descriptor in use.
+            std::size_t         num_pending; //!< The number of descriptors in use.
+            bool                error;       //!< Whether a completed descriptor flagged an error.
+
+            /**
+             * Compute the physical address of a descriptor.
+             * 
+             * \param index The index of the descriptor in the ring.
+             * 
+             * \return Returns the physical address of the descriptor.
+             */
+            std::uint64_t phys( std::size_t index ) const;
+    };
+
+    /**
+     * The memory-to-stream channel of an AXI DMA engine in scatter-gather mode.
+     */
+    class dma {
+        public:
+            dma() = delete;                        //!< Disallow default construction.
+            ~dma() = delete;                       //!< Disallow destruction.
+            dma( const dma& ) = delete;            //!< Disallow copy construction.
+            dma( dma&& ) = delete;                 //!< Disallow move construction.
+            dma& operator=( const dma& ) = delete; //!< Disallow copying.
+            dma& operator=( dma&& ) = delete;      //!< Disallow moving.
+
+            /**
+             * Reset the channel, aborting all transfers, and wait for the reset to complete.
+             */
+            void reset( void );
+
+            /**
+             * Start the channel at the oldest descriptor of the given ring.
+             * 
+             * The channel must be halted, i.e. not yet started since the last reset.
+             * 
+             * \param[in] ring The ring to fetch descriptors from.
+             */
+            void start( const dma_ring& ring );
+
+            /**
+             * Hand all descriptors queued to the given ring to the channel.
+             * 
+             * \param[in] ring The ring the channel was started at.
+             */
+            void kick( const dma_ring& ring );
+
+            /**
+             * Check whether or not the channel is halted.
+             * 
+             * \retval true  The channel is stopped, after a reset or an error.
+             * \retval false The channel is running.
+             */
+            bool halted( void ) const;
+
+            /**
+             * Check whether or not the channel has processed all descriptors handed to it.
+             * 
+             * \retval true  The channel is waiting for more descriptors.
+             * \retval false The channel is transferring data.
+             */
+            bool idle( void ) const;
+
+        private:
+            /**
+             * Size-equivalent stand-in for all memory-mapped registers of the channel.
+             */
+            std::array<volatile std::byte,dma_size> memory;
+    };
+
+}
+
+#endif // #ifndef PERIPH_DMA_HPP
@@ -0,0 +1,83 @@
+#ifndef PERIPH_DMA_MODEL_HPP
+#define PERIPH_DMA_MODEL_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+
+#include "periph_dma.hpp"
+#include "periph_sim.hpp"
+
+namespace periph::sim {
+
+    /**
+     * Behavioral model of the memory-to-stream channel of an AXI DMA engine in scatter-gather
+     * mode.
+     * 
+     * Physical addresses are taken to be addresses in this process, so descriptors and buffers are
+     * plain memory. Once started, the channel processes descriptors from the current descriptor up
+     * to and including the tail descriptor, and resumes after the last processed descriptor each
+     * time the tail is written, even if it is written with the same descriptor, as on a full ring.
+     * Buffers are sent to the sink one beat of up to four bytes per cycle, with the stream
+     * destination from the descriptor's sideband word, and with TLAST on the last beat of buffers
+     * flagged as the end of a frame. The channel stalls for the rest of a simulated interval when
+     * the sink refuses a beat. Completed descriptors are marked as such with the number of bytes
+     * transferred.
+     */
+    class dma_model : public model {
+        public:
+            /**
+             * Create a halted channel.
+             * 
+             * \param[in] sink     The stream port to send buffers to, which must outlive the model.
+             * \param     clock_hz The clock frequency to run the model at in real time, or zero to
+             *                     only advance the model explicitly.
+             */
+            explicit dma_model( axis_sink& sink, std::uint64_t clock_hz = 0 );
+
+            /**
+             * Access the driver of the channel.
+             * 
+             * \return Returns the channel driver.
+             */
+            dma& device();
+
+            /**
+             * Read the number of bytes sent to the sink.
+             * 
+             * \return Returns the number of bytes sent since construction.
+             */
+            std::uint64_t bytes_sent() const { return num_bytes; }
+
+        protected:
+            void run( std::uint64_t num_cycles ) override;
+            void write_fifo( std::size_t offset, std::uint32_t data ) override;
+
+        private:
+            /**
+             * The register window, laid out as in the AXI DMA memory-to-stream channel.
+             */
+            std::array<volatile std::uint32_t,dma_size/sizeof( std::uint32_t )> regs;
+
+            axis_sink&    sink;      //!< The stream port buffers are sent to.
+            bool          running;   //!< Whether the channel was started.
+            bool          busy;      //!< Whether descriptors up to the tail remain to be processed.
+            std::uint64_t next;      //!< The address of the descriptor to process next.
+            std::uint64_t tail;      //!< The last tail descriptor address written.
+            std::uint32_t offset;    //!< The number of bytes of the current buffer sent.
+            std::uint64_t num_bytes; //!< The number of bytes sent since construction.
+
+            /**
+             * Read a 64-bit address from a pair of registers.
+             * 
+             * \param index The index of the register holding the low word.
+             * 
+             * \return Returns the address.
+             */
+            std::uint64_t address( std::size_t index ) const;
+    };
+
+}
+
+#endif // #ifndef PERIPH_DMA_MODEL_HPP
@@ -0,0 +1,44 @@
+#ifndef PERIPH_IRQ_HPP
+#define PERIPH_IRQ_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+
+#include <poll.h>
+
+namespace periph {
+
+    /**
+     * The kind of file descriptor interrupts are delivered through.
+     */
+    enum class event_kind {
+        uio,     //!< A UIO device; the interrupt is re-armed by writing to the descriptor.
+        eventfd  //!< An eventfd signalled by some other party, e.g. a simulated backend.
+    };
+
+    /**
+     * Block until the next interrupt of any of a set of interrupt sources, and consume it.
+     * 
+     * UIO sources are unmasked before sleeping. Their interrupts are level-sensitive, so a
+     * peripheral already in need of service fires again immediately.
+     * 
+     * \param[in,out] sources    The file descriptors interrupts are delivered through, polled for
+     *                           input. The returned events of each are updated.
+     * \param[in]     kinds      The kind of each file descriptor of \a sources.
+     * \param         timeout_ms The longest time to wait, in milliseconds, or negative to wait
+     *                           indefinitely.
+     * 
+     * \return Returns the number of interrupt sources that fired, zero if waiting failed or timed
+     *         out.
+     */
+    std::size_t wait_irq(
+        std::span<pollfd>           sources,
+        std::span<const event_kind> kinds,
+        int                         timeout_ms
+    );
+
+}
+
+#endif // #ifndef PERIPH_IRQ_HPP
@@ -0,0 +1,210 @@
+#ifndef PERIPH_REACTOR_HPP
+#define PERIPH_REACTOR_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <coroutine>
+#include <exception>
+
+#include <poll.h>
+
+#include "periph_irq.hpp"
+
+namespace periph {
+
+    constexpr std::size_t reactor_max_sources = 16; //!< The interrupt sources a reactor sleeps on.
+
+    /**
+     * A coroutine started right away and owned by no one, as spawned onto a reactor.
+     * 
+     * The coroutine frame is freed when the coroutine returns. The drivers report errors through
+     * return values, so an exception escaping the coroutine terminates the program.
+     */
+    struct task {
+        /**
+         * The promise of a task.
+         */
+        struct promise_type {
+            task get_return_object() { return {}; }                       //!< Create the task.
+            std::suspend_never initial_suspend() noexcept { return {}; }  //!< Start right away.
+            std::suspend_never final_suspend() noexcept { return {}; }    //!< Free on return.
+            void return_void() {}                                         //!< Return nothing.
+            [[noreturn]] void unhandled_exception() { std::terminate(); } //!< Terminate.
+        };
+    };
+
+    /**
+     * A single-threaded event loop resuming coroutines suspended on peripheral operations.
+     * 
+     * Coroutines co_await the operations of the drivers' async headers, each of which polls its
+     * peripheral's status registers for progress. A pass of the reactor polls every suspended
+     * operation once, then resumes all coroutines whose operations completed in one batch, in the
+     * order they were suspended. When no operation completes, the reactor sleeps on the interrupt
+     * sources it watches, as long as every suspended operation is woken by one, and spins
+     * otherwise. One reactor thus drives any number of peripherals from a single thread.
+     * 
+     * Suspended operations live in the frames of their coroutines and are linked into the reactor
+     * in place, so suspending and resuming allocates no memory.
+     */
+    class reactor {
+        public:
+            using event_kind = periph::event_kind; //!< The kind of an interrupt source.
+
+            /**
+             * A peripheral operation a coroutine is suspended on, awaitable from a coroutine.
+             */
+            class operation {
+                public:
+                    /**
+                     * Try to complete the operation without suspending.
+                     * 
+                     * \retval true  The operation completed.
+                     * \retval false The operation is waiting for the peripheral.
+                     */
+                    bool await_ready() { return poll(); }
+
+                    /**
+                     * Suspend the awaiting coroutine on the reactor.
+                     * 
+                     * \param handle The awaiting coroutine.
+                     */
+                    void await_suspend( std::coroutine_handle<> handle );
+
+                    void await_resume() {} //!< Complete the operation.
+
+                protected:
+                    /**
+                     * Create an operation.
+                     * 
+                     * \param[in,out] io        The reactor to suspend on. Must outlive the
+                     *                          operation.
+                     * \param         interrupt Whether an interrupt source of the reactor signals
+                     *                          progress of the operation.
+                     */
+                    operation( reactor& io, bool interrupt ) :
+                        io( io ),
+                        interrupt( interrupt ),
+                        handle(),
+                        next( nullptr )
+                    {}
+
+                    ~operation() = default; //!< Destroy the operation.
+
+                    operation( const operation& ) = delete;            //!< Disallow copying.
+                    operation& operator=( const operation& ) = delete; //!< Disallow copying.
+
+                    /**
+                     * Make progress on the operation.
+                     * 
+                     * Called once per pass of the reactor while the operation is suspended.
+                     * 
+                     * \retval true  The operation completed.
+                     * \retval false The operation is still waiting for the peripheral.
+                     */
+                    virtual bool poll() = 0;
+
+                private:
+                    friend class reactor;
+
+                    reactor&                io;        //!< The reactor suspended on.
+                    bool                    interrupt; //!< Whether an interrupt signals progress.
+                    std::coroutine_handle<> handle;    //!< The suspended coroutine.
+                    operation*              next;      //!< The next suspended operation.
+            };
+
+            /**
+             * Create a reactor with no suspended operations and no interrupt sources.
+             */
+            reactor();
+
+            reactor( const reactor& ) = delete;            //!< Disallow copying.
+            reactor& operator=( const reactor& ) = delete; //!< Disallow copying.
+
+            /**
+             * Watch an interrupt source, to sleep on while no operation completes.
+             * 
+             * The file descriptor is not owned by the reactor and must outlive it. The interrupts
+             * of the peripherals, e.g. the refill interrupt of a pulse-width-bit peripheral, must
+             * be enabled separately.
+             * 
+             * \param fd   The file descriptor interrupts are delivered through.
+             * \param kind The kind of file descriptor \a fd is.
+             * 
+             * \retval true  The interrupt source is watched.
+             * \retval false The reactor already watches reactor_max_sources interrupt sources.
+             */
+            bool watch( int fd, event_kind kind = event_kind::uio );
+
+            /**
+             * Poll every suspended operation once, and resume the coroutines of those completed.
+             * 
+             * \return Returns the number of coroutines resumed.
+             */
+            std::size_t poll();
+
+            /**
+             * Poll until at least one coroutine is resumed, sleeping on the interrupt sources in
+             * between if all suspended operations are signalled by interrupts.
+             * 
+             * \param timeout_ms The longest time to wait, in milliseconds. A negative value waits
+             *                   indefinitely.
+             * 
+             * \return Returns the number of coroutines resumed, zero if the wait timed out or no
+             *         coroutine is suspended.
+             */
+            std::size_t run_once( int timeout_ms = -1 );
+
+            /**
+             * Resume coroutines until none is suspended on the reactor any more.
+             */
+            void run();
+
+            /**
+             * Read the number of coroutines suspended on the reactor.
+             * 
+             * \return Returns the number of suspended coroutines.
+             */
+            std::size_t pending() const { return num_pending; }
+
+            /**
+             * Read the number of interrupts the reactor has woken up on.
+             * 
+             * \return Returns the number of interrupts handled since construction.
+             */
+            std::size_t wakeups() const { return num_wakeups; }
+
+        private:
+            operation*  head;        //!< The first suspended operation, in suspension order.
+            operation*  tail;        //!< The last suspended operation.
+            std::size_t num_pending; //!< The number of suspended operations.
+            std::size_t num_polled;  //!< The number of suspended operations without interrupts.
+            std::size_t num_wakeups; //!< The number of interrupts handled.
+            std::size_t num_sources; //!< The number of interrupt sources watched.
+
+            std::array<pollfd,reactor_max_sources>     sources; //!< The interrupt sources.
+            std::array<event_kind,reactor_max_sources> kinds;   //!< The kind of each source.
+
+            /**
+             * Append an operation to the suspended operations.
+             * 
+             * \param[in,out] op The operation to suspend.
+             */
+            void suspend( operation& op );
+
+            /**
+             * Block until the next interrupt of any interrupt source.
+             * 
+             * \param timeout_ms The longest time to wait, in milliseconds, or negative to wait
+             *                   indefinitely.
+             * 
+             * \retval true  An interrupt occurred.
+             * \retval false Waiting failed or timed out.
+             */
+            bool wait( int timeout_ms );
+    };
+
+}
+
+#endif // #ifndef PERIPH_REACTOR_HPP
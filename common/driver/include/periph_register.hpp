@@ -0,0 +1,76 @@
+#ifndef PERIPH_REGISTER_HPP
+#define PERIPH_REGISTER_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <atomic>
+
+namespace periph {
+
+    namespace detail {
+
+        /**
+         * Wait until all previous register and memory writes are visible to the peripherals.
+         * 
+         * Volatile register accesses are kept in program order by the compiler, and device
+         * memory keeps them in order towards a single peripheral, so only ordering against
+         * other agents, e.g. other cores or DMA engines, needs an explicit barrier. Unlike a
+         * thread fence, this also orders normal memory writes before later device writes.
+         */
+        inline void io_barrier() {
+#if defined( __aarch64__ )
+            asm volatile( "dsb st" ::: "memory" );
+#elif defined( __arm__ )
+            asm volatile( "dsb" ::: "memory" );
+#elif defined( __x86_64__ ) || defined( __i386__ )
+            asm volatile( "sfence" ::: "memory" );
+#else
+            std::atomic_thread_fence( std::memory_order_seq_cst );
+#endif
+        }
+
+        /**
+         * The unsigned integer type of a register of the given width.
+         * 
+         * \tparam DataWidth The AXI data width the peripheral was built with, in bits.
+         */
+        template<std::size_t DataWidth>
+        struct register_word_of {
+            static_assert(
+                ( DataWidth == 16 ) || ( DataWidth == 32 ) || ( DataWidth == 64 ),
+                "Unsupported AXI data width"
+            );
+        };
+
+        template<>
+        struct register_word_of<16> {
+            using type = std::uint16_t; //!< A 16-bit register.
+        };
+
+        template<>
+        struct register_word_of<32> {
+            using type = std::uint32_t; //!< A 32-bit register.
+        };
+
+        template<>
+        struct register_word_of<64> {
+            using type = std::uint64_t; //!< A 64-bit register.
+        };
+
+    }
+
+    /**
+     * The unsigned integer type of a register of a peripheral built with the given AXI data width.
+     * 
+     * Registers of such peripherals are spaced by their own size, following the AXI_DATA_WIDTH
+     * generic of the HDL cores.
+     * 
+     * \tparam DataWidth The AXI data width the peripheral was built with: 16, 32 or 64 bits.
+     */
+    template<std::size_t DataWidth>
+    using register_word = typename detail::register_word_of<DataWidth>::type;
+
+}
+
+#endif // #ifndef PERIPH_REGISTER_HPP
@@ -0,0 +1,225 @@
+#ifndef PERIPH_REGISTRY_HPP
+#define PERIPH_REGISTRY_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+#include <vector>
+
+#include "periph_backend.hpp"
+
+namespace periph {
+
+    /**
+     * The offset of the identification register from the base of each peripheral core.
+     */
+    constexpr std::size_t id_offset = 0x0C;
+
+    /**
+     * The kind of a peripheral core, as reported by its identification register.
+     */
+    enum class device_type : std::uint8_t {
+        unknown = 0x00, //!< No known peripheral core.
+        pw_bit  = 0x42, //!< A pulse-width-bit core, axi_pw_bit.
+        pwm     = 0x50  //!< A phase-aligned PWM core, axi_pwm.
+    };
+
+    /**
+     * The identity and capabilities of a peripheral core.
+     */
+    struct device_info {
+        device_type   type;        //!< The kind of core.
+        std::uint32_t version;     //!< The register interface version of the core.
+        std::size_t   fifo_depth;  //!< The depth of the core's FIFOs, in words.
+        std::size_t   index;       //!< The index of the output the register was read from.
+        std::size_t   num_outputs; //!< The number of outputs the core was built with.
+        std::size_t   offset;      //!< The offset of the core within its register window.
+    };
+
+    /**
+     * Decode the value of an identification register.
+     * 
+     * \param word The value read from the identification register.
+     * 
+     * \return Returns the decoded identity, with a zero offset. The type is
+     *         device_type::unknown if the value is not a valid identification.
+     */
+    device_info decode_id( std::uint32_t word );
+
+    /**
+     * Encode an identity as the value of an identification register, e.g. for simulation.
+     * 
+     * \param info The identity to encode. The FIFO depth must be a power of two, and the offset
+     *             is not encoded.
+     * 
+     * \return Returns the identification register value.
+     */
+    std::uint32_t encode_id( const device_info& info );
+
+    /**
+     * Registry properties of a peripheral driver class.
+     * 
+     * Specializations provide the device_type \a type of cores the class drives, the register
+     * interface \a version of those cores the class's register layout matches, the
+     * \a output_stride between the handles of consecutive outputs, or zero if a single handle
+     * drives all outputs of a core, the \a num_outputs the class's register layout is built for,
+     * or zero if it fits any core, and the \a data_width of its registers.
+     * 
+     * \tparam T The peripheral driver class.
+     */
+    template<typename T>
+    struct device_traits;
+
+    /**
+     * A registry of the peripheral cores in one aperture of the physical address space.
+     * 
+     * The whole aperture is mapped with a single mmap when the registry is created, and each
+     * candidate core base is identified by reading its identification register once. Handles
+     * returned by get( std::size_t, std::size_t ) point into that mapping, are checked against
+     * the number of cores of their type and the number of outputs of their core, and stay valid
+     * for the lifetime of the registry.
+     */
+    class device_registry {
+        public:
+            /**
+             * Map an aperture and probe for cores at a fixed stride.
+             * 
+             * Every stride-aligned offset in the aperture is read, so every such address must
+             * respond, e.g. through an interconnect with a default slave. Otherwise, the cores
+             * must be listed explicitly.
+             * 
+             * \param[in] path   The device file to map the aperture from, e.g. /dev/mem.
+             * \param     base   The physical address of the aperture.
+             * \param     size   The size of the aperture, in bytes.
+             * \param     stride The distance between candidate core bases, in bytes.
+             */
+            device_registry(
+                const char*   path,
+                std::uint64_t base,
+                std::size_t   size,
+                std::size_t   stride = 0x10000
+            );
+
+            /**
+             * Map an aperture and probe for cores at the given offsets.
+             * 
+             * \param[in] path    The device file to map the aperture from, e.g. /dev/mem.
+             * \param     base    The physical address of the aperture.
+             * \param     size    The size of the aperture, in bytes.
+             * \param     offsets The offsets of the candidate core bases within the aperture.
+             *                    Offsets out of the aperture or without a known core are skipped.
+             */
+            device_registry(
+                const char*                  path,
+                std::uint64_t                base,
+                std::size_t                  size,
+                std::span<const std::size_t> offsets
+            );
+
+            /**
+             * Check whether or not the aperture was mapped successfully.
+             * 
+             * \retval true  The aperture is mapped.
+             * \retval false Opening or mapping the device file failed.
+             */
+            bool valid() const { return window.valid(); }
+
+            /**
+             * List the cores found, in ascending address order.
+             * 
+             * \return Returns the identity of each core found.
+             */
+            std::span<const device_info> devices() const { return found; }
+
+            /**
+             * Count the cores of a given type.
+             * 
+             * \param type The type of core to count.
+             * 
+             * \return Returns the number of cores found of type \a type.
+             */
+            std::size_t count( device_type type ) const;
+
+            /**
+             * Look up a core by type and instance number.
+             * 
+             * \param type     The type of core to look up.
+             * \param instance The instance number of the core among cores of its type, in
+             *                 ascending address order.
+             * 
+             * \return Returns the identity of the core, or null if there are not that many cores
+             *         of type \a type.
+             */
+            const device_info* find( device_type type, std::size_t instance ) const;
+
+            /**
+             * Access a peripheral in the aperture.
+             * 
+             * \tparam T The peripheral driver class to access, with device_traits defined.
+             * 
+             * \param instance The instance number of the core among cores driven by \a T.
+             * \param output   The index of the output to access, for classes driving one output
+             *                 per handle. Must be zero for classes driving a whole core.
+             * 
+             * \return Returns the peripheral, or null if the core or output does not exist, or if
+             *         the core has a different register interface version or was built with a
+             *         different number of outputs than \a T expects.
+             */
+            template<typename T>
+            T* get( std::size_t instance, std::size_t output = 0 ) const {
+                using traits = device_traits<T>;
+
+                static_assert( traits::data_width == 32, "Only 32-bit cores can be identified" );
+
+                constexpr std::size_t stride = traits::output_stride;
+
+                const device_info* info = find( traits::type, instance );
+                if ( ( info == nullptr ) || !in_range( *info, output, stride, sizeof( T ) ) ) {
+                    return nullptr;
+                }
+                if ( info->version != traits::version ) {
+                    return nullptr;
+                }
+                if ( ( traits::num_outputs != 0 ) && ( traits::num_outputs != info->num_outputs ) ) {
+                    return nullptr;
+                }
+
+                return &window.at<T>( info->offset + output * stride );
+            }
+
+        private:
+            device_map               window; //!< The mapping of the whole aperture.
+            std::size_t              size;   //!< The size of the aperture, in bytes.
+            std::vector<device_info> found;  //!< The cores found, in ascending address order.
+
+            /**
+             * Identify the core at an offset, recording it if known.
+             * 
+             * \param offset The offset of the candidate core base within the aperture.
+             */
+            void probe( std::size_t offset );
+
+            /**
+             * Check whether or not an output handle lies within its core and the aperture.
+             * 
+             * \param info        The identity of the core.
+             * \param output      The index of the output.
+             * \param stride      The distance between output handles, or zero for whole-core
+             *                    handles.
+             * \param handle_size The size of the register block of a handle, in bytes.
+             * 
+             * \retval true  The handle is valid.
+             * \retval false The output does not exist.
+             */
+            bool in_range(
+                const device_info& info,
+                std::size_t        output,
+                std::size_t        stride,
+                std::size_t        handle_size
+            ) const;
+    };
+
+}
+
+#endif // #ifndef PERIPH_REGISTRY_HPP
@@ -0,0 +1,158 @@
+#ifndef PERIPH_SIM_HPP
+#define PERIPH_SIM_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <chrono>
+
+namespace periph::sim {
+
+    /**
+     * A behavioral model of a peripheral, backing the peripheral's registers with plain memory.
+     * 
+     * The drivers in the periph_sim library notify the model owning a register window before
+     * accessing it, and after writing a register whose write has side effects, such as a FIFO
+     * data register. The model advances its own simulated clock, either explicitly through
+     * advance( std::uint64_t ), or, when given a clock frequency, by the real time elapsed since
+     * its construction each time it is accessed. The drivers in the periph library carry no
+     * notifications and must not be used with a model.
+     * 
+     * Models are not thread-safe. A model and the drivers accessing it must be used from a single
+     * thread at a time.
+     */
+    class model {
+        public:
+            virtual ~model(); //!< Detach the model from its register window.
+
+            model( const model& ) = delete;            //!< Disallow copying.
+            model& operator=( const model& ) = delete; //!< Disallow copying.
+
+            /**
+             * Read the simulated time.
+             * 
+             * \return Returns the number of clock cycles simulated since construction.
+             */
+            std::uint64_t now() const { return cycles; }
+
+            /**
+             * Simulate a number of clock cycles.
+             * 
+             * \param num_cycles The number of clock cycles to simulate.
+             */
+            void advance( std::uint64_t num_cycles );
+
+            /**
+             * Bring the model up to date before its registers are accessed.
+             * 
+             * A free-running model simulates the clock cycles corresponding to the real time
+             * elapsed since it was last brought up to date. Status registers are refreshed.
+             */
+            void sync();
+
+        protected:
+            using clock = std::chrono::steady_clock; //!< The clock a free-running model follows.
+
+            /**
+             * Attach a model to its register window.
+             * 
+             * \param[in] base     The start of the register window.
+             * \param     size     The size of the register window, in bytes.
+             * \param     clock_hz The clock frequency to run the model at in real time, or zero to
+             *                     only advance the model explicitly.
+             */
+            model( const volatile void* base, std::size_t size, std::uint64_t clock_hz );
+
+            /**
+             * Simulate a number of clock cycles and refresh the status registers.
+             * 
+             * \param num_cycles The number of clock cycles to simulate, possibly zero.
+             */
+            virtual void run( std::uint64_t num_cycles ) = 0;
+
+            /**
+             * Handle a write to a FIFO data register.
+             * 
+             * \param offset The offset of the written register within the register window.
+             * \param data   The value written.
+             */
+            virtual void write_fifo( std::size_t offset, std::uint32_t data );
+
+            /**
+             * Convert a clock cycle to the real time a free-running model reaches it at.
+             * 
+             * \param cycle The clock cycle to convert.
+             * 
+             * \return Returns the earliest time at which the model is brought up to \a cycle, or
+             *         clock::time_point::max() if the model only advances explicitly.
+             */
+            clock::time_point time_of( std::uint64_t cycle ) const;
+
+        private:
+            const volatile std::byte* base;     //!< The start of the register window.
+            std::size_t               size;     //!< The size of the register window, in bytes.
+            std::uint64_t             clock_hz; //!< The real-time clock frequency, or zero.
+            clock::time_point         start;    //!< The real time the model was created at.
+            std::uint64_t             cycles;   //!< The number of clock cycles simulated.
+
+            friend void on_access( const volatile void* reg );
+            friend void on_fifo_write( const volatile void* reg, std::uint32_t data );
+
+            /**
+             * Find the model whose register window contains the given address.
+             * 
+             * \param[in] reg The address to look up.
+             * 
+             * \return Returns the model owning the address, or null if there is none.
+             */
+            static model* find( const volatile void* reg );
+    };
+
+    /**
+     * A model accepting data over an AXI-Stream slave port.
+     */
+    class axis_sink {
+        public:
+            virtual ~axis_sink() = default; //!< Destroy the sink.
+
+            /**
+             * Offer one beat to the stream port.
+             * 
+             * \param dest The TDEST of the beat.
+             * \param data The TDATA of the beat.
+             * \param keep The TKEEP of the beat, one bit per byte of TDATA.
+             * \param last The TLAST of the beat, set on the last beat of a frame.
+             * 
+             * \retval true  The beat was accepted.
+             * \retval false The port is not ready, and the beat must be offered again.
+             */
+            virtual bool push(
+                std::uint32_t dest,
+                std::uint32_t data,
+                std::uint32_t keep,
+                bool          last
+            ) = 0;
+    };
+
+    /**
+     * Notify the model owning a register that the register is about to be accessed.
+     * 
+     * Does nothing if no model owns the register.
+     * 
+     * \param[in] reg The register about to be accessed.
+     */
+    void on_access( const volatile void* reg );
+
+    /**
+     * Notify the model owning a FIFO data register that a value was written to it.
+     * 
+     * Does nothing if no model owns the register.
+     * 
+     * \param[in] reg  The written register.
+     * \param     data The value written.
+     */
+    void on_fifo_write( const volatile void* reg, std::uint32_t data );
+
+}
+
+#endif // #ifndef PERIPH_SIM_HPP
@@ -0,0 +1,200 @@
+#ifndef PERIPH_TRACE_HPP
+#define PERIPH_TRACE_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+
+#if defined( PERIPH_TRACE ) && __has_include( <sys/sdt.h> )
+#include <sys/sdt.h>
+#define PERIPH_TRACE_USDT
+#endif
+
+namespace periph::trace {
+
+    /**
+     * Whether the drivers were built with instrumentation, i.e. with PERIPH_TRACE defined.
+     * 
+     * Otherwise every hook below is an empty inline function, and the drivers compile to the
+     * same code as without them.
+     */
+#ifdef PERIPH_TRACE
+    constexpr bool enabled = true;
+#else
+    constexpr bool enabled = false;
+#endif
+
+    constexpr std::size_t latency_buckets = 32; //!< The number of frame latency histogram bins.
+
+    /**
+     * Instrumentation counters of the driver calls made by one thread.
+     * 
+     * Each thread owns its counters and is their only writer, so updating them takes a relaxed
+     * load and store and never contends. Other threads may read them, e.g. from a monitoring
+     * thread handed the reference returned by local(), for as long as the owning thread lives.
+     */
+    struct thread_stats {
+        std::atomic<std::uint64_t> mmio_writes; //!< Hot-path register writes, FIFO words included.
+        std::atomic<std::uint64_t> fences;      //!< Write barriers issued.
+        std::atomic<std::uint64_t> full_stalls; //!< Writes refused or spins on a busy peripheral.
+        std::atomic<std::uint64_t> underruns;   //!< FIFOs found empty in the middle of a frame.
+        std::atomic<std::uint64_t> frames;      //!< Frames fully queued in a peripheral.
+
+        /**
+         * Histogram of the time from submitting a frame to queueing its end, in nanoseconds. Bin
+         * n counts frames taking from 2^n to 2^(n+1) - 1 ns, the last bin anything longer.
+         */
+        std::array<std::atomic<std::uint64_t>,latency_buckets> frame_ns;
+    };
+
+    namespace detail {
+
+        inline thread_local thread_stats current{}; //!< The counters of the calling thread.
+
+        /**
+         * Increment a counter owned by the calling thread.
+         * 
+         * \param[in,out] counter The counter to increment.
+         * \param         count   The amount to add.
+         */
+        inline void bump( std::atomic<std::uint64_t>& counter, std::uint64_t count = 1 ) {
+            counter.store( counter.load( std::memory_order_relaxed ) + count,
+                           std::memory_order_relaxed );
+        }
+
+    }
+
+    /**
+     * Access the counters of the calling thread.
+     * 
+     * \return Returns the counters of the calling thread, all zero if instrumentation is disabled.
+     */
+    inline thread_stats& local() {
+        return detail::current;
+    }
+
+    /**
+     * Clear the counters of the calling thread.
+     */
+    inline void reset() {
+        auto& stats = detail::current;
+
+        stats.mmio_writes.store( 0, std::memory_order_relaxed );
+        stats.fences.store( 0, std::memory_order_relaxed );
+        stats.full_stalls.store( 0, std::memory_order_relaxed );
+        stats.underruns.store( 0, std::memory_order_relaxed );
+        stats.frames.store( 0, std::memory_order_relaxed );
+        for ( auto& bin : stats.frame_ns ) {
+            bin.store( 0, std::memory_order_relaxed );
+        }
+    }
+
+    /**
+     * Record hot-path register writes.
+     * 
+     * \param count The number of registers written.
+     */
+    inline void on_mmio_write( [[maybe_unused]] std::size_t count = 1 ) {
+#ifdef PERIPH_TRACE
+        detail::bump( detail::current.mmio_writes, count );
+#endif
+    }
+
+    /**
+     * Record a write barrier.
+     */
+    inline void on_fence() {
+#ifdef PERIPH_TRACE
+        detail::bump( detail::current.fences );
+#endif
+    }
+
+    /**
+     * Record a write refused because a FIFO was full, or a spin on a peripheral still busy.
+     * 
+     * \param[in] dev The peripheral stalled on.
+     */
+    inline void on_full_stall( [[maybe_unused]] const volatile void* dev ) {
+#ifdef PERIPH_TRACE
+        detail::bump( detail::current.full_stalls );
+#endif
+#ifdef PERIPH_TRACE_USDT
+        DTRACE_PROBE1( periph, full_stall, dev );
+#endif
+    }
+
+    /**
+     * Record a FIFO found empty while a frame was still being queued.
+     * 
+     * \param[in] dev The peripheral that ran dry.
+     */
+    inline void on_underrun( [[maybe_unused]] const volatile void* dev ) {
+#ifdef PERIPH_TRACE
+        detail::bump( detail::current.underruns );
+#endif
+#ifdef PERIPH_TRACE_USDT
+        DTRACE_PROBE1( periph, underrun, dev );
+#endif
+    }
+
+    /**
+     * Measures the time a frame takes to be queued, from submission to its end-of-frame marker.
+     * 
+     * Empty when instrumentation is disabled, so it costs nothing as a [[no_unique_address]]
+     * member of the scheduler state.
+     */
+    class frame_timer {
+        public:
+            /**
+             * Start timing a frame.
+             */
+            void start() {
+#ifdef PERIPH_TRACE
+                started = now_ns();
+#endif
+            }
+
+            /**
+             * Record the frame as fully queued.
+             * 
+             * \param[in] dev The peripheral the frame was queued in.
+             */
+            void stop( [[maybe_unused]] const volatile void* dev ) {
+#ifdef PERIPH_TRACE
+                const std::uint64_t elapsed = now_ns() - started;
+                const std::size_t   log2    = ( elapsed > 1 ) ? std::bit_width( elapsed ) - 1 : 0;
+                const std::size_t   bin     = std::min( log2, latency_buckets - 1 );
+
+                detail::bump( detail::current.frames );
+                detail::bump( detail::current.frame_ns[bin] );
+#endif
+#ifdef PERIPH_TRACE_USDT
+                DTRACE_PROBE2( periph, frame, dev, elapsed );
+#endif
+            }
+
+        private:
+#ifdef PERIPH_TRACE
+            std::uint64_t started = 0; //!< The time the frame was submitted, in nanoseconds.
+
+            /**
+             * Read a monotonic timestamp.
+             * 
+             * \return Returns the current time, in nanoseconds.
+             */
+            static std::uint64_t now_ns() {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()
+                ).count();
+            }
+#endif
+    };
+
+}
+
+#endif // #ifndef PERIPH_TRACE_HPP
@@ -0,0 +1,189 @@
+#ifndef PERIPH_VCD_HPP
+#define PERIPH_VCD_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace periph::sim {
+
+    /**
+     * A writer of value change dump (VCD) files, as read by GTKWave and HDL simulators.
+     * 
+     * Signals are declared with add() before the first change is recorded, which writes the
+     * header. Changes must be recorded in nondecreasing time order, and only values differing
+     * from a signal's previous value are written, so a signal may be sampled every cycle at no
+     * cost to the size of the dump.
+     */
+    class vcd_writer {
+        public:
+            static constexpr std::size_t npos = std::size_t( -1 ); //!< No signal.
+
+            /**
+             * Create a writer.
+             * 
+             * \param[out] out       The stream to write the dump to. Must outlive the writer.
+             * \param      timescale The time unit of the dump, e.g. "10ns" for a 100 MHz clock.
+             * \param      scope     The name of the module all signals are declared in.
+             */
+            explicit vcd_writer(
+                std::ostream&    out,
+                std::string_view timescale = "1ns",
+                std::string_view scope     = "periph"
+            ) :
+                out( out ),
+                timescale( timescale ),
+                scope( scope ),
+                signals(),
+                time( 0 ),
+                started( false )
+            {}
+
+            vcd_writer( const vcd_writer& ) = delete;            //!< Disallow copying.
+            vcd_writer& operator=( const vcd_writer& ) = delete; //!< Disallow copying.
+
+            /**
+             * Declare a signal.
+             * 
+             * \param name  The name of the signal.
+             * \param width The width of the signal, from 1 to 64 bits.
+             * 
+             * \return Returns the index to record changes of the signal with, or npos if the
+             *         header was already written by the first change recorded.
+             */
+            std::size_t add( std::string_view name, std::size_t width = 1 ) {
+                if ( started ) {
+                    return npos;
+                }
+
+                signals.push_back(
+                    { std::string( name ), code( signals.size() ), width, 0, false }
+                );
+
+                return signals.size() - 1;
+            }
+
+            /**
+             * Record the value of a signal at a point in time, if it changed.
+             * 
+             * \param at     The time of the value, in units of the timescale. Must not be earlier
+             *               than that of any change recorded before.
+             * \param signal The index of the signal, as returned by add(). Changes of npos are
+             *               ignored.
+             * \param value  The value of the signal. Bits beyond its width are ignored.
+             */
+            void change( std::uint64_t at, std::size_t signal, std::uint64_t value ) {
+                if ( signal >= signals.size() ) {
+                    return;
+                }
+
+                auto& sig = signals[signal];
+
+                if ( sig.width < 64 ) {
+                    value &= ( std::uint64_t{ 1 } << sig.width ) - 1;
+                }
+                if ( !started ) {
+                    start( at );
+                }
+                if ( sig.known && ( value == sig.value ) ) {
+                    return;
+                }
+                if ( at != time ) {
+                    out << '#' << at << '\n';
+                    time = at;
+                }
+
+                sig.value = value;
+                sig.known = true;
+                dump( sig );
+            }
+
+        private:
+            /**
+             * A declared signal.
+             */
+            struct signal_state {
+                std::string   name;  //!< The name of the signal.
+                std::string   id;    //!< The identifier code of the signal in the dump.
+                std::size_t   width; //!< The width of the signal, in bits.
+                std::uint64_t value; //!< The last value written.
+                bool          known; //!< Whether a value was written.
+            };
+
+            std::ostream&             out;       //!< The stream written to.
+            std::string               timescale; //!< The time unit of the dump.
+            std::string               scope;     //!< The module of all signals.
+            std::vector<signal_state> signals;   //!< The declared signals.
+            std::uint64_t             time;      //!< The time of the last change written.
+            bool                      started;   //!< Whether the header was written.
+
+            /**
+             * Build the identifier code of a signal, from the printable ASCII characters.
+             * 
+             * \param index The index of the signal.
+             * 
+             * \return Returns the identifier code.
+             */
+            static std::string code( std::size_t index ) {
+                constexpr char        first = '!';
+                constexpr std::size_t radix = '~' - '!' + 1;
+
+                std::string id;
+                do {
+                    id.push_back( char( first + index % radix ) );
+                    index /= radix;
+                } while ( index > 0 );
+
+                return id;
+            }
+
+            /**
+             * Write the header, with all signals unknown until their first change.
+             * 
+             * \param at The time of the first change.
+             */
+            void start( std::uint64_t at ) {
+                out << "$timescale " << timescale << " $end\n";
+                out << "$scope module " << scope << " $end\n";
+                for ( const auto& sig : signals ) {
+                    out << "$var wire " << sig.width << ' ' << sig.id << ' ' << sig.name
+                        << " $end\n";
+                }
+                out << "$upscope $end\n$enddefinitions $end\n";
+
+                out << '#' << at << "\n$dumpvars\n";
+                for ( const auto& sig : signals ) {
+                    out << ( ( sig.width == 1 ) ? "x" : "bx " ) << sig.id << '\n';
+                }
+                out << "$end\n";
+
+                time    = at;
+                started = true;
+            }
+
+            /**
+             * Write the value of a signal.
+             * 
+             * \param sig The signal to write the value of.
+             */
+            void dump( const signal_state& sig ) {
+                if ( sig.width == 1 ) {
+                    out << char( '0' + sig.value ) << sig.id << '\n';
+                    return;
+                }
+
+                out << 'b';
+                for ( std::size_t bit = sig.width; bit-- > 0; ) {
+                    out << char( '0' + ( ( sig.value >> bit ) & 1 ) );
+                }
+                out << ' ' << sig.id << '\n';
+            }
+    };
+
+}
+
+#endif // #ifndef PERIPH_VCD_HPP
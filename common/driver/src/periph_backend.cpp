@@ -0,0 +1,30 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "periph_backend.hpp"
+
+using namespace periph;
+
+device_map::device_map( const char* path, std::uint64_t offset, std::size_t size ) :
+    base( nullptr ),
+    size( size )
+{
+    const int fd = ::open( path, O_RDWR | O_SYNC );
+    if ( fd < 0 ) {
+        return;
+    }
+
+    void* addr = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset );
+    ::close( fd );
+
+    if ( addr != MAP_FAILED ) {
+        base = addr;
+    }
+}
+
+device_map::~device_map() {
+    if ( base != nullptr ) {
+        ::munmap( base, size );
+    }
+}
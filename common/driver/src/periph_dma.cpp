@@ -0,0 +1,181 @@
+#include "periph_dma.hpp"
+#include "periph_register.hpp"
+#ifdef PERIPH_SIM
+#include "periph_sim.hpp"
+#endif
+
+using namespace periph;
+
+namespace {
+
+    /**
+     * Register-wise access struct for the memory-mapped DMA memory-to-stream channel.
+     */
+    struct memory_map {
+        volatile std::uint32_t               dmacr;        //!< Control register.
+        volatile std::uint32_t               dmasr;        //!< Status register.
+        volatile std::uint32_t               curdesc;      //!< Current descriptor, low word.
+        volatile std::uint32_t               curdesc_msb;  //!< Current descriptor, high word.
+        volatile std::uint32_t               taildesc;     //!< Tail descriptor, low word.
+        volatile std::uint32_t               taildesc_msb; //!< Tail descriptor, high word.
+        std::array<volatile std::uint32_t,6> RESERVED_0;   //!< Reserved registers.
+    };
+    static_assert(
+        sizeof( dma ) == sizeof( memory_map ),
+        "User handle and register memory map size mismatch"
+    );
+    static_assert(
+        sizeof( dma_desc ) == dma_desc_align,
+        "Invalid descriptor struct size"
+    );
+
+    constexpr std::uint32_t dmacr_rs_bit     = 0x00000001; //!< Run/stop bit of the control register.
+    constexpr std::uint32_t dmacr_reset_bit  = 0x00000004; //!< Soft reset bit of the control register.
+    constexpr std::uint32_t dmasr_halted_bit = 0x00000001; //!< Halted bit of the status register.
+    constexpr std::uint32_t dmasr_idle_bit   = 0x00000002; //!< Idle bit of the status register.
+
+    constexpr std::uint32_t ctrl_length_mask = dma_max_length; //!< Buffer length field.
+    constexpr std::uint32_t ctrl_eof_bit     = 0x04000000;     //!< End of frame flag.
+    constexpr std::uint32_t ctrl_sof_bit     = 0x08000000;     //!< Start of frame flag.
+    constexpr std::uint32_t stat_error_bits  = 0x70000000;     //!< Transfer error flags.
+    constexpr std::uint32_t stat_cmplt_bit   = 0x80000000;     //!< Transfer complete flag.
+    constexpr std::uint32_t sideband_dest    = 0x000000FF;     //!< Stream destination field.
+
+    /**
+     * Cast a DMA user class to a register memory map.
+     * 
+     * \param[in] dev The opaque user DMA class to cast.
+     * 
+     * \return Returns the memory-mapped registers corresponding to the opaque user class.
+     */
+    memory_map& to_map( dma& dev ) {
+#ifdef PERIPH_SIM
+        sim::on_access( &dev );
+#endif
+        return *reinterpret_cast<memory_map*>( &dev );
+    }
+
+    /**
+     * Cast a read-only DMA user class to a register memory map.
+     * 
+     * \param[in] dev The read-only opaque user DMA class to cast.
+     * 
+     * \return Returns the read-only memory-mapped registers corresponding to the opaque user class.
+     */
+    const memory_map& to_map( const dma& dev ) {
+#ifdef PERIPH_SIM
+        sim::on_access( &dev );
+#endif
+        return *reinterpret_cast<const memory_map*>( &dev );
+    }
+
+}
+
+dma_ring::dma_ring( std::span<dma_desc> descs, std::uint64_t phys_base ) :
+    descs( descs ),
+    phys_base( phys_base ),
+    head( 0 ),
+    num_pending( 0 ),
+    error( false )
+{
+    for ( std::size_t i = 0; i < descs.size(); i++ ) {
+        const std::uint64_t next = phys( ( i + 1 ) % descs.size() );
+
+        descs[i].next       = static_cast<std::uint32_t>( next );
+        descs[i].next_msb   = static_cast<std::uint32_t>( next >> 32 );
+        descs[i].sideband   = 0;
+        descs[i].RESERVED_0 = 0;
+        descs[i].control    = 0;
+        descs[i].status     = 0;
+    }
+}
+
+bool dma_ring::submit( std::uint64_t buffer_phys, std::uint32_t length, std::uint32_t channel ) {
+    if ( ( num_pending >= descs.size() ) || ( length == 0 ) || ( length > dma_max_length ) ) {
+        return false;
+    }
+
+    auto& desc = descs[( head + num_pending ) % descs.size()];
+
+    desc.buffer     = static_cast<std::uint32_t>( buffer_phys );
+    desc.buffer_msb = static_cast<std::uint32_t>( buffer_phys >> 32 );
+    desc.sideband   = channel & sideband_dest;
+    desc.control    = ( length & ctrl_length_mask ) | ctrl_sof_bit | ctrl_eof_bit;
+    desc.status     = 0;
+    num_pending++;
+
+    return true;
+}
+
+std::size_t dma_ring::reclaim( void ) {
+    std::size_t num_reclaimed = 0;
+
+    while ( num_pending > 0 ) {
+        auto&               desc   = descs[head];
+        const std::uint32_t status = desc.status;
+
+        if ( !( status & stat_cmplt_bit ) ) {
+            break;
+        }
+        error = error || ( status & stat_error_bits );
+
+        desc.status = 0;
+        head        = ( head + 1 ) % descs.size();
+        num_pending--;
+        num_reclaimed++;
+    }
+
+    return num_reclaimed;
+}
+
+std::uint64_t dma_ring::tail_phys( void ) const {
+    return phys( ( head + num_pending + descs.size() - 1 ) % descs.size() );
+}
+
+std::uint64_t dma_ring::phys( std::size_t index ) const {
+    return phys_base + index * sizeof( dma_desc );
+}
+
+void dma::reset( void ) {
+    auto& map = to_map( *this );
+
+    map.dmacr = dmacr_reset_bit;
+    while ( to_map( *this ).dmacr & dmacr_reset_bit );
+}
+
+void dma::start( const dma_ring& ring ) {
+    auto&               map  = to_map( *this );
+    const std::uint64_t head = ring.head_phys();
+
+    map.curdesc     = static_cast<std::uint32_t>( head );
+    map.curdesc_msb = static_cast<std::uint32_t>( head >> 32 );
+    map.dmacr       = map.dmacr | dmacr_rs_bit;
+}
+
+void dma::kick( const dma_ring& ring ) {
+    if ( ring.pending() == 0 ) {
+        return;
+    }
+
+    auto&               map  = to_map( *this );
+    const std::uint64_t tail = ring.tail_phys();
+
+    // The descriptors must be in memory before the tail write lets the engine fetch them. A
+    // thread fence only orders against other cores, so a device barrier is needed here.
+    detail::io_barrier();
+
+    map.taildesc_msb = static_cast<std::uint32_t>( tail >> 32 );
+    map.taildesc     = static_cast<std::uint32_t>( tail );
+#ifdef PERIPH_SIM
+    // A full ring wraps back around to the same tail, so the write itself restarts the channel.
+    sim::on_fifo_write( &map.taildesc, static_cast<std::uint32_t>( tail ) );
+#endif
+}
+
+bool dma::halted( void ) const {
+    return to_map( *this ).dmasr & dmasr_halted_bit;
+}
+
+bool dma::idle( void ) const {
+    return to_map( *this ).dmasr & dmasr_idle_bit;
+}
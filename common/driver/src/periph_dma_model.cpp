@@ -0,0 +1,128 @@
+#include <algorithm>
+
+#include "periph_dma_model.hpp"
+
+using namespace periph;
+using namespace periph::sim;
+
+namespace {
+
+    constexpr std::size_t reg_dmacr    = 0; //!< Index of the control register.
+    constexpr std::size_t reg_dmasr    = 1; //!< Index of the status register.
+    constexpr std::size_t reg_curdesc  = 2; //!< Index of the current descriptor register.
+    constexpr std::size_t reg_taildesc = 4; //!< Index of the tail descriptor register.
+
+    constexpr std::uint32_t dmacr_rs_bit     = 0x00000001; //!< Run/stop bit of the control register.
+    constexpr std::uint32_t dmacr_reset_bit  = 0x00000004; //!< Soft reset bit of the control register.
+    constexpr std::uint32_t dmasr_halted_bit = 0x00000001; //!< Halted bit of the status register.
+    constexpr std::uint32_t dmasr_idle_bit   = 0x00000002; //!< Idle bit of the status register.
+    constexpr std::uint32_t dmasr_ioc_bit    = 0x00001000; //!< Completion interrupt bit.
+
+    constexpr std::uint32_t ctrl_length_mask = dma_max_length; //!< Buffer length field.
+    constexpr std::uint32_t ctrl_eof_bit     = 0x04000000;     //!< End of frame flag.
+    constexpr std::uint32_t stat_cmplt_bit   = 0x80000000;     //!< Transfer complete flag.
+    constexpr std::uint32_t sideband_dest    = 0x000000FF;     //!< Stream destination field.
+
+}
+
+dma_model::dma_model( axis_sink& sink, std::uint64_t clock_hz ) :
+    model( &regs, sizeof( regs ), clock_hz ),
+    regs{},
+    sink( sink ),
+    running( false ),
+    busy( false ),
+    next( 0 ),
+    tail( 0 ),
+    offset( 0 ),
+    num_bytes( 0 )
+{
+    regs[reg_dmasr] = dmasr_halted_bit;
+}
+
+dma& dma_model::device() {
+    return *reinterpret_cast<dma*>( const_cast<std::uint32_t*>( regs.data() ) );
+}
+
+void dma_model::run( std::uint64_t num_cycles ) {
+    if ( regs[reg_dmacr] & dmacr_reset_bit ) {
+        for ( auto& reg : regs ) {
+            reg = 0;
+        }
+        regs[reg_dmasr] = dmasr_halted_bit;
+        running         = false;
+    }
+
+    if ( !( regs[reg_dmacr] & dmacr_rs_bit ) ) {
+        regs[reg_dmasr] = ( regs[reg_dmasr] | dmasr_halted_bit ) & ~dmasr_idle_bit;
+        running         = false;
+        return;
+    }
+
+    // Starting latches the current descriptor, and the channel idles until a tail is written.
+    if ( !running ) {
+        running         = true;
+        busy            = false;
+        next            = address( reg_curdesc );
+        tail            = address( reg_taildesc );
+        offset          = 0;
+        regs[reg_dmasr] = ( regs[reg_dmasr] & ~dmasr_halted_bit ) | dmasr_idle_bit;
+    }
+
+    while ( busy && ( num_cycles > 0 ) ) {
+        auto& desc = *reinterpret_cast<dma_desc*>( static_cast<std::uintptr_t>( next ) );
+
+        const std::uint32_t length = desc.control & ctrl_length_mask;
+        const auto*         buffer = reinterpret_cast<const std::uint8_t*>(
+            static_cast<std::uintptr_t>( ( std::uint64_t{ desc.buffer_msb } << 32 ) | desc.buffer )
+        );
+
+        if ( offset < length ) {
+            const std::uint32_t num_beat_bytes = std::min<std::uint32_t>( length - offset, 4 );
+            const bool          last           =
+                ( offset + num_beat_bytes == length ) && ( desc.control & ctrl_eof_bit );
+
+            std::uint32_t data = 0;
+            for ( std::uint32_t i = 0; i < num_beat_bytes; i++ ) {
+                data |= std::uint32_t{ buffer[offset + i] } << ( 8 * i );
+            }
+
+            const std::uint32_t dest = desc.sideband & sideband_dest;
+            if ( !sink.push( dest, data, ( 1u << num_beat_bytes ) - 1, last ) ) {
+                break;
+            }
+            offset    += num_beat_bytes;
+            num_bytes += num_beat_bytes;
+            num_cycles--;
+        }
+
+        if ( offset >= length ) {
+            desc.status = stat_cmplt_bit | length;
+
+            regs[reg_curdesc]     = static_cast<std::uint32_t>( next );
+            regs[reg_curdesc + 1] = static_cast<std::uint32_t>( next >> 32 );
+            regs[reg_dmasr]       = regs[reg_dmasr] | dmasr_ioc_bit;
+
+            if ( next == tail ) {
+                busy            = false;
+                regs[reg_dmasr] = regs[reg_dmasr] | dmasr_idle_bit;
+            }
+            next   = ( std::uint64_t{ desc.next_msb } << 32 ) | desc.next;
+            offset = 0;
+        }
+    }
+}
+
+void dma_model::write_fifo( std::size_t offset, std::uint32_t ) {
+    // Writing the tail descriptor of a running channel resumes it, even at the same address.
+    if ( ( offset != reg_taildesc * sizeof( std::uint32_t ) ) || !running ) {
+        return;
+    }
+
+    tail            = address( reg_taildesc );
+    busy            = true;
+    regs[reg_dmasr] = regs[reg_dmasr] & ~dmasr_idle_bit;
+}
+
+std::uint64_t dma_model::address( std::size_t index ) const {
+    return ( std::uint64_t{ regs[index + 1] } << 32 ) | regs[index];
+}
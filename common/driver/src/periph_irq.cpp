@@ -0,0 +1,48 @@
+#include <cerrno>
+
+#include <unistd.h>
+
+#include "periph_irq.hpp"
+
+std::size_t periph::wait_irq(
+    std::span<pollfd>           sources,
+    std::span<const event_kind> kinds,
+    int                         timeout_ms
+) {
+    // UIO masks the interrupt each time it fires; unmask it before sleeping.
+    for ( std::size_t i = 0; i < sources.size(); i++ ) {
+        if ( kinds[i] == event_kind::uio ) {
+            const std::int32_t unmask = 1;
+            if ( ::write( sources[i].fd, &unmask, sizeof( unmask ) ) != sizeof( unmask ) ) {
+                return 0;
+            }
+        }
+    }
+
+    int ret;
+    do {
+        ret = ::poll( sources.data(), sources.size(), timeout_ms );
+    } while ( ( ret < 0 ) && ( errno == EINTR ) );
+    if ( ret <= 0 ) {
+        return 0;
+    }
+
+    // UIO reports a 32-bit interrupt count, eventfd a 64-bit counter; both are consumed here.
+    std::size_t num_fired = 0;
+    for ( std::size_t i = 0; i < sources.size(); i++ ) {
+        if ( !( sources[i].revents & POLLIN ) ) {
+            continue;
+        }
+
+        std::uint64_t     count;
+        const std::size_t count_size = ( kinds[i] == event_kind::uio ) ? sizeof( std::uint32_t )
+                                                                       : sizeof( std::uint64_t );
+        if ( ::read( sources[i].fd, &count, count_size ) != static_cast<ssize_t>( count_size ) ) {
+            return 0;
+        }
+
+        num_fired++;
+    }
+
+    return num_fired;
+}
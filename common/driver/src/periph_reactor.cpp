@@ -0,0 +1,128 @@
+#include <chrono>
+#include <span>
+
+#include "periph_reactor.hpp"
+
+using namespace periph;
+
+void reactor::operation::await_suspend( std::coroutine_handle<> handle ) {
+    this->handle = handle;
+    io.suspend( *this );
+}
+
+reactor::reactor() :
+    head( nullptr ),
+    tail( nullptr ),
+    num_pending( 0 ),
+    num_polled( 0 ),
+    num_wakeups( 0 ),
+    num_sources( 0 ),
+    sources(),
+    kinds()
+{}
+
+bool reactor::watch( int fd, event_kind kind ) {
+    if ( num_sources == reactor_max_sources ) {
+        return false;
+    }
+
+    sources[num_sources] = { fd, POLLIN, 0 };
+    kinds[num_sources]   = kind;
+    num_sources++;
+
+    return true;
+}
+
+std::size_t reactor::poll() {
+    operation* ready      = nullptr;
+    operation* ready_tail = nullptr;
+    operation* prev       = nullptr;
+
+    // Completed operations are unlinked first and resumed afterwards, so that coroutines
+    // suspending again while resumed are only polled on the next pass.
+    for ( operation* op = head; op != nullptr; ) {
+        operation* const next = op->next;
+
+        if ( op->poll() ) {
+            ( ( prev != nullptr ) ? prev->next : head ) = next;
+            if ( tail == op ) {
+                tail = prev;
+            }
+
+            op->next = nullptr;
+            ( ( ready_tail != nullptr ) ? ready_tail->next : ready ) = op;
+            ready_tail = op;
+        } else {
+            prev = op;
+        }
+
+        op = next;
+    }
+
+    std::size_t num_resumed = 0;
+    while ( ready != nullptr ) {
+        operation* const op = ready;
+        ready = op->next;
+
+        num_pending--;
+        num_polled -= op->interrupt ? 0 : 1;
+        num_resumed++;
+
+        // Resuming may complete the coroutine and free the operation along with its frame.
+        op->handle.resume();
+    }
+
+    return num_resumed;
+}
+
+std::size_t reactor::run_once( int timeout_ms ) {
+    using clock = std::chrono::steady_clock;
+
+    const auto deadline = clock::now() + std::chrono::milliseconds( timeout_ms );
+
+    while ( num_pending > 0 ) {
+        if ( const std::size_t num_resumed = poll(); num_resumed > 0 ) {
+            return num_resumed;
+        }
+
+        // Operations without an interrupt must be polled again right away, while the others
+        // sleep until their peripheral signals progress.
+        if ( ( num_polled > 0 ) || ( num_sources == 0 ) ) {
+            if ( ( timeout_ms >= 0 ) && ( clock::now() >= deadline ) ) {
+                return 0;
+            }
+            continue;
+        }
+        if ( !wait( timeout_ms ) ) {
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+void reactor::run() {
+    while ( num_pending > 0 ) {
+        run_once();
+    }
+}
+
+void reactor::suspend( operation& op ) {
+    op.next = nullptr;
+    ( ( tail != nullptr ) ? tail->next : head ) = &op;
+    tail = &op;
+
+    num_pending++;
+    num_polled += op.interrupt ? 0 : 1;
+}
+
+bool reactor::wait( int timeout_ms ) {
+    const std::size_t num_fired = wait_irq(
+        std::span( sources ).first( num_sources ),
+        std::span( kinds ).first( num_sources ),
+        timeout_ms
+    );
+    num_wakeups += num_fired;
+
+    return num_fired > 0;
+}
@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <bit>
+
+#include "periph_registry.hpp"
+
+using namespace periph;
+
+namespace {
+
+    constexpr std::uint32_t id_type_shift    = 24;         //!< Position of the core type field.
+    constexpr std::uint32_t id_version_shift = 20;         //!< Position of the version field.
+    constexpr std::uint32_t id_depth_shift   = 16;         //!< Position of the FIFO depth field.
+    constexpr std::uint32_t id_index_shift   = 8;          //!< Position of the output index field.
+    constexpr std::uint32_t id_version_mask  = 0x0000000F; //!< Width of the version field.
+    constexpr std::uint32_t id_depth_mask    = 0x0000000F; //!< Width of the FIFO depth field.
+    constexpr std::uint32_t id_byte_mask     = 0x000000FF; //!< Width of the byte-wide fields.
+
+}
+
+device_info periph::decode_id( std::uint32_t word ) {
+    auto type = static_cast<device_type>( ( word >> id_type_shift ) & id_byte_mask );
+
+    if ( ( type != device_type::pwm ) && ( type != device_type::pw_bit ) ) {
+        type = device_type::unknown;
+    }
+
+    return {
+        type,
+        ( word >> id_version_shift ) & id_version_mask,
+        std::size_t{ 1 } << ( ( word >> id_depth_shift ) & id_depth_mask ),
+        ( word >> id_index_shift ) & id_byte_mask,
+        word & id_byte_mask,
+        0
+    };
+}
+
+std::uint32_t periph::encode_id( const device_info& info ) {
+    const auto depth_log2 = static_cast<std::uint32_t>( std::countr_zero( info.fifo_depth ) );
+
+    return ( ( static_cast<std::uint32_t>( info.type ) & id_byte_mask ) << id_type_shift )
+         | ( ( info.version & id_version_mask ) << id_version_shift )
+         | ( ( depth_log2 & id_depth_mask ) << id_depth_shift )
+         | ( ( info.index & id_byte_mask ) << id_index_shift )
+         | ( info.num_outputs & id_byte_mask );
+}
+
+device_registry::device_registry(
+    const char*   path,
+    std::uint64_t base,
+    std::size_t   size,
+    std::size_t   stride
+) :
+    window( path, base, size ),
+    size( size )
+{
+    if ( !window.valid() || ( stride == 0 ) ) {
+        return;
+    }
+
+    for ( std::size_t offset = 0; offset < size; offset += stride ) {
+        probe( offset );
+    }
+}
+
+device_registry::device_registry(
+    const char*                  path,
+    std::uint64_t                base,
+    std::size_t                  size,
+    std::span<const std::size_t> offsets
+) :
+    window( path, base, size ),
+    size( size )
+{
+    if ( !window.valid() ) {
+        return;
+    }
+
+    std::vector<std::size_t> sorted( offsets.begin(), offsets.end() );
+    std::sort( sorted.begin(), sorted.end() );
+    sorted.erase( std::unique( sorted.begin(), sorted.end() ), sorted.end() );
+
+    for ( std::size_t offset : sorted ) {
+        probe( offset );
+    }
+}
+
+std::size_t device_registry::count( device_type type ) const {
+    return std::count_if(
+        found.begin(),
+        found.end(),
+        [type]( const device_info& info ) { return info.type == type; }
+    );
+}
+
+const device_info* device_registry::find( device_type type, std::size_t instance ) const {
+    for ( const auto& info : found ) {
+        if ( ( info.type == type ) && ( instance-- == 0 ) ) {
+            return &info;
+        }
+    }
+
+    return nullptr;
+}
+
+void device_registry::probe( std::size_t offset ) {
+    if ( ( offset > size ) || ( size - offset < id_offset + sizeof( std::uint32_t ) ) ) {
+        return;
+    }
+
+    device_info info = decode_id( window.at<volatile std::uint32_t>( offset + id_offset ) );
+
+    // Only the first output of a core identifies the core itself.
+    if ( ( info.type != device_type::unknown ) && ( info.index == 0 ) ) {
+        info.offset = offset;
+        found.push_back( info );
+    }
+}
+
+bool device_registry::in_range(
+    const device_info& info,
+    std::size_t        output,
+    std::size_t        stride,
+    std::size_t        handle_size
+) const {
+    const bool exists = ( stride == 0 ) ? ( output == 0 ) : ( output < info.num_outputs );
+
+    return exists && ( info.offset + output * stride + handle_size <= size );
+}
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <vector>
+
+#include "periph_sim.hpp"
+
+using namespace periph::sim;
+
+namespace {
+
+    /**
+     * Read the list of all live models.
+     * 
+     * \return Returns the list of all live models.
+     */
+    std::vector<model*>& models() {
+        static std::vector<model*> list;
+
+        return list;
+    }
+
+}
+
+model::model( const volatile void* base, std::size_t size, std::uint64_t clock_hz ) :
+    base( static_cast<const volatile std::byte*>( base ) ),
+    size( size ),
+    clock_hz( clock_hz ),
+    start( clock::now() ),
+    cycles( 0 )
+{
+    models().push_back( this );
+}
+
+model::~model() {
+    auto& list = models();
+
+    list.erase( std::remove( list.begin(), list.end(), this ), list.end() );
+}
+
+void model::advance( std::uint64_t num_cycles ) {
+    run( num_cycles );
+    cycles += num_cycles;
+}
+
+void model::sync() {
+    if ( clock_hz == 0 ) {
+        run( 0 );
+        return;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        clock::now() - start
+    ).count();
+
+    // Split the conversion so that the product does not overflow for long-running models.
+    const std::uint64_t ns_per_s = 1000000000;
+    const std::uint64_t target   = ( elapsed / ns_per_s ) * clock_hz
+                                 + ( elapsed % ns_per_s ) * clock_hz / ns_per_s;
+
+    advance( ( target > cycles ) ? ( target - cycles ) : 0 );
+}
+
+void model::write_fifo( std::size_t, std::uint32_t ) {}
+
+model::clock::time_point model::time_of( std::uint64_t cycle ) const {
+    if ( clock_hz == 0 ) {
+        return clock::time_point::max();
+    }
+
+    // Round up, so that syncing at the returned time simulates the cycle, as in sync().
+    const std::uint64_t ns_per_s = 1000000000;
+    const std::uint64_t ns       = ( cycle / clock_hz ) * ns_per_s
+                                 + ( ( cycle % clock_hz ) * ns_per_s + clock_hz - 1 ) / clock_hz;
+
+    return start + std::chrono::nanoseconds( ns );
+}
+
+model* model::find( const volatile void* reg ) {
+    const auto addr = static_cast<const volatile std::byte*>( reg );
+
+    for ( auto m : models() ) {
+        if ( ( addr >= m->base ) && ( addr < m->base + m->size ) ) {
+            return m;
+        }
+    }
+
+    return nullptr;
+}
+
+void periph::sim::on_access( const volatile void* reg ) {
+    if ( auto m = model::find( reg ) ) {
+        m->sync();
+    }
+}
+
+void periph::sim::on_fifo_write( const volatile void* reg, std::uint32_t data ) {
+    if ( auto m = model::find( reg ) ) {
+        m->write_fifo( static_cast<const volatile std::byte*>( reg ) - m->base, data );
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef PERIPH_CHECK_HPP
+#define PERIPH_CHECK_HPP
+
+#include <cstdio>
+
+namespace periph::test {
+
+    inline int num_failures = 0; //!< The number of failed checks of the test program.
+
+    /**
+     * Record the outcome of a check, and report it if it failed.
+     * 
+     * \param     passed Whether the checked condition holds.
+     * \param[in] expr   The checked condition, as written.
+     * \param[in] file   The file the check is in.
+     * \param     line   The line the check is on.
+     * 
+     * \return Returns \a passed.
+     */
+    inline bool check( bool passed, const char* expr, const char* file, int line ) {
+        if ( !passed ) {
+            std::fprintf( stderr, "%s:%d: check failed: %s\n", file, line, expr );
+            num_failures++;
+        }
+
+        return passed;
+    }
+
+    /**
+     * Run a test case, announcing it first.
+     * 
+     * \param[in] name The name of the test case.
+     * \param     test The test case.
+     */
+    inline void run( const char* name, void (*test)() ) {
+        std::printf( "%s\n", name );
+        test();
+    }
+
+    /**
+     * Summarize the checks of the test program.
+     * 
+     * \return Returns the exit status of the test program, non-zero if any check failed.
+     */
+    inline int result() {
+        std::printf( "%d check(s) failed\n", num_failures );
+
+        return ( num_failures == 0 ) ? 0 : 1;
+    }
+
+}
+
+/**
+ * Check a condition, reporting it along with its location if it does not hold.
+ */
+#define PERIPH_CHECK( expr ) \
+    periph::test::check( static_cast<bool>( expr ), #expr, __FILE__, __LINE__ )
+
+#endif // #ifndef PERIPH_CHECK_HPP
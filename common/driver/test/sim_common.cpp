@@ -0,0 +1,358 @@
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "periph_check.hpp"
+#include "periph_dma.hpp"
+#include "periph_dma_model.hpp"
+#include "periph_pw_bit_model.hpp"
+#include "periph_pwm_model.hpp"
+#include "periph_reactor.hpp"
+#include "periph_registry.hpp"
+#include "periph_vcd.hpp"
+
+using namespace periph;
+
+namespace {
+
+    /**
+     * A stream port recording every beat offered to it, refusing beats while stalled.
+     */
+    struct beat_recorder : sim::axis_sink {
+        std::vector<std::uint8_t>  bytes;   //!< The bytes accepted, in order.
+        std::vector<std::uint32_t> dests;   //!< The TDEST of each accepted beat.
+        std::size_t                frames  = 0;     //!< The number of beats with TLAST set.
+        bool                       stalled = false; //!< Whether beats are refused.
+
+        bool push(
+            std::uint32_t dest,
+            std::uint32_t data,
+            std::uint32_t keep,
+            bool          last
+        ) override {
+            if ( stalled ) {
+                return false;
+            }
+
+            for ( std::size_t i = 0; i < 4; i++ ) {
+                if ( keep & ( 1u << i ) ) {
+                    bytes.push_back( static_cast<std::uint8_t>( data >> ( 8 * i ) ) );
+                }
+            }
+            dests.push_back( dest );
+            frames += last ? 1 : 0;
+
+            return true;
+        }
+    };
+
+    /**
+     * Address a buffer the way the DMA model dereferences physical addresses.
+     */
+    std::uint64_t phys( const void* ptr ) {
+        return reinterpret_cast<std::uintptr_t>( ptr );
+    }
+
+    /**
+     * Copy the registers of a register model into an aperture file, at the given offset.
+     */
+    void place( int fd, std::size_t offset, const volatile void* regs, std::size_t size ) {
+        const auto        words = static_cast<const volatile std::uint32_t*>( regs );
+        std::vector<char> bytes( size );
+        for ( std::size_t i = 0; i < size / sizeof( std::uint32_t ); i++ ) {
+            const std::uint32_t word = words[i];
+            std::copy_n( reinterpret_cast<const char*>( &word ), sizeof( word ), &bytes[4 * i] );
+        }
+
+        PERIPH_CHECK( ::pwrite( fd, bytes.data(), size, off_t( offset ) ) == ssize_t( size ) );
+    }
+
+    /**
+     * Read the identification register of a register model.
+     */
+    std::uint32_t read_id( const volatile void* regs ) {
+        const auto words = static_cast<const volatile std::uint32_t*>( regs );
+
+        return words[id_offset / sizeof( std::uint32_t )];
+    }
+
+    void test_dma_ring() {
+        beat_recorder          port;
+        sim::dma_model         model( port );
+        std::array<dma_desc,4> descs{};
+        dma_ring               ring( descs, phys( descs.data() ) );
+        dma&                   engine = model.device();
+
+        const std::array<std::uint8_t,6> first  = { 1, 2, 3, 4, 5, 6 };
+        const std::array<std::uint8_t,3> second = { 7, 8, 9 };
+
+        engine.start( ring );
+        model.advance( 1 );
+        PERIPH_CHECK( !engine.halted() );
+        PERIPH_CHECK( engine.idle() );
+
+        PERIPH_CHECK( ring.submit( phys( first.data() ), first.size(), 2 ) );
+        PERIPH_CHECK( ring.submit( phys( second.data() ), second.size(), 3 ) );
+        PERIPH_CHECK( !ring.submit( phys( second.data() ), 0, 3 ) );
+        PERIPH_CHECK( ring.pending() == 2 );
+        PERIPH_CHECK( ring.reclaim() == 0 );
+
+        engine.kick( ring );
+        model.advance( 1 );
+        PERIPH_CHECK( !engine.idle() );
+
+        // A stalled stream port holds the engine on the current beat.
+        port.stalled = true;
+        model.advance( 100 );
+        PERIPH_CHECK( model.bytes_sent() == 4 );
+        port.stalled = false;
+
+        model.advance( 100 );
+        PERIPH_CHECK( engine.idle() );
+        PERIPH_CHECK( model.bytes_sent() == 9 );
+        PERIPH_CHECK( ( port.bytes == std::vector<std::uint8_t>{ 1, 2, 3, 4, 5, 6, 7, 8, 9 } ) );
+        PERIPH_CHECK( ( port.dests == std::vector<std::uint32_t>{ 2, 2, 3 } ) );
+        PERIPH_CHECK( port.frames == 2 );
+
+        PERIPH_CHECK( ring.reclaim() == 2 );
+        PERIPH_CHECK( ring.pending() == 0 );
+        PERIPH_CHECK( !ring.failed() );
+
+        // The ring wraps around its end, and refuses buffers once every descriptor is in use.
+        for ( std::size_t i = 0; i < descs.size(); i++ ) {
+            PERIPH_CHECK( ring.submit( phys( second.data() ), second.size(), 0 ) );
+        }
+        PERIPH_CHECK( !ring.submit( phys( second.data() ), second.size(), 0 ) );
+
+        engine.kick( ring );
+        model.advance( 100 );
+        PERIPH_CHECK( ring.reclaim() == descs.size() );
+        PERIPH_CHECK( model.bytes_sent() == 9 + descs.size() * second.size() );
+    }
+
+    /**
+     * An operation completing once its peripheral, a flag, is set.
+     */
+    class flag_wait : public reactor::operation {
+        public:
+            flag_wait( reactor& io, const bool& flag, bool interrupt ) :
+                operation( io, interrupt ),
+                flag( flag )
+            {}
+
+        private:
+            const bool& flag; //!< The flag waited for.
+
+            bool poll() override { return flag; }
+    };
+
+    /**
+     * Wait for a flag, then count the completion.
+     */
+    task await_flag( reactor& io, const bool& flag, bool interrupt, int& done ) {
+        co_await flag_wait( io, flag, interrupt );
+        done++;
+    }
+
+    void test_reactor() {
+        reactor io;
+        bool    ready = false;
+        int     done  = 0;
+
+        // A completed operation never suspends its coroutine.
+        ready = true;
+        await_flag( io, ready, true, done );
+        PERIPH_CHECK( done == 1 );
+        PERIPH_CHECK( io.pending() == 0 );
+
+        ready = false;
+        await_flag( io, ready, true, done );
+        await_flag( io, ready, true, done );
+        PERIPH_CHECK( io.pending() == 2 );
+        PERIPH_CHECK( io.poll() == 0 );
+
+        // Operations signalled by interrupts sleep on the interrupt sources until the timeout.
+        const int fd = ::eventfd( 0, EFD_CLOEXEC );
+        PERIPH_CHECK( fd >= 0 );
+        PERIPH_CHECK( io.watch( fd, reactor::event_kind::eventfd ) );
+        PERIPH_CHECK( io.run_once( 10 ) == 0 );
+        PERIPH_CHECK( io.wakeups() == 0 );
+
+        // An interrupt wakes the reactor to poll the operations again.
+        const std::uint64_t one = 1;
+        PERIPH_CHECK( ::write( fd, &one, sizeof( one ) ) == sizeof( one ) );
+        PERIPH_CHECK( io.run_once( 10 ) == 0 );
+        PERIPH_CHECK( io.wakeups() == 1 );
+
+        // Every completed coroutine is resumed in one pass.
+        ready = true;
+        PERIPH_CHECK( io.run_once( 1000 ) == 2 );
+        PERIPH_CHECK( io.pending() == 0 );
+        PERIPH_CHECK( done == 3 );
+
+        // Operations without an interrupt are polled until the timeout, without sleeping.
+        ready = false;
+        await_flag( io, ready, false, done );
+        PERIPH_CHECK( io.run_once( 10 ) == 0 );
+        PERIPH_CHECK( io.wakeups() == 1 );
+        ready = true;
+        io.run();
+        PERIPH_CHECK( done == 4 );
+
+        ::close( fd );
+    }
+
+    void test_vcd() {
+        std::ostringstream out;
+        sim::vcd_writer    vcd( out, "10ns", "top" );
+
+        const std::size_t clk = vcd.add( "clk" );
+        const std::size_t bus = vcd.add( "bus", 4 );
+        PERIPH_CHECK( ( clk == 0 ) && ( bus == 1 ) );
+
+        // The first change writes the header, with every signal unknown until it changes.
+        vcd.change( 5, clk, 1 );
+        vcd.change( 5, bus, 0x1A );
+        vcd.change( 6, clk, 1 );
+        vcd.change( 7, clk, 0 );
+
+        // Signals declared too late are refused rather than aliasing a declared one.
+        const std::size_t late = vcd.add( "late" );
+        PERIPH_CHECK( late == sim::vcd_writer::npos );
+        vcd.change( 8, late, 1 );
+
+        const std::string expected =
+            "$timescale 10ns $end\n"
+            "$scope module top $end\n"
+            "$var wire 1 ! clk $end\n"
+            "$var wire 4 \" bus $end\n"
+            "$upscope $end\n$enddefinitions $end\n"
+            "#5\n$dumpvars\nx!\nbx \"\n$end\n"
+            "1!\n"
+            "b1010 \"\n"
+            "#7\n"
+            "0!\n";
+        PERIPH_CHECK( out.str() == expected );
+    }
+
+    void test_registry_id() {
+        sim::pwm_model    pwm_model;
+        sim::pw_bit_model pw_bit_model;
+
+        // The identification words of the register models decode to their build parameters.
+        const std::uint32_t pwm_word = read_id( &pwm_model.device() );
+        const std::uint32_t pwb_word = read_id( &pw_bit_model.output( 2 ) );
+
+        const device_info pwm_info = decode_id( pwm_word );
+        PERIPH_CHECK( pwm_info.type == device_type::pwm );
+        PERIPH_CHECK( pwm_info.version == device_traits<pwm>::version );
+        PERIPH_CHECK( pwm_info.fifo_depth == sequencer_depth );
+        PERIPH_CHECK( pwm_info.num_outputs == num_outputs );
+        PERIPH_CHECK( encode_id( pwm_info ) == pwm_word );
+
+        const device_info pwb_info = decode_id( pwb_word );
+        PERIPH_CHECK( pwb_info.type == device_type::pw_bit );
+        PERIPH_CHECK( pwb_info.version == device_traits<pw_bit>::version );
+        PERIPH_CHECK( pwb_info.fifo_depth == fifo_depth );
+        PERIPH_CHECK( pwb_info.index == 2 );
+        PERIPH_CHECK( pwb_info.num_outputs == sim::pw_bit_model::num_outputs );
+        PERIPH_CHECK( encode_id( pwb_info ) == pwb_word );
+
+        // Every field survives a round trip, and words of no known core decode as unknown.
+        const device_info info = { device_type::pw_bit, 15, 256, 7, 200, 0 };
+        const device_info back = decode_id( encode_id( info ) );
+        PERIPH_CHECK( back.type == info.type );
+        PERIPH_CHECK( back.version == info.version );
+        PERIPH_CHECK( back.fifo_depth == info.fifo_depth );
+        PERIPH_CHECK( back.index == info.index );
+        PERIPH_CHECK( back.num_outputs == info.num_outputs );
+        PERIPH_CHECK( decode_id( 0 ).type == device_type::unknown );
+        PERIPH_CHECK( decode_id( 0x13000004 ).type == device_type::unknown );
+    }
+
+    void test_registry() {
+        constexpr std::size_t stride = 0x10000;
+        constexpr std::size_t size   = 4 * stride;
+
+        sim::pwm_model    pwm_model;
+        sim::pw_bit_model pw_bit_model;
+
+        // A PWM core, a pulse-width-bit core, a hole and a PWM core of an older register map.
+        const int fd = ::memfd_create( "periph_registry", MFD_CLOEXEC );
+        PERIPH_CHECK( ( fd >= 0 ) && ( ::ftruncate( fd, size ) == 0 ) );
+        place( fd, 0, &pwm_model.device(), sizeof( pwm ) );
+        place( fd, stride, &pw_bit_model.output( 0 ), sim::pw_bit_model::num_outputs * block_size );
+        place( fd, 3 * stride, &pwm_model.device(), sizeof( pwm ) );
+
+        const std::uint32_t old_id = encode_id( {
+            device_type::pwm, device_traits<pwm>::version - 1, sequencer_depth, 0, num_outputs, 0
+        } );
+        PERIPH_CHECK( ::pwrite( fd, &old_id, sizeof( old_id ), off_t( 3 * stride + id_offset ) )
+                      == ssize_t( sizeof( old_id ) ) );
+
+        const std::string path = "/proc/self/fd/" + std::to_string( fd );
+        {
+            const device_registry registry( path.c_str(), 0, size, stride );
+            PERIPH_CHECK( registry.valid() );
+            PERIPH_CHECK( registry.devices().size() == 3 );
+            PERIPH_CHECK( registry.count( device_type::pwm ) == 2 );
+            PERIPH_CHECK( registry.count( device_type::pw_bit ) == 1 );
+
+            const device_info* leds = registry.find( device_type::pw_bit, 0 );
+            PERIPH_CHECK( ( leds != nullptr ) && ( leds->offset == stride ) );
+            PERIPH_CHECK( ( leds != nullptr ) && ( leds->num_outputs == 4 ) );
+            PERIPH_CHECK( registry.find( device_type::pw_bit, 1 ) == nullptr );
+
+            // Whole-core handles only have output zero, and the older core is refused.
+            PERIPH_CHECK( registry.get<pwm>( 0 ) != nullptr );
+            PERIPH_CHECK( registry.get<pwm>( 0, 1 ) == nullptr );
+            PERIPH_CHECK( registry.find( device_type::pwm, 1 ) != nullptr );
+            PERIPH_CHECK( registry.get<pwm>( 1 ) == nullptr );
+            PERIPH_CHECK( registry.get<pwm>( 2 ) == nullptr );
+
+            // A layout for another number of outputs does not fit the core.
+            PERIPH_CHECK( ( registry.get<basic_pwm<16>>( 0 ) == nullptr ) );
+
+            // Per-output handles are a block apart, up to the number of outputs of the core.
+            const auto first = reinterpret_cast<std::uintptr_t>( registry.get<pw_bit>( 0, 0 ) );
+            const auto last  = reinterpret_cast<std::uintptr_t>( registry.get<pw_bit>( 0, 3 ) );
+            PERIPH_CHECK( ( first != 0 ) && ( last == first + 3 * block_size ) );
+            PERIPH_CHECK( registry.get<pw_bit>( 0, 4 ) == nullptr );
+        }
+
+        // Listed offsets are probed in address order, once each, and those beyond the aperture
+        // skipped. Outputs past the end of the aperture are refused.
+        {
+            const std::array<std::size_t,4> offsets   = { stride, 0, stride, 8 * stride };
+            const std::size_t               truncated = stride + 2 * block_size;
+            const device_registry           registry( path.c_str(), 0, truncated, offsets );
+            PERIPH_CHECK( registry.valid() );
+            PERIPH_CHECK( ( registry.devices().size() == 2 )
+                          && ( registry.devices()[0].offset == 0 )
+                          && ( registry.devices()[1].offset == stride ) );
+            PERIPH_CHECK( registry.get<pw_bit>( 0, 1 ) != nullptr );
+            PERIPH_CHECK( registry.get<pw_bit>( 0, 2 ) == nullptr );
+        }
+
+        ::close( fd );
+    }
+}
+
+int main() {
+    test::run( "dma_ring", test_dma_ring );
+    test::run( "reactor", test_reactor );
+    test::run( "vcd", test_vcd );
+    test::run( "registry_id", test_registry_id );
+    test::run( "registry", test_registry );
+
+    return test::result();
+}
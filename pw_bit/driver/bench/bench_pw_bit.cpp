@@ -0,0 +1,342 @@
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "periph_backend.hpp"
+#include "periph_pw_bit.hpp"
+#include "periph_pw_bit_cache.hpp"
+#include "periph_pw_bit_config.hpp"
+#include "periph_pw_bit_encode.hpp"
+#include "periph_pw_bit_queue.hpp"
+#include "periph_pw_bit_shm.hpp"
+
+namespace {
+
+    constexpr std::size_t   data_offset   = 0x00;       //!< Offset of the data/level register.
+    constexpr std::size_t   cfg_offset    = 0x1C;       //!< Offset of the cfg register.
+    constexpr std::uint32_t cfg_empty_bit = 0x00000002; //!< FIFO empty bit of the cfg register.
+
+    /**
+     * A pulse-width-bit peripheral backed by a page of shared RAM instead of device registers.
+     * 
+     * The FIFO empty bit is set. The data register doubles as the fill level register, and keeps
+     * the last word written, so bulk writes see a whole FIFO of free space only after drain().
+     */
+    struct ram_pw_bit {
+        periph::device_map window{ "/dev/zero", 0, 4096 };  //!< The RAM-backed register window.
+        periph::pw_bit&    dev = window.at<periph::pw_bit>(); //!< The peripheral in the window.
+
+        ram_pw_bit() {
+            if ( window.valid() ) {
+                window.at<volatile std::uint32_t>( cfg_offset ) = cfg_empty_bit;
+            }
+        }
+
+        /**
+         * Check that the register window was mapped, and fail the benchmark if not.
+         * 
+         * \param[in,out] state The benchmark state to report a failure to.
+         * 
+         * \retval true  The register window is mapped.
+         * \retval false Mapping the register window failed.
+         */
+        bool mapped( benchmark::State& state ) const {
+            if ( !window.valid() ) {
+                state.SkipWithError( "Mapping the RAM-backed register window failed" );
+            }
+
+            return window.valid();
+        }
+
+        /**
+         * Empty the FIFO, as the peripheral would between bursts.
+         */
+        void drain() {
+            window.at<volatile std::uint32_t>( data_offset ) = 0;
+        }
+    };
+
+    void bm_pw_bit_write( benchmark::State& state ) {
+        ram_pw_bit    ram;
+        std::uint32_t data = 0;
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            ram.dev.write( data++ );
+        }
+    }
+    BENCHMARK( bm_pw_bit_write );
+
+    void bm_pw_bit_write_bytes( benchmark::State& state ) {
+        ram_pw_bit             ram;
+        std::vector<std::byte> data( state.range( 0 ) );
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            ram.drain();
+            benchmark::DoNotOptimize( ram.dev.write( data ) );
+        }
+        state.SetBytesProcessed( state.iterations() * data.size() );
+    }
+    BENCHMARK( bm_pw_bit_write_bytes )->RangeMultiplier( 4 )->Range( 4, 4096 );
+
+    /**
+     * Report the cost of each FIFO word and the number of barriers in each frame.
+     * 
+     * \param[in,out] state            The benchmark state to report to.
+     * \param         words_per_frame  The number of FIFO words written per frame.
+     * \param         fences_per_frame The number of barriers issued per frame.
+     */
+    void report_frames(
+        benchmark::State& state,
+        std::size_t       words_per_frame,
+        std::size_t       fences_per_frame
+    ) {
+        state.counters["fences_per_frame"] = fences_per_frame;
+        state.counters["time_per_word"]    = benchmark::Counter(
+            words_per_frame,
+            benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert
+        );
+    }
+
+    /**
+     * Write a frame word by word with a barrier after each word, as a seq_cst FIFO store did.
+     */
+    void bm_pw_bit_write_frame_fenced( benchmark::State& state ) {
+        ram_pw_bit        ram;
+        const std::size_t num_words = state.range( 0 );
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            for ( std::size_t i = 0; i < num_words; i++ ) {
+                ram.dev.write( static_cast<std::uint32_t>( i ) );
+                ram.dev.flush();
+            }
+        }
+        report_frames( state, num_words, num_words );
+    }
+    BENCHMARK( bm_pw_bit_write_frame_fenced )->Arg( 225 )->Arg( 7500 );
+
+    /**
+     * Write a frame word by word with a single barrier at the frame boundary.
+     */
+    void bm_pw_bit_write_frame( benchmark::State& state ) {
+        ram_pw_bit        ram;
+        const std::size_t num_words = state.range( 0 );
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            for ( std::size_t i = 0; i < num_words; i++ ) {
+                ram.dev.write( static_cast<std::uint32_t>( i ) );
+            }
+            ram.dev.flush();
+        }
+        report_frames( state, num_words, 1 );
+    }
+    BENCHMARK( bm_pw_bit_write_frame )->Arg( 225 )->Arg( 7500 );
+
+    void bm_pw_bit_set_active_bytes( benchmark::State& state ) {
+        ram_pw_bit ram;
+        int        num_bytes = 0;
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            ram.dev.set_active_bytes( num_bytes );
+            num_bytes = ( num_bytes + 1 ) % 5;
+        }
+    }
+    BENCHMARK( bm_pw_bit_set_active_bytes );
+
+    /**
+     * Encode and push a whole LED frame of 24-bit pixels, however many bursts it takes.
+     */
+    void bm_pw_bit_led_frame( benchmark::State& state ) {
+        ram_pw_bit                 ram;
+        std::vector<std::uint32_t> pixels( state.range( 0 ) );
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( std::size_t i = 0; i < pixels.size(); i++ ) {
+            pixels[i] = 0x00010203 * i;
+        }
+
+        for ( auto _ : state ) {
+            std::span<const std::uint32_t> rest( pixels );
+            while ( !rest.empty() ) {
+                ram.drain();
+                rest = rest.subspan( ram.dev.write_pixels( rest, 3 ) );
+            }
+        }
+        state.SetBytesProcessed( state.iterations() * pixels.size() * 3 );
+    }
+    BENCHMARK( bm_pw_bit_led_frame )->Arg( 60 )->Arg( 300 )->Arg( 1024 );
+
+    /**
+     * Encode an 8-bit RGB frame for a GRB chain, with gamma correction at reduced brightness.
+     */
+    void bm_pw_bit_encode_frame( benchmark::State& state ) {
+        periph::frame_encoder     encoder( periph::color_order::grb, periph::gamma_2_8 );
+        std::vector<std::uint8_t> rgb( state.range( 0 ) * encoder.bytes_per_pixel );
+        std::vector<std::byte>    out( rgb.size() );
+
+        for ( std::size_t i = 0; i < rgb.size(); i++ ) {
+            rgb[i] = static_cast<std::uint8_t>( i * 7 );
+        }
+        encoder.set_brightness( 128 );
+
+        for ( auto _ : state ) {
+            benchmark::DoNotOptimize( encoder.encode( rgb, out ) );
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( bm_pw_bit_encode_frame )->Arg( 10000 );
+
+    /**
+     * Encode a floating-point RGB frame for a GRB chain, with gamma correction.
+     */
+    void bm_pw_bit_encode_frame_float( benchmark::State& state ) {
+        periph::frame_encoder  encoder( periph::color_order::grb, periph::gamma_2_8 );
+        std::vector<float>     rgb( state.range( 0 ) * encoder.bytes_per_pixel );
+        std::vector<std::byte> out( rgb.size() );
+
+        for ( std::size_t i = 0; i < rgb.size(); i++ ) {
+            rgb[i] = static_cast<float>( i % 256 ) / 255.0f;
+        }
+
+        for ( auto _ : state ) {
+            benchmark::DoNotOptimize( encoder.encode( rgb, out ) );
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( bm_pw_bit_encode_frame_float )->Arg( 10000 );
+
+    /**
+     * Encode an 8-bit RGB frame for a GRB chain without gamma correction, reordering only.
+     */
+    void bm_pw_bit_encode_frame_reorder( benchmark::State& state ) {
+        periph::frame_encoder     encoder( periph::color_order::grb, periph::gamma_linear );
+        std::vector<std::uint8_t> rgb( state.range( 0 ) * encoder.bytes_per_pixel );
+        std::vector<std::byte>    out( rgb.size() );
+
+        for ( auto _ : state ) {
+            benchmark::DoNotOptimize( encoder.encode( rgb, out ) );
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( bm_pw_bit_encode_frame_reorder )->Arg( 10000 );
+
+    /**
+     * Diff a 10k-pixel frame against the cache when only one pixel, near the front, changes.
+     */
+    void bm_pw_bit_cache_update( benchmark::State& state ) {
+        periph::frame_cache    cache;
+        std::vector<std::byte> frame( state.range( 0 ) * 3 );
+
+        cache.update( frame );
+
+        for ( auto _ : state ) {
+            frame[30] = static_cast<std::byte>( static_cast<unsigned>( frame[30] ) + 1 );
+            benchmark::DoNotOptimize( cache.update( frame ) );
+        }
+        state.SetItemsProcessed( state.iterations() * state.range( 0 ) );
+    }
+    BENCHMARK( bm_pw_bit_cache_update )->Arg( 10000 );
+
+    /**
+     * One queue shared by all threads of a run, always full, so every push also drops a frame.
+     */
+    periph::frame_queue shared_queue( 64, periph::queue_policy::drop_oldest );
+
+    /**
+     * Benchmark contended pushes to a full queue from several producer threads.
+     */
+    void bm_pw_bit_queue_push( benchmark::State& state ) {
+        std::vector<std::byte>   frame( 900 );
+        const periph::frame_desc desc{ frame, nullptr, nullptr };
+
+        for ( auto _ : state ) {
+            benchmark::DoNotOptimize( shared_queue.push( desc ) );
+        }
+        state.SetItemsProcessed( state.iterations() );
+    }
+    BENCHMARK( bm_pw_bit_queue_push )->Threads( 1 )->Threads( 4 )->UseRealTime();
+
+    /**
+     * Switch a bank of outputs between two LED chip types, writing only the changed registers.
+     */
+    void bm_pw_bit_config_switch( benchmark::State& state ) {
+        ram_pw_bit                   ram;
+        std::vector<periph::pw_bit*> channels( state.range( 0 ) );
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( std::size_t i = 0; i < channels.size(); i++ ) {
+            channels[i] = &ram.window.at<periph::pw_bit>( i * periph::block_size );
+        }
+
+        constexpr auto ws2812b = periph::pw_bit_config::preset(
+            periph::pw_bit_protocol::ws2812b,
+            100'000'000
+        );
+        constexpr auto sk6812 = periph::pw_bit_config::preset(
+            periph::pw_bit_protocol::sk6812,
+            100'000'000
+        );
+
+        ws2812b.apply( channels );
+
+        std::size_t writes = 0;
+        for ( auto _ : state ) {
+            writes += sk6812.apply( channels, ws2812b );
+            writes += ws2812b.apply( channels, sk6812 );
+        }
+        state.counters["writes_per_channel"] = benchmark::Counter(
+            double( writes ) / double( channels.size() ),
+            benchmark::Counter::kAvgIterations
+        );
+        state.SetItemsProcessed( state.iterations() * 2 * channels.size() );
+    }
+    BENCHMARK( bm_pw_bit_config_switch )->Arg( 16 );
+
+    /**
+     * Hand a rendered frame from the producer to the feeder through a shared frame buffer.
+     */
+    void bm_pw_bit_shm_handoff( benchmark::State& state ) {
+        periph::shared_frame_buffer frames( state.range( 0 ) * 3 );
+
+        for ( auto _ : state ) {
+            frames.back()[0] = std::byte{ 1 };
+            frames.publish( frames.capacity() );
+            benchmark::DoNotOptimize( frames.acquire() );
+        }
+        state.SetItemsProcessed( state.iterations() );
+    }
+    BENCHMARK( bm_pw_bit_shm_handoff )->Arg( 10000 );
+
+}
@@ -0,0 +1,443 @@
+#include <algorithm>
+
+#include "periph_trace.hpp"
+#ifdef PERIPH_SIM
+#include "periph_sim.hpp"
+#endif
+
+namespace periph {
+
+    namespace detail {
+
+        namespace pw_bit_impl {
+
+            constexpr std::uint32_t cfg_rst_bit          = 0x00000001; //!< Enable bit of the cfg.
+            constexpr std::uint32_t cfg_empty_bit        = 0x00000002; //!< FIFO empty bit.
+            constexpr std::uint32_t cfg_full_bit         = 0x00000004; //!< FIFO full bit.
+            constexpr std::uint32_t cfg_almost_empty_bit = 0x00000008; //!< FIFO almost empty bit.
+            constexpr std::uint32_t cfg_almost_full_bit  = 0x00000010; //!< FIFO almost full bit.
+            constexpr std::uint32_t cfg_refill_irq_bit   = 0x00000020; //!< Refill interrupt bit.
+            constexpr std::uint32_t cfg_clear_bit        = 0x00000040; //!< Counter clear bit.
+            constexpr std::size_t   cfg_overflows_shift  = 16;         //!< Overflow count LSB.
+            constexpr std::size_t   cfg_underruns_shift  = 24;         //!< Underrun count LSB.
+            constexpr std::uint32_t eof_marker           = 0x00000001; //!< End-of-frame word.
+
+            /**
+             * Register-wise access struct for pulse-width-bit peripheral memory-mapped registers.
+             * 
+             * \tparam Word The type of a register.
+             */
+            template<typename Word>
+            struct memory_map {
+                volatile       Word fifo_write; //!< Data FIFO write register, reads fill level.
+                volatile       Word byte_mask;  //!< Byte mask register.
+                volatile       Word reset_gap;  //!< Reset gap length register.
+                volatile const Word id;         //!< Identification register.
+                volatile       Word period;     //!< Bit period register.
+                volatile       Word duty_1b;    //!< 1-bit duty time register.
+                volatile       Word duty_0b;    //!< 0-bit duty time register.
+                volatile       Word cfg;        //!< Configuration and status register.
+
+                /**
+                 * Copy configurations from another pulse-width-bit memory block.
+                 * 
+                 * \param[in] rhs The peripheral memory block to copy from.
+                 * 
+                 * \return Returns self-reference.
+                 */
+                memory_map& operator=( const memory_map& rhs ) {
+                    this->byte_mask = rhs.byte_mask;
+                    this->reset_gap = rhs.reset_gap;
+                    this->period = rhs.period;
+                    this->duty_1b = rhs.duty_1b;
+                    this->duty_0b = rhs.duty_0b;
+                    this->cfg = rhs.cfg & ( cfg_rst_bit | cfg_refill_irq_bit );
+
+                    return *this;
+                }
+            };
+
+            static_assert(
+                offsetof( memory_map<std::uint32_t>, id ) == id_offset,
+                "Identification register offset mismatch"
+            );
+
+            /**
+             * Cast a user pulse-width-bit class to a register memory map.
+             * 
+             * \param[in] dev The opaque user class to cast.
+             * 
+             * \return Returns the memory-mapped registers corresponding to the opaque user class.
+             */
+            template<std::size_t W>
+            memory_map<register_word<W>>& to_map( basic_pw_bit<W>& dev ) {
+                static_assert(
+                    sizeof( basic_pw_bit<W> ) == sizeof( memory_map<register_word<W>> ),
+                    "User handle and register memory map size mismatch"
+                );
+#ifdef PERIPH_SIM
+                sim::on_access( &dev );
+#endif
+                return *reinterpret_cast<memory_map<register_word<W>>*>( &dev );
+            }
+
+            /**
+             * Cast a read-only user pulse-width-bit class to a register memory map.
+             * 
+             * \param[in] dev The read-only opaque user class to cast.
+             * 
+             * \return Returns the read-only memory-mapped registers corresponding to the opaque
+             *         user class.
+             */
+            template<std::size_t W>
+            const memory_map<register_word<W>>& to_map( const basic_pw_bit<W>& dev ) {
+#ifdef PERIPH_SIM
+                sim::on_access( &dev );
+#endif
+                return *reinterpret_cast<const memory_map<register_word<W>>*>( &dev );
+            }
+
+            /**
+             * Push a word into the output data FIFO.
+             * 
+             * This is a plain volatile store without any barrier, so bursts of words cost one bus
+             * write each. Callers needing the words to have reached the peripheral use
+             * detail::io_barrier().
+             * 
+             * \param[in,out] map  The registers of the peripheral to write to.
+             * \param         word The word to push.
+             */
+            template<typename Word>
+            void fifo_push( memory_map<Word>& map, Word word ) {
+                map.fifo_write = word;
+                trace::on_mmio_write();
+#ifdef PERIPH_SIM
+                sim::on_fifo_write( &map.fifo_write, static_cast<std::uint32_t>( word ) );
+#endif
+            }
+
+            /**
+             * Determine how many words can be written to the output data FIFO without
+             * overflowing it.
+             * 
+             * \param level The value read from the fill level register.
+             * 
+             * \return Returns the free space in the output data FIFO, in words.
+             */
+            inline std::size_t free_space( std::uint64_t level ) {
+                return ( level < fifo_depth ) ? fifo_depth - level : 0;
+            }
+
+            /**
+             * Extract an error counter from the configuration register.
+             * 
+             * \param cfg   The value read from the configuration register.
+             * \param shift The position of the counter in the register.
+             * 
+             * \return Returns the value of the counter.
+             */
+            inline std::size_t error_count( std::uint64_t cfg, std::size_t shift ) {
+                return ( cfg >> shift ) & error_count_max;
+            }
+
+            /**
+             * Push a byte stream into the output data FIFO.
+             * 
+             * All full words are written with every byte active. A trailing partial word is
+             * written with only its valid bytes active. The byte mask register is restored
+             * afterwards.
+             * 
+             * \param[in,out] map       The registers of the peripheral to write to.
+             * \param         num_bytes The number of bytes in the stream.
+             * \param         next_byte Callable returning the next byte of the stream on each call.
+             */
+            template<typename Word, typename F>
+            void push_stream( memory_map<Word>& map, std::size_t num_bytes, F&& next_byte ) {
+                constexpr std::size_t word_bytes     = sizeof( Word );
+                constexpr Word        word_byte_mask = ( Word{ 1 } << word_bytes ) - 1;
+
+                const Word        active_mask = map.byte_mask;
+                const std::size_t full_words  = num_bytes / word_bytes;
+                const std::size_t tail_bytes  = num_bytes % word_bytes;
+
+                if ( full_words > 0 ) {
+                    map.byte_mask = word_byte_mask;
+                    trace::on_mmio_write();
+                }
+                for ( std::size_t i = 0; i < full_words; i++ ) {
+                    Word word = 0;
+                    for ( std::size_t j = 0; j < word_bytes; j++ ) {
+                        word |= Word{ next_byte() } << ( 8 * j );
+                    }
+                    fifo_push( map, word );
+                }
+
+                if ( tail_bytes > 0 ) {
+                    Word word = 0;
+                    for ( std::size_t j = 0; j < tail_bytes; j++ ) {
+                        word |= Word{ next_byte() } << ( 8 * j );
+                    }
+                    map.byte_mask = ( Word{ 1 } << tail_bytes ) - 1;
+                    trace::on_mmio_write();
+                    fifo_push( map, word );
+                }
+
+                map.byte_mask = active_mask;
+                trace::on_mmio_write();
+            }
+
+        }
+
+    }
+
+    template<std::size_t DataWidth>
+    basic_pw_bit<DataWidth>& basic_pw_bit<DataWidth>::operator=( const basic_pw_bit& rhs ) {
+        using namespace detail::pw_bit_impl;
+
+        to_map( *this ) = to_map( rhs );
+
+        return *this;
+    }
+
+    template<std::size_t DataWidth>
+    basic_pw_bit<DataWidth>& basic_pw_bit<DataWidth>::operator=( basic_pw_bit&& rhs ) {
+        using namespace detail::pw_bit_impl;
+
+        auto& other_map = to_map( rhs );
+
+        to_map( *this ) = other_map;
+
+        other_map.byte_mask = 0;
+        other_map.reset_gap = 0;
+        other_map.period = 0;
+        other_map.duty_1b = 0;
+        other_map.duty_0b = 0;
+        other_map.cfg = 0;
+
+        return *this;
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::enable() {
+        using namespace detail::pw_bit_impl;
+
+        auto& cfg = to_map( *this ).cfg;
+
+        cfg = ( cfg & cfg_refill_irq_bit ) | cfg_rst_bit;
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::disable() {
+        using namespace detail::pw_bit_impl;
+
+        auto& cfg = to_map( *this ).cfg;
+
+        cfg = cfg & cfg_refill_irq_bit;
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::write( word data ) {
+        using namespace detail::pw_bit_impl;
+
+        fifo_push( to_map( *this ), data );
+    }
+
+    template<std::size_t DataWidth>
+    std::size_t basic_pw_bit<DataWidth>::write( std::span<const std::byte> data ) {
+        using namespace detail::pw_bit_impl;
+
+        auto& map = to_map( *this );
+
+        const std::size_t num_bytes =
+            std::min( data.size(), word_bytes * free_space( map.fifo_write ) );
+        if ( num_bytes == 0 ) {
+            if ( !data.empty() ) {
+                trace::on_full_stall( this );
+            }
+            return 0;
+        }
+
+        auto next = data.begin();
+        push_stream(
+            map,
+            num_bytes,
+            [&next]() { return std::to_integer<std::uint8_t>( *next++ ); }
+        );
+
+        return num_bytes;
+    }
+
+    template<std::size_t DataWidth>
+    std::size_t basic_pw_bit<DataWidth>::write_pixels(
+        std::span<const word> pixels,
+        int                   bytes_per_pixel
+    ) {
+        using namespace detail::pw_bit_impl;
+
+        if ( ( bytes_per_pixel < 1 ) || ( bytes_per_pixel > static_cast<int>( word_bytes ) ) ) {
+            return 0;
+        }
+
+        auto& map = to_map( *this );
+
+        const std::size_t pixel_bytes = bytes_per_pixel;
+        const std::size_t num_pixels  = std::min(
+            pixels.size(),
+            word_bytes * free_space( map.fifo_write ) / pixel_bytes
+        );
+        if ( num_pixels == 0 ) {
+            if ( !pixels.empty() ) {
+                trace::on_full_stall( this );
+            }
+            return 0;
+        }
+
+        auto        next  = pixels.begin();
+        std::size_t shift = 0;
+        push_stream(
+            map,
+            num_pixels * pixel_bytes,
+            [&next, &shift, pixel_bytes]() {
+                const auto byte = static_cast<std::uint8_t>( *next >> ( 8 * shift ) );
+                if ( ++shift == pixel_bytes ) {
+                    shift = 0;
+                    ++next;
+                }
+                return byte;
+            }
+        );
+
+        return num_pixels;
+    }
+
+    template<std::size_t DataWidth>
+    bool basic_pw_bit<DataWidth>::end_frame() {
+        using namespace detail::pw_bit_impl;
+
+        auto& map = to_map( *this );
+
+        if ( map.cfg & cfg_full_bit ) {
+            trace::on_full_stall( this );
+            return false;
+        }
+
+        // The marker is a word with no active bytes and its lowest bit set.
+        const word active_mask = map.byte_mask;
+        map.byte_mask = 0;
+        fifo_push( map, word{ eof_marker } );
+        map.byte_mask = active_mask;
+        trace::on_mmio_write( 2 );
+
+        return true;
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::flush() {
+        detail::io_barrier();
+        trace::on_fence();
+    }
+
+    template<std::size_t DataWidth>
+    bool basic_pw_bit<DataWidth>::fifo_empty() const {
+        using namespace detail::pw_bit_impl;
+
+        return to_map( *this ).cfg & cfg_empty_bit;
+    }
+
+    template<std::size_t DataWidth>
+    bool basic_pw_bit<DataWidth>::fifo_full() const {
+        using namespace detail::pw_bit_impl;
+
+        return to_map( *this ).cfg & cfg_full_bit;
+    }
+
+    template<std::size_t DataWidth>
+    bool basic_pw_bit<DataWidth>::fifo_almost_empty() const {
+        using namespace detail::pw_bit_impl;
+
+        return to_map( *this ).cfg & cfg_almost_empty_bit;
+    }
+
+    template<std::size_t DataWidth>
+    bool basic_pw_bit<DataWidth>::fifo_almost_full() const {
+        using namespace detail::pw_bit_impl;
+
+        return to_map( *this ).cfg & cfg_almost_full_bit;
+    }
+
+    template<std::size_t DataWidth>
+    std::size_t basic_pw_bit<DataWidth>::fifo_level() const {
+        return detail::pw_bit_impl::to_map( *this ).fifo_write;
+    }
+
+    template<std::size_t DataWidth>
+    std::size_t basic_pw_bit<DataWidth>::fifo_space() const {
+        using namespace detail::pw_bit_impl;
+
+        return free_space( to_map( *this ).fifo_write );
+    }
+
+    template<std::size_t DataWidth>
+    std::size_t basic_pw_bit<DataWidth>::overflows() const requires ( DataWidth >= 32 ) {
+        using namespace detail::pw_bit_impl;
+
+        return error_count( to_map( *this ).cfg, cfg_overflows_shift );
+    }
+
+    template<std::size_t DataWidth>
+    std::size_t basic_pw_bit<DataWidth>::underruns() const requires ( DataWidth >= 32 ) {
+        using namespace detail::pw_bit_impl;
+
+        return error_count( to_map( *this ).cfg, cfg_underruns_shift );
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::clear_counters() requires ( DataWidth >= 32 ) {
+        using namespace detail::pw_bit_impl;
+
+        auto& cfg = to_map( *this ).cfg;
+
+        cfg = ( cfg & ( cfg_rst_bit | cfg_refill_irq_bit ) ) | cfg_clear_bit;
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::set_refill_irq( bool enabled ) {
+        using namespace detail::pw_bit_impl;
+
+        auto& cfg = to_map( *this ).cfg;
+
+        cfg = ( cfg & cfg_rst_bit ) | ( enabled ? cfg_refill_irq_bit : 0 );
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::set_active_bytes( int num_bytes ) {
+        using namespace detail::pw_bit_impl;
+
+        if ( ( num_bytes < 1 ) || ( num_bytes > static_cast<int>( word_bytes ) ) ) {
+            return;
+        }
+
+        to_map( *this ).byte_mask = ( word{ 1 } << num_bytes ) - 1;
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::set_reset_gap( word cycles ) {
+        detail::pw_bit_impl::to_map( *this ).reset_gap = cycles;
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::set_period( word period ) {
+        detail::pw_bit_impl::to_map( *this ).period = period;
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::set_1b_duty( word duty ) {
+        detail::pw_bit_impl::to_map( *this ).duty_1b = duty;
+    }
+
+    template<std::size_t DataWidth>
+    void basic_pw_bit<DataWidth>::set_0b_duty( word duty ) {
+        detail::pw_bit_impl::to_map( *this ).duty_0b = duty;
+    }
+
+}
@@ -0,0 +1,111 @@
+namespace periph {
+
+    namespace detail {
+
+        namespace pw_bit_impl {
+
+            /**
+             * Write a configuration to a set of outputs, in three passes.
+             * 
+             * The first pass disables the outputs if their bit timing changes, the second writes
+             * all changed registers, and the third writes the configuration register if it changed
+             * or the outputs were disabled. Register writes are posted, so the outputs restart
+             * within a few bus cycles of each other.
+             * 
+             * \param channels The outputs to configure.
+             * \param config   The configuration to write.
+             * \param previous The configuration of the outputs, or null to write every register.
+             * 
+             * \return Returns the number of registers written.
+             */
+            template<std::size_t W>
+            std::size_t configure(
+                std::span<basic_pw_bit<W>* const> channels,
+                const basic_pw_bit_config<W>&     config,
+                const basic_pw_bit_config<W>*     previous
+            ) {
+                using word = register_word<W>;
+
+                const word byte_mask = ( word{ 1 } << config.active_bytes ) - 1;
+                const word cfg       = ( config.enabled ? cfg_rst_bit : 0 ) |
+                                       ( config.refill_irq ? cfg_refill_irq_bit : 0 );
+
+                const bool all     = previous == nullptr;
+                const bool mask    = all || ( config.active_bytes != previous->active_bytes );
+                const bool gap     = all || ( config.reset_gap != previous->reset_gap );
+                const bool period  = all || ( config.period != previous->period );
+                const bool duty_1b = all || ( config.duty_1b != previous->duty_1b );
+                const bool duty_0b = all || ( config.duty_0b != previous->duty_0b );
+                const bool restart = period || duty_1b || duty_0b;
+                const bool halt    = restart && ( all || previous->enabled );
+                const bool state   = restart || ( config.enabled != previous->enabled ) ||
+                                     ( config.refill_irq != previous->refill_irq );
+
+                // An output halted here that is to stay disabled already holds its final
+                // configuration register.
+                const bool resume = state && !( halt && !config.enabled );
+
+                if ( halt ) {
+                    for ( auto dev : channels ) {
+                        to_map( *dev ).cfg = cfg & cfg_refill_irq_bit;
+                    }
+                }
+
+                for ( auto dev : channels ) {
+                    auto& map = to_map( *dev );
+
+                    if ( mask ) {
+                        map.byte_mask = byte_mask;
+                    }
+                    if ( gap ) {
+                        map.reset_gap = config.reset_gap;
+                    }
+                    if ( period ) {
+                        map.period = config.period;
+                    }
+                    if ( duty_1b ) {
+                        map.duty_1b = config.duty_1b;
+                    }
+                    if ( duty_0b ) {
+                        map.duty_0b = config.duty_0b;
+                    }
+                }
+
+                if ( resume ) {
+                    for ( auto dev : channels ) {
+                        to_map( *dev ).cfg = cfg;
+                    }
+                }
+
+                const std::size_t writes = halt + mask + gap + period + duty_1b + duty_0b + resume;
+
+                return writes * channels.size();
+            }
+
+        }
+
+    }
+
+
+    template<std::size_t DataWidth>
+    std::size_t basic_pw_bit_config<DataWidth>::apply( std::span<device* const> channels ) const {
+        if ( ( active_bytes < 1 ) || ( active_bytes > static_cast<int>( device::word_bytes ) ) ) {
+            return 0;
+        }
+
+        return detail::pw_bit_impl::configure<DataWidth>( channels, *this, nullptr );
+    }
+
+    template<std::size_t DataWidth>
+    std::size_t basic_pw_bit_config<DataWidth>::apply(
+        std::span<device* const>   channels,
+        const basic_pw_bit_config& previous
+    ) const {
+        if ( ( active_bytes < 1 ) || ( active_bytes > static_cast<int>( device::word_bytes ) ) ) {
+            return 0;
+        }
+
+        return detail::pw_bit_impl::configure<DataWidth>( channels, *this, &previous );
+    }
+
+}
@@ -5,20 +5,41 @@
 #include <cstddef>
 
 #include <array>
+#include <span>
+
+#include "periph_register.hpp"
+#include "periph_registry.hpp"
 
 namespace periph {
 
-    constexpr std::size_t block_size = 32;
+    constexpr std::size_t block_regs     = 8;    //!< The registers controlling one output.
+    constexpr std::size_t block_size     = 32;   //!< The size of one output's block, if 32-bit.
+    constexpr std::size_t fifo_depth     = 1024; //!< The number of data words the output FIFO holds.
+    constexpr std::size_t fifo_watermark = 128;  //!< The FIFO almost-empty/almost-full margin.
+
+    constexpr std::size_t error_count_max = 255; //!< The value error counters saturate at.
 
     /**
      * A pulse-width-based bit protocol peripheral.
+     * 
+     * The register layout follows the AXI_DATA_WIDTH generic of axi_pw_bit: each output is a
+     * block of eight registers as wide as the data bus, and each output data FIFO word carries as
+     * many bytes as a register.
+     * 
+     * \tparam DataWidth The AXI data width the peripheral was built with: 16, 32 or 64 bits.
      */
-    class pw_bit {
+    template<std::size_t DataWidth = 32>
+    class basic_pw_bit {
         public:
-            pw_bit() = delete;                //!< Disallow default construction.
-            ~pw_bit() = delete;               //!< Disallow construction.
-            pw_bit( const pw_bit& ) = delete; //!< Disallow copy construction.
-            pw_bit( pw_bit&& ) = delete;      //!< Disallow move construction.
+            using word = register_word<DataWidth>; //!< The type of a register and a FIFO word.
+
+            static constexpr std::size_t word_bytes  = sizeof( word );          //!< Bytes per word.
+            static constexpr std::size_t block_bytes = block_regs * word_bytes; //!< Output stride.
+
+            basic_pw_bit() = delete;                      //!< Disallow default construction.
+            ~basic_pw_bit() = delete;                     //!< Disallow destruction.
+            basic_pw_bit( const basic_pw_bit& ) = delete; //!< Disallow copy construction.
+            basic_pw_bit( basic_pw_bit&& ) = delete;      //!< Disallow move construction.
 
             /**
              * Copy the configuration of the given pulse-width-bit peripheral to this peripheral.
@@ -27,7 +48,7 @@ namespace periph {
              * 
              * \return Returns self-reference.
              */
-            pw_bit& operator=( const pw_bit& rhs );
+            basic_pw_bit& operator=( const basic_pw_bit& rhs );
 
             /**
              * Move the configuration of the given pulse-width-bit peripheral to this peripheral.
@@ -38,7 +59,7 @@ namespace periph {
              * 
              * \return Returns self-reference.
              */
-            pw_bit& operator=( pw_bit&& rhs );
+            basic_pw_bit& operator=( basic_pw_bit&& rhs );
 
             void enable();  //!< Enable this peripheral's output without affecting its settings.
             void disable(); //!< Disable this peripheral's output without affecting its settings.
@@ -47,11 +68,69 @@ namespace periph {
              * Write data out through the peripheral.
              * 
              * The lowest bytes are transmitted through the pulse-width-bit protocol. The number of
-             * low bytes to transmit are set by set_active_bytes( int ).
+             * low bytes to transmit are set by set_active_bytes( int ). Like all writes to the
+             * output data FIFO, this is a single register store without a memory barrier; see
+             * flush().
              * 
              * \param data The data to write.
              */
-            void write( std::uint32_t data );
+            void write( word data );
+
+            /**
+             * Stream a byte buffer out through the peripheral.
+             * 
+             * Bytes are packed word_bytes to a FIFO word and transmitted in buffer order. Only the
+             * final word of the buffer is written with a partial byte mask. The free space in the
+             * output data FIFO is read once, from the fill level register, and as many words as
+             * fit are written in one burst. The byte count set by set_active_bytes( int ) is left
+             * unchanged.
+             * 
+             * \param data The bytes to transmit.
+             * 
+             * \return Returns the number of bytes consumed from the front of \a data. Returns zero
+             *         if the output data FIFO is full.
+             */
+            std::size_t write( std::span<const std::byte> data );
+
+            /**
+             * Stream a buffer of pixels out through the peripheral.
+             * 
+             * The lowest \a bytes_per_pixel bytes of each pixel are transmitted, in the same order
+             * as write( word ) transmits them, but packed back to back into full FIFO words. Only
+             * whole pixels are consumed.
+             * 
+             * \param pixels          The pixels to transmit.
+             * \param bytes_per_pixel The number of low bytes of each pixel to transmit, from 1 to
+             *                        word_bytes.
+             * 
+             * \return Returns the number of pixels consumed from the front of \a pixels. Returns
+             *         zero if the output data FIFO is full or \a bytes_per_pixel is out of range.
+             */
+            std::size_t write_pixels( std::span<const word> pixels, int bytes_per_pixel );
+
+            /**
+             * Mark the end of a frame in the output data FIFO.
+             * 
+             * Once all data written before the marker is transmitted, the output holds its line
+             * low for the reset gap set by set_reset_gap( word ) before transmitting any
+             * data written after it. This latches the frame into WS2812-class devices without
+             * software having to wait for the gap, so the next frame can be queued right away.
+             * The marker takes one FIFO word, with no active bytes and its lowest bit set.
+             * 
+             * \retval true  The marker was queued.
+             * \retval false The output data FIFO is full.
+             */
+            bool end_frame();
+
+            /**
+             * Wait until all data written so far is visible to the peripheral.
+             * 
+             * Writes to the output data FIFO are issued without memory barriers, so that bursts of
+             * words are not slowed down by one barrier each. Writes to the same peripheral still
+             * arrive in program order. A single flush is only needed where other agents must see
+             * the data queued, e.g. at frame boundaries before signalling another thread.
+             */
+            void flush();
 
             /**
              * Check whether or not the output data FIFO is empty.
@@ -69,22 +148,102 @@ namespace periph {
              */
             bool fifo_full() const;
 
+            /**
+             * Check whether or not the output data FIFO holds at most fifo_watermark words.
+             * 
+             * \retval true  The output data FIFO is almost empty.
+             * \retval false The output data FIFO is not almost empty.
+             */
+            bool fifo_almost_empty() const;
+
+            /**
+             * Check whether or not the output data FIFO has at most fifo_watermark words free.
+             * 
+             * \retval true  The output data FIFO is almost full.
+             * \retval false The output data FIFO is not almost full.
+             */
+            bool fifo_almost_full() const;
+
+            /**
+             * Read the number of words in the output data FIFO.
+             * 
+             * \return Returns the fill level of the output data FIFO, from 0 to fifo_depth.
+             */
+            std::size_t fifo_level() const;
+
+            /**
+             * Read the number of words that can be written to the output data FIFO.
+             * 
+             * \return Returns the free space in the output data FIFO, from 0 to fifo_depth.
+             */
+            std::size_t fifo_space() const;
+
+            /**
+             * Read the number of words written while the output data FIFO was full, and dropped.
+             * 
+             * The count saturates at error_count_max, and is only kept by cores built with an AXI
+             * data width of at least 32 bits.
+             * 
+             * \return Returns the number of dropped words since the counters were last cleared.
+             */
+            std::size_t overflows() const requires ( DataWidth >= 32 );
+
+            /**
+             * Read the number of times the output ran out of data in the middle of a frame.
+             * 
+             * Each underrun stretches the line at the bit being transmitted, which corrupts the
+             * rest of the frame on WS2812-class devices. The count saturates at error_count_max,
+             * and is only kept by cores built with an AXI data width of at least 32 bits.
+             * 
+             * \return Returns the number of underruns since the counters were last cleared.
+             */
+            std::size_t underruns() const requires ( DataWidth >= 32 );
+
+            /**
+             * Clear the overflow and underrun counters, without affecting any setting.
+             */
+            void clear_counters() requires ( DataWidth >= 32 );
+
+            /**
+             * Enable or disable the refill interrupt of this peripheral.
+             * 
+             * While enabled, and while the peripheral output is enabled, the peripheral raises its
+             * interrupt line for as long as the output data FIFO is almost empty.
+             * 
+             * \param enabled Whether or not to raise the refill interrupt.
+             */
+            void set_refill_irq( bool enabled );
+
             /**
              * Set the number of bytes that actually get transmitted when data is written.
              * 
              * On each data write, the lowest \a num_bytes bytes of data are transmitted through the
-             * pulse-width-bit protocol.
+             * pulse-width-bit protocol. Words without active bytes are reserved for the end of
+             * frame marker, and the peripheral drops any other such write.
              * 
-             * \param num_bytes The number of bytes to transmit on each write.
+             * \param num_bytes The number of bytes to transmit on each write, from 1 to word_bytes.
+             *                  Other values are ignored.
              */
             void set_active_bytes( int num_bytes );
 
+            /**
+             * Set the length of the reset gap inserted at each end of frame.
+             * 
+             * The gap must be longer than the low time of any bit, and is typically 50 to 300
+             * microseconds for WS2812-class devices. Frames streamed in through the stream port
+             * end on each beat with TLAST set.
+             * 
+             * \param cycles The length of the reset gap, in number of peripheral clock cycles, or
+             *               zero to disable the reset gap.
+             */
+            void set_reset_gap( word cycles );
+
             /**
              * Set the transmission pulse period.
              * 
              * \param period The transmission pulse period, in number of peripheral clock cycles.
              */
-            void set_period( std::uint32_t period );
+            void set_period( word period );
 
             /**
              * Set the transmission pulse-width corresponding to a high bit.
@@ -92,7 +251,7 @@ namespace periph {
              * \param period The transmission pulse-width of a high bit, in number of peripheral
              *               clock cycles.
              */
-            void set_1b_duty( std::uint32_t duty );
+            void set_1b_duty( word duty );
 
             /**
              * Set the transmission pulse-width corresponding to a low bit.
@@ -100,15 +259,41 @@ namespace periph {
              * \param period The transmission pulse-width of a low bit, in number of peripheral
              *               clock cycles.
              */
-            void set_0b_duty( std::uint32_t duty );
+            void set_0b_duty( word duty );
 
         private:
             /**
              * Size-equivalent stand-in for all memory-mapped registers in this peripheral device.
              */
-            std::array<volatile std::byte,block_size> memory;
+            std::array<volatile std::byte,block_bytes> memory;
     };
 
+    /**
+     * Registry properties of the pulse-width-bit driver, one handle driving a single output.
+     */
+    template<std::size_t DataWidth>
+    struct device_traits<basic_pw_bit<DataWidth>> {
+        using device = basic_pw_bit<DataWidth>; //!< The driver class.
+
+        static constexpr device_type   type          = device_type::pw_bit; //!< Driven core type.
+        static constexpr std::uint32_t version       = 2;                   //!< Register map.
+        static constexpr std::size_t   output_stride = device::block_bytes; //!< Handle per output.
+        static constexpr std::size_t   num_outputs   = 0;                   //!< Fits any core.
+        static constexpr std::size_t   data_width    = DataWidth;           //!< Register width.
+    };
+
+    using pw_bit = basic_pw_bit<>; //!< A 32-bit pulse-width-bit peripheral.
+
+    static_assert( pw_bit::block_bytes == block_size, "Output block size mismatch" );
+
+}
+
+#include "periph_pw_bit.ipp"
+
+namespace periph {
+
+    extern template class basic_pw_bit<>;
+
 }
 
 #endif // #ifndef PERIPH_PW_BIT_HPP
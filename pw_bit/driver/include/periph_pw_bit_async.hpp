@@ -0,0 +1,109 @@
+#ifndef PERIPH_PW_BIT_ASYNC_HPP
+#define PERIPH_PW_BIT_ASYNC_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+
+#include "periph_pw_bit.hpp"
+#include "periph_reactor.hpp"
+
+namespace periph {
+
+    /**
+     * An awaitable transmission of a frame through a pulse-width-bit peripheral.
+     * 
+     * Completes once the whole frame and an end of frame marker are queued in the output data
+     * FIFO. The frame buffer is not copied and must stay valid until then.
+     */
+    class frame_write : public reactor::operation {
+        public:
+            /**
+             * Create a transmission of a frame.
+             * 
+             * \param[in,out] io    The reactor to suspend on.
+             * \param[in,out] dev   The peripheral to transmit through.
+             * \param         frame The bytes of the frame.
+             */
+            frame_write( reactor& io, pw_bit& dev, std::span<const std::byte> frame );
+
+        private:
+            pw_bit&                    dev;  //!< The peripheral transmitted through.
+            std::span<const std::byte> rest; //!< The bytes of the frame left to queue.
+
+            /**
+             * Queue as much of the frame as fits, followed by the end of frame marker.
+             * 
+             * \retval true  The frame and its marker are queued.
+             * \retval false The output data FIFO is full.
+             */
+            bool poll() override;
+    };
+
+    /**
+     * An awaitable drain of the output data FIFO of a pulse-width-bit peripheral.
+     * 
+     * Completes once the output data FIFO is empty, i.e. the last word queued is being
+     * transmitted. No interrupt signals an empty FIFO, so the reactor polls the drain without
+     * sleeping for as long as it is suspended.
+     */
+    class fifo_drain : public reactor::operation {
+        public:
+            /**
+             * Create a drain of the output data FIFO.
+             * 
+             * \param[in,out] io  The reactor to suspend on.
+             * \param[in]     dev The peripheral to wait for.
+             */
+            fifo_drain( reactor& io, const pw_bit& dev );
+
+        private:
+            const pw_bit& dev; //!< The peripheral waited for.
+
+            /**
+             * Check whether or not the output data FIFO is empty.
+             * 
+             * \retval true  The output data FIFO is empty.
+             * \retval false The output data FIFO is not empty.
+             */
+            bool poll() override;
+    };
+
+    /**
+     * Transmit a frame through a pulse-width-bit peripheral from a coroutine, as in
+     * co_await write_frame( io, dev, frame ).
+     * 
+     * Progress is signalled by the refill interrupt of the peripheral. If the reactor watches any
+     * interrupt source, the refill interrupt of \a dev must be enabled and delivered through one.
+     * 
+     * \param[in,out] io    The reactor to suspend on.
+     * \param[in,out] dev   The peripheral to transmit through.
+     * \param         frame The bytes of the frame, to stay valid until the transmission completes.
+     * 
+     * \return Returns the awaitable transmission.
+     */
+    inline frame_write write_frame( reactor& io, pw_bit& dev, std::span<const std::byte> frame ) {
+        return frame_write( io, dev, frame );
+    }
+
+    /**
+     * Wait from a coroutine until the output data FIFO of a pulse-width-bit peripheral is empty,
+     * as in co_await drained( io, dev ).
+     * 
+     * The refill interrupt is raised well before the FIFO is empty, so the drain is polled, and
+     * keeps the reactor spinning until it completes. It is best awaited once the last frame is
+     * written, with little left to transmit.
+     * 
+     * \param[in,out] io  The reactor to suspend on.
+     * \param[in]     dev The peripheral to wait for.
+     * 
+     * \return Returns the awaitable drain.
+     */
+    inline fifo_drain drained( reactor& io, const pw_bit& dev ) {
+        return fifo_drain( io, dev );
+    }
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_ASYNC_HPP
@@ -0,0 +1,78 @@
+#ifndef PERIPH_PW_BIT_CACHE_HPP
+#define PERIPH_PW_BIT_CACHE_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+#include <vector>
+
+namespace periph {
+
+    /**
+     * Cache of the last frame transmitted on a shift-register LED chain, reducing frames to the
+     * part that changed.
+     * 
+     * Pixels of a WS2812-style chain each latch the first pixel they receive and forward the rest,
+     * so a pixel can only be reached by retransmitting every pixel in front of it, but pixels past
+     * the end of a short frame keep their last value. A frame identical to the previous one
+     * therefore needs no transmission at all, and any other frame may be cut after its last
+     * changed pixel. Cutting can be disabled for protocols that need whole frames.
+     */
+    class frame_cache {
+        public:
+            /**
+             * Create an empty cache, so that the first frame is transmitted in full.
+             * 
+             * \param bytes_per_pixel The number of bytes of each pixel, to which cut frames are
+             *                        rounded up.
+             * \param truncate        Whether frames may be cut after their last changed pixel.
+             *                        If not, frames are either skipped or transmitted in full.
+             */
+            explicit frame_cache( std::size_t bytes_per_pixel = 3, bool truncate = true );
+
+            /**
+             * Compare a frame against the previous one and record it as transmitted.
+             * 
+             * \param frame The bytes of the frame.
+             * 
+             * \return Returns the front part of \a frame to transmit, which is empty if the frame
+             *         is unchanged. A frame of a different size than the previous one is returned
+             *         in full.
+             */
+            std::span<const std::byte> update( std::span<const std::byte> frame );
+
+            /**
+             * Forget the previous frame, so that the next frame is transmitted in full.
+             * 
+             * This is needed whenever the chain may have lost its state, e.g. after a reset of the
+             * peripheral or a power cycle of the LEDs.
+             */
+            void invalidate();
+
+            /**
+             * Read the number of bytes saved on the last frame.
+             * 
+             * \return Returns the number of bytes of the last frame that were not transmitted.
+             */
+            std::size_t bytes_saved() const { return last_saved; }
+
+            /**
+             * Read the number of bytes saved on all frames.
+             * 
+             * \return Returns the number of frame bytes not transmitted since construction.
+             */
+            std::uint64_t total_bytes_saved() const { return total_saved; }
+
+        private:
+            std::vector<std::byte> previous;    //!< The bytes of the previous frame.
+            std::size_t            pixel_size;  //!< The number of bytes of each pixel.
+            bool                   truncate;    //!< Whether frames may be cut short.
+            bool                   valid;       //!< Whether the previous frame is known.
+            std::size_t            last_saved;  //!< Bytes saved on the last frame.
+            std::uint64_t          total_saved; //!< Bytes saved since construction.
+    };
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_CACHE_HPP
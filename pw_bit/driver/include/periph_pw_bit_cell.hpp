@@ -0,0 +1,124 @@
+#ifndef PERIPH_PW_BIT_CELL_HPP
+#define PERIPH_PW_BIT_CELL_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <bit>
+
+namespace periph::sim {
+
+    /**
+     * Cycle-accurate model of the pw_bit_cell shift logic of axi_pw_bit.
+     * 
+     * A word handed to the cell is transmitted one byte per set bit of its TSTRB, lowest byte
+     * first and most significant bit first, as WS2812-class devices expect. Each bit takes one bit
+     * period, for the first duty_hi cycles of which a one bit drives the line high, and for the
+     * first duty_lo cycles of which a zero bit does. A word with no bytes strobed, such as an
+     * end-of-frame marker, occupies the cell for a single cycle. The cell takes the next word as
+     * soon as the previous one is done.
+     * 
+     * The period is latched with each word, while the duty times are read every cycle. The
+     * pw_bit_cell source is not part of this tree; the model follows the timing axi_pw_bit and its
+     * behavioral model are built around.
+     */
+    class pw_bit_cell {
+        public:
+            /**
+             * Hand a word to the idle cell.
+             * 
+             * \param data   The TDATA of the word.
+             * \param strb   The TSTRB of the word, one bit per byte to transmit.
+             * \param period The bit period register, in number of clock cycles.
+             */
+            void load( std::uint32_t data, std::uint32_t strb, std::uint64_t period ) {
+                word       = data;
+                mask       = strb;
+                bit_cycles = period;
+                length     = std::max<std::uint64_t>( 8 * period * std::popcount( strb ), 1 );
+                elapsed    = 0;
+            }
+
+            /**
+             * Check whether or not the cell is transmitting a word.
+             * 
+             * \retval true  The cell is busy, and does not take a word.
+             * \retval false The cell is idle, and takes the next word.
+             */
+            bool busy() const { return elapsed < length; }
+
+            /**
+             * Read the number of cycles left to transmit the current word.
+             * 
+             * \return Returns the number of cycles until the cell is idle.
+             */
+            std::uint64_t remaining() const { return length - elapsed; }
+
+            /**
+             * Simulate clock cycles, up to the end of the current word.
+             * 
+             * \param num_cycles The number of clock cycles to simulate.
+             * 
+             * \return Returns the number of clock cycles simulated.
+             */
+            std::uint64_t advance( std::uint64_t num_cycles ) {
+                const std::uint64_t step = std::min( num_cycles, remaining() );
+                elapsed += step;
+
+                return step;
+            }
+
+            /**
+             * Compute the level of the line in the next cycle to simulate.
+             * 
+             * \param duty_hi The duty time of a one bit, in number of clock cycles.
+             * \param duty_lo The duty time of a zero bit, in number of clock cycles.
+             * 
+             * \return Returns the level of the line, low while the cell is idle.
+             */
+            bool txd( std::uint64_t duty_hi, std::uint64_t duty_lo ) const {
+                if ( !busy() || ( mask == 0 ) || ( bit_cycles == 0 ) ) {
+                    return false;
+                }
+
+                const std::uint64_t bit   = elapsed / bit_cycles;
+                const std::uint64_t cycle = elapsed % bit_cycles;
+
+                // Skip to the strobed byte holding the bit.
+                std::uint32_t strobes = mask;
+                for ( std::uint64_t n = bit / 8; n > 0; n-- ) {
+                    strobes &= strobes - 1;
+                }
+
+                const std::size_t shift = 8 * std::countr_zero( strobes ) + 7 - bit % 8;
+                const bool        value = ( word >> shift ) & 1;
+
+                return cycle < ( value ? duty_hi : duty_lo );
+            }
+
+            /**
+             * Read the word being transmitted, or last transmitted.
+             * 
+             * \return Returns the TDATA of the word.
+             */
+            std::uint32_t data() const { return word; }
+
+            /**
+             * Read the byte strobes of the word being transmitted, or last transmitted.
+             * 
+             * \return Returns the TSTRB of the word.
+             */
+            std::uint32_t strb() const { return mask; }
+
+        private:
+            std::uint32_t word       = 0; //!< The TDATA of the word.
+            std::uint32_t mask       = 0; //!< The TSTRB of the word.
+            std::uint64_t bit_cycles = 0; //!< The bit period latched with the word.
+            std::uint64_t length     = 0; //!< The number of cycles the word takes.
+            std::uint64_t elapsed    = 0; //!< The number of cycles of the word simulated.
+    };
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_CELL_HPP
@@ -0,0 +1,162 @@
+#ifndef PERIPH_PW_BIT_CONFIG_HPP
+#define PERIPH_PW_BIT_CONFIG_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <limits>
+#include <span>
+
+#include "periph_pw_bit.hpp"
+
+namespace periph {
+
+    /**
+     * Pulse-width-bit protocols of common LED driver chips.
+     */
+    enum class pw_bit_protocol {
+        ws2812b,     //!< WorldSemi WS2812B, from version 5 on, GRB.
+        ws2813,      //!< WorldSemi WS2813 and WS2815, GRB.
+        sk6812,      //!< SK6812, GRB.
+        sk6812_rgbw, //!< SK6812 with a white channel, GRBW.
+        apa106       //!< APA106, RGB.
+    };
+
+    /**
+     * The bit timing of a pulse-width-bit protocol, independent of the peripheral clock.
+     */
+    struct pw_bit_timing {
+        std::uint64_t period_ns;    //!< The bit period, in nanoseconds.
+        std::uint64_t duty_1b_ns;   //!< The high time of a one bit, in nanoseconds.
+        std::uint64_t duty_0b_ns;   //!< The high time of a zero bit, in nanoseconds.
+        std::uint64_t reset_ns;     //!< The low time that latches a frame, in nanoseconds.
+        int           active_bytes; //!< The number of bytes per pixel.
+    };
+
+    /**
+     * Look up the bit timing of a protocol, from the typical values of its datasheet.
+     * 
+     * \param protocol The protocol to look up.
+     * 
+     * \return Returns the bit timing of the protocol.
+     */
+    constexpr pw_bit_timing timing_of( pw_bit_protocol protocol ) {
+        switch ( protocol ) {
+            case pw_bit_protocol::ws2813:
+                return { 1250, 750, 300, 280000, 3 };
+            case pw_bit_protocol::sk6812:
+                return { 1250, 600, 300, 80000, 3 };
+            case pw_bit_protocol::sk6812_rgbw:
+                return { 1250, 600, 300, 80000, 4 };
+            case pw_bit_protocol::apa106:
+                return { 1710, 1360, 350, 50000, 3 };
+            case pw_bit_protocol::ws2812b:
+            default:
+                return { 1250, 800, 400, 280000, 3 };
+        }
+    }
+
+    /**
+     * The complete configuration of a pulse-width-bit output, as a value.
+     * 
+     * A configuration is applied to many outputs in one transaction with apply(). Outputs whose
+     * bit timing changes are disabled first, and are all enabled again once every register is
+     * written, so that no bit is ever transmitted with a mix of old and new timings, and all
+     * outputs restart together. Disabling an output drops the data queued in its FIFO. Given the
+     * configuration the outputs were last brought up with, only the registers that differ from it
+     * are written, and outputs whose bit timing is unchanged are not interrupted.
+     * 
+     * \tparam DataWidth The AXI data width the peripherals were built with: 16, 32 or 64 bits.
+     */
+    template<std::size_t DataWidth = 32>
+    struct basic_pw_bit_config {
+        using device = basic_pw_bit<DataWidth>; //!< The configured peripheral.
+        using word   = typename device::word;   //!< The type of a register.
+
+        int  active_bytes = 3;     //!< The number of bytes transmitted per word written.
+        word reset_gap    = 0;     //!< The reset gap, in number of peripheral clock cycles.
+        word period       = 0;     //!< The bit period, in number of peripheral clock cycles.
+        word duty_1b      = 0;     //!< The high time of a one bit, in clock cycles.
+        word duty_0b      = 0;     //!< The high time of a zero bit, in clock cycles.
+        bool refill_irq   = false; //!< Whether to raise the refill interrupt.
+        bool enabled      = true;  //!< Whether the output is enabled.
+
+        /**
+         * Build the configuration of a protocol, at compile time if need be.
+         * 
+         * Times are rounded to the nearest clock cycle, and saturate at the largest register
+         * value. The number of bytes per pixel is capped at the register width.
+         * 
+         * \param protocol The protocol of the attached devices.
+         * \param clock_hz The frequency of the peripheral clock, in hertz.
+         * 
+         * \return Returns an enabled configuration, with the refill interrupt disabled.
+         */
+        static constexpr basic_pw_bit_config preset(
+            pw_bit_protocol protocol,
+            std::uint64_t   clock_hz
+        ) {
+            const pw_bit_timing timing = timing_of( protocol );
+
+            const auto cycles = [clock_hz]( std::uint64_t ns ) {
+                const std::uint64_t count = ( ns * clock_hz + 500'000'000 ) / 1'000'000'000;
+                return word( std::min<std::uint64_t>( count, std::numeric_limits<word>::max() ) );
+            };
+
+            basic_pw_bit_config config;
+            config.active_bytes = std::min( timing.active_bytes, int( device::word_bytes ) );
+            config.reset_gap    = cycles( timing.reset_ns );
+            config.period       = cycles( timing.period_ns );
+            config.duty_1b      = cycles( timing.duty_1b_ns );
+            config.duty_0b      = cycles( timing.duty_0b_ns );
+
+            return config;
+        }
+
+        /**
+         * Compare two configurations register by register.
+         */
+        bool operator==( const basic_pw_bit_config& ) const = default;
+
+        /**
+         * Write this configuration to every register of a set of outputs.
+         * 
+         * Each output is disabled first, as its current configuration is unknown.
+         * 
+         * \param channels The outputs to configure.
+         * 
+         * \return Returns the number of registers written, or zero if the number of active bytes
+         *         is not between 1 and device::word_bytes.
+         */
+        std::size_t apply( std::span<device* const> channels ) const;
+
+        /**
+         * Write the registers of this configuration that differ from a previous one to a set of
+         * outputs.
+         * 
+         * \param channels The outputs to configure, all in the previous configuration.
+         * \param previous The configuration the outputs were last brought up with.
+         * 
+         * \return Returns the number of registers written, or zero if the number of active bytes
+         *         is not between 1 and device::word_bytes.
+         */
+        std::size_t apply(
+            std::span<device* const>   channels,
+            const basic_pw_bit_config& previous
+        ) const;
+    };
+
+    using pw_bit_config = basic_pw_bit_config<>; //!< A configuration of a pw_bit.
+
+}
+
+#include "periph_pw_bit_config.ipp"
+
+namespace periph {
+
+    extern template struct basic_pw_bit_config<>;
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_CONFIG_HPP
@@ -0,0 +1,195 @@
+#ifndef PERIPH_PW_BIT_ENCODE_HPP
+#define PERIPH_PW_BIT_ENCODE_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <span>
+
+namespace periph {
+
+    /**
+     * A lookup table mapping 8-bit color channel intensities to transmitted values.
+     */
+    using gamma_table = std::array<std::uint8_t,256>;
+
+    namespace detail {
+
+        /**
+         * Compute the natural logarithm of a positive value, usable in constant expressions.
+         * 
+         * \param x The value to compute the logarithm of.
+         * 
+         * \return Returns the natural logarithm of \a x.
+         */
+        constexpr double ln( double x ) {
+            constexpr double ln2 = 0.693147180559945309417;
+
+            // Scale into [1,2), then sum the series of 2 * atanh( ( x - 1 ) / ( x + 1 ) ).
+            int exponent = 0;
+            for ( ; x >= 2.0; x /= 2.0 ) {
+                exponent++;
+            }
+            for ( ; x < 1.0; x *= 2.0 ) {
+                exponent--;
+            }
+
+            const double z   = ( x - 1.0 ) / ( x + 1.0 );
+            double       pow = z;
+            double       sum = 0.0;
+            for ( int n = 1; n < 40; n += 2, pow *= z * z ) {
+                sum += pow / n;
+            }
+
+            return 2.0 * sum + exponent * ln2;
+        }
+
+        /**
+         * Compute the exponential of a value, usable in constant expressions.
+         * 
+         * \param x The value to compute the exponential of.
+         * 
+         * \return Returns e raised to the power of \a x.
+         */
+        constexpr double exp( double x ) {
+            constexpr double ln2 = 0.693147180559945309417;
+
+            // Split off a power of two, then sum the Taylor series of the small remainder.
+            const int n = static_cast<int>( x / ln2 + ( ( x < 0.0 ) ? -0.5 : 0.5 ) );
+            const double r = x - n * ln2;
+
+            double term = 1.0;
+            double sum  = 1.0;
+            for ( int k = 1; k < 30; k++ ) {
+                term *= r / k;
+                sum  += term;
+            }
+
+            for ( int k = 0; k < n; k++ ) {
+                sum *= 2.0;
+            }
+            for ( int k = 0; k > n; k-- ) {
+                sum /= 2.0;
+            }
+
+            return sum;
+        }
+
+    }
+
+    /**
+     * Build a gamma correction table, usually at compile time.
+     * 
+     * Each intensity is mapped to round( brightness * ( intensity / 255 ) ^ gamma ).
+     * 
+     * \param gamma      The gamma exponent of the LEDs' response to correct for.
+     * \param brightness The transmitted value of full intensity, scaling all values.
+     * 
+     * \return Returns the gamma correction table.
+     */
+    constexpr gamma_table make_gamma_table( double gamma, std::uint8_t brightness = 255 ) {
+        gamma_table table{};
+
+        for ( std::size_t i = 1; i < table.size(); i++ ) {
+            const double level = detail::exp( gamma * detail::ln( i / 255.0 ) );
+
+            table[i] = static_cast<std::uint8_t>( level * brightness + 0.5 );
+        }
+
+        return table;
+    }
+
+    inline constexpr gamma_table gamma_linear = make_gamma_table( 1.0 ); //!< No gamma correction.
+    inline constexpr gamma_table gamma_2_2    = make_gamma_table( 2.2 ); //!< Gamma 2.2, as sRGB.
+    inline constexpr gamma_table gamma_2_8    = make_gamma_table( 2.8 ); //!< Gamma 2.8, as WS2812.
+
+    /**
+     * The order in which an LED chain expects the color channels of each pixel.
+     */
+    enum class color_order : std::uint8_t {
+        rgb, //!< Red, green, blue.
+        rbg, //!< Red, blue, green.
+        grb, //!< Green, red, blue, as WS2812.
+        gbr, //!< Green, blue, red.
+        brg, //!< Blue, red, green.
+        bgr  //!< Blue, green, red.
+    };
+
+    /**
+     * Encoder turning RGB frames into the byte stream of a 24-bit LED chain.
+     * 
+     * Each pixel is reordered to the chain's color order, and each channel is passed through a
+     * gamma correction table scaled by a global brightness. The encoded bytes are ready to be
+     * streamed through pw_bit::write( std::span<const std::byte> ). Channel reordering uses SSSE3
+     * where the CPU supports it, detected at run time, or NEON, and float conversion SSE2 or NEON;
+     * portable code is used otherwise.
+     */
+    class frame_encoder {
+        public:
+            static constexpr std::size_t bytes_per_pixel = 3; //!< Encoded bytes of each pixel.
+
+            /**
+             * Create an encoder at full brightness.
+             * 
+             * \param order The color order of the LED chain.
+             * \param gamma The gamma correction table to apply, at full brightness.
+             */
+            explicit frame_encoder(
+                color_order        order = color_order::grb,
+                const gamma_table& gamma = gamma_2_2
+            );
+
+            /**
+             * Set the gamma correction table.
+             * 
+             * \param gamma The gamma correction table to apply, at full brightness.
+             */
+            void set_gamma( const gamma_table& gamma );
+
+            /**
+             * Set the global brightness, scaling the gamma-corrected values of all channels.
+             * 
+             * \param brightness The brightness, where 255 leaves values unscaled.
+             */
+            void set_brightness( std::uint8_t brightness );
+
+            /**
+             * Encode a frame of 8-bit RGB pixels.
+             * 
+             * \param      rgb The pixels to encode, as interleaved red, green and blue bytes.
+             * \param[out] out The buffer to write the encoded bytes to.
+             * 
+             * \return Returns the number of pixels encoded, limited by the number of whole pixels
+             *         in either buffer.
+             */
+            std::size_t encode( std::span<const std::uint8_t> rgb, std::span<std::byte> out ) const;
+
+            /**
+             * Encode a frame of floating-point RGB pixels.
+             * 
+             * \param      rgb The pixels to encode, as interleaved red, green and blue intensities
+             *                 from zero to one. Intensities out of range are clamped.
+             * \param[out] out The buffer to write the encoded bytes to.
+             * 
+             * \return Returns the number of pixels encoded, limited by the number of whole pixels
+             *         in either buffer.
+             */
+            std::size_t encode( std::span<const float> rgb, std::span<std::byte> out ) const;
+
+        private:
+            std::array<std::uint8_t,bytes_per_pixel> swizzle;    //!< Source channel of each output.
+            gamma_table                              gamma;      //!< The table at full brightness.
+            gamma_table                              lut;        //!< The table at set brightness.
+            std::uint8_t                             brightness; //!< The global brightness.
+            bool                                     identity;   //!< Whether the table is a no-op.
+
+            /**
+             * Rebuild the lookup table from the gamma table and brightness.
+             */
+            void update_lut( void );
+    };
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_ENCODE_HPP
@@ -0,0 +1,154 @@
+#ifndef PERIPH_PW_BIT_GROUP_HPP
+#define PERIPH_PW_BIT_GROUP_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+#include <vector>
+
+#include "periph_pw_bit.hpp"
+#include "periph_pw_bit_cache.hpp"
+#include "periph_trace.hpp"
+
+namespace periph {
+
+    /**
+     * A scheduler feeding frames into several pulse-width-bit peripherals in parallel.
+     * 
+     * Each channel is given one frame at a time. Refills are interleaved across all channels
+     * round-robin, each channel receiving as large a burst as its output data FIFO currently has
+     * room for, so that all channels transmit concurrently. Each frame is followed by an end of
+     * frame marker, so that the peripheral inserts its reset gap in hardware while the next frame
+     * is already being queued. Frames may also be submitted against
+     * a per-channel frame_cache, so that unchanged channels are skipped and changed channels are
+     * cut after their last changed pixel.
+     */
+    class pw_bit_group {
+        public:
+            /**
+             * Create a scheduler over the given peripherals.
+             * 
+             * \param channels        The peripherals to schedule, in channel index order. The
+             *                        peripherals must outlive the scheduler.
+             * \param bytes_per_pixel The number of bytes of each pixel of frames submitted through
+             *                        submit_changes( std::size_t, std::span<const std::byte> ).
+             */
+            explicit pw_bit_group(
+                std::span<pw_bit* const> channels,
+                std::size_t              bytes_per_pixel = 3
+            );
+
+            /**
+             * Read the number of channels in this group.
+             * 
+             * \return Returns the number of channels.
+             */
+            std::size_t size() const { return channels.size(); }
+
+            /**
+             * Hand a frame to a channel.
+             * 
+             * The frame buffer is not copied and must stay valid until the channel is idle.
+             * 
+             * \param channel The index of the channel to transmit the frame on.
+             * \param frame   The bytes of the frame.
+             * 
+             * \retval true  The frame was accepted.
+             * \retval false The channel index is invalid or the channel is still busy.
+             */
+            bool submit( std::size_t channel, std::span<const std::byte> frame );
+
+            /**
+             * Hand a frame to a channel, transmitting only what changed since its previous frame.
+             * 
+             * The frame is compared against the last frame submitted through this function on the
+             * same channel. An unchanged frame is not transmitted, and a changed frame is cut after
+             * its last changed pixel. The frame buffer is not copied and must stay valid until the
+             * channel is idle.
+             * 
+             * \param channel The index of the channel to transmit the frame on.
+             * \param frame   The bytes of the frame.
+             * 
+             * \retval true  The frame was accepted, even if nothing of it needs transmitting.
+             * \retval false The channel index is invalid or the channel is still busy.
+             */
+            bool submit_changes( std::size_t channel, std::span<const std::byte> frame );
+
+            /**
+             * Forget the previous frame of a channel, so its next frame is transmitted in full.
+             * 
+             * \param channel The index of the channel to invalidate.
+             */
+            void invalidate( std::size_t channel );
+
+            /**
+             * Perform one non-blocking round-robin refill pass over all busy channels.
+             * 
+             * \return Returns the number of channels that still have frame data left to queue.
+             */
+            std::size_t service();
+
+            /**
+             * Run refill passes until all submitted frames are queued.
+             */
+            void run();
+
+            /**
+             * Check whether or not a channel still has frame data or its end of frame marker left to
+             * queue.
+             * 
+             * \param channel The index of the channel to check.
+             * 
+             * \retval true  The channel is still busy.
+             * \retval false The channel is idle and ready for a new frame.
+             */
+            bool busy( std::size_t channel ) const;
+
+            /**
+             * Read the number of FIFO underruns of a channel since the group was created.
+             * 
+             * The count is the increase of the peripheral's own underrun counter, read from the
+             * hardware on each call, so every time the output ran dry in the middle of a frame is
+             * counted. If the peripheral's counters were cleared since, the count restarts from
+             * the cleared counter. It stops increasing once the hardware counter saturates.
+             * 
+             * \param channel The index of the channel to read.
+             * 
+             * \return Returns the number of underruns of the channel.
+             */
+            std::size_t underruns( std::size_t channel ) const;
+
+            /**
+             * Read the number of bytes saved on the last frame submitted through
+             * submit_changes( std::size_t, std::span<const std::byte> ) on a channel.
+             * 
+             * \param channel The index of the channel to read.
+             * 
+             * \return Returns the number of bytes of the last frame that were not transmitted.
+             */
+            std::size_t bytes_saved( std::size_t channel ) const;
+
+        private:
+            /**
+             * Scheduling state of a single channel.
+             */
+            struct channel_state {
+                pw_bit*                    dev;            //!< The peripheral of the channel.
+                std::span<const std::byte> frame;          //!< The frame being transmitted.
+                std::size_t                queued;         //!< The number of frame bytes queued.
+                bool                       framed;         //!< Whether the marker is unqueued.
+                std::size_t                underruns_base; //!< Underrun counter at group creation.
+                std::size_t                underruns_seen; //!< Underrun counter last traced.
+                frame_cache                cache;          //!< The previous frame of the channel.
+
+                [[no_unique_address]] trace::frame_timer timer; //!< Times the current frame.
+            };
+
+            std::vector<channel_state> channels; //!< The scheduled channels.
+            std::size_t                next;     //!< The channel to start the next pass at.
+    };
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_GROUP_HPP
@@ -0,0 +1,245 @@
+#ifndef PERIPH_PW_BIT_MODEL_HPP
+#define PERIPH_PW_BIT_MODEL_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <bit>
+#include <deque>
+#include <vector>
+
+#include "periph_pw_bit.hpp"
+#include "periph_pw_bit_cell.hpp"
+#include "periph_sim.hpp"
+#include "periph_vcd.hpp"
+
+namespace periph::sim {
+
+    /**
+     * Behavioral model of an axi_pw_bit block of pulse-width-bit peripherals.
+     * 
+     * Each output is modelled with its output data FIFO, of depth fifo_depth, and its
+     * empty/full/almost-empty/almost-full flags, set at fifo_watermark words from either end.
+     * Each FIFO word is latched together with the byte mask register at the time it is written.
+     * A word takes eight bit periods per active byte to transmit, and is removed from the FIFO
+     * when its transmission starts. An end-of-frame marker, a word with no active bytes and its
+     * lowest bit set, is followed by the reset gap, during which no word leaves the FIFO.
+     * Disabling an output resets its FIFO. The refill interrupt is raised as in the hardware, and
+     * is delivered through a file descriptor of the model. A model running in real time also
+     * signals it ahead of time, at the predicted cycle the next FIFO crosses its almost-empty
+     * watermark, so that a refill engine or reactor sleeping on it is woken without the model
+     * being accessed.
+     * 
+     * Reading the data register of an output returns its FIFO fill level. Words written to a full
+     * FIFO are counted as overflows, and the output running out of words in the middle of a frame
+     * as an underrun, in saturating counters in the upper half of the configuration register.
+     * 
+     * The stream port accepts beats into the FIFO of the output selected by TDEST, with TKEEP as
+     * the byte mask, queues an end-of-frame marker after each beat with TLAST set, and refuses
+     * beats while that FIFO is full.
+     * 
+     * Each output shifts its words out through a pw_bit_cell. With a VCD writer attached, the
+     * model steps one cycle at a time and records the line of every output.
+     */
+    class pw_bit_model : public model, public axis_sink {
+        public:
+            static constexpr std::size_t num_outputs = 4; //!< The number of modelled outputs.
+
+            /**
+             * Create a model with all registers reset.
+             * 
+             * \param clock_hz The clock frequency to run the model at in real time, or zero to
+             *                 only advance the model explicitly.
+             */
+            explicit pw_bit_model( std::uint64_t clock_hz = 0 );
+
+            ~pw_bit_model() override; //!< Close the refill interrupt descriptor.
+
+            /**
+             * Access the driver of one output.
+             * 
+             * \param index The index of the output.
+             * 
+             * \return Returns the peripheral driver of the output.
+             */
+            pw_bit& output( std::size_t index );
+
+            /**
+             * Read the file descriptor the refill interrupt is delivered through.
+             * 
+             * The descriptor is a timerfd, read like an eventfd, i.e. as an event_kind::eventfd
+             * source. It becomes readable on each rising edge of the refill interrupt, or at the
+             * time the interrupt is predicted to rise. A pending signal is withdrawn when the
+             * interrupt falls before being read.
+             * 
+             * \return Returns the file descriptor, owned by the model, or a negative value if it
+             *         could not be created.
+             */
+            int irq_fd() const { return irq_timer; }
+
+            /**
+             * Record the line of every output in a value change dump, at the model's cycle count.
+             * 
+             * The signals are declared on the writer right away, so this must be called before the
+             * first change is recorded.
+             * 
+             * \param[in,out] writer The writer to record to, or null to stop recording.
+             */
+            void set_vcd( vcd_writer* writer );
+
+            /**
+             * Read the state of the refill interrupt line.
+             * 
+             * \retval true  The refill interrupt is raised.
+             * \retval false The refill interrupt is not raised.
+             */
+            bool irq() const { return irq_state; }
+
+            /**
+             * Read the number of words in the output data FIFO of an output.
+             * 
+             * \param index The index of the output.
+             * 
+             * \return Returns the number of words queued but not yet being transmitted.
+             */
+            std::size_t fifo_level( std::size_t index ) const { return outputs[index].fifo.size(); }
+
+            /**
+             * Remove and return the bytes an output has finished transmitting.
+             * 
+             * \param index The index of the output.
+             * 
+             * \return Returns the transmitted bytes, in transmission order.
+             */
+            std::vector<std::uint8_t> take_transmitted( std::size_t index );
+
+            bool push(
+                std::uint32_t dest,
+                std::uint32_t data,
+                std::uint32_t keep,
+                bool          last
+            ) override;
+
+        protected:
+            void run( std::uint64_t num_cycles ) override;
+            void write_fifo( std::size_t offset, std::uint32_t data ) override;
+
+        private:
+            /**
+             * The number of 32-bit registers of each output.
+             */
+            static constexpr std::size_t output_regs = block_size / sizeof( std::uint32_t );
+
+            static constexpr std::uint64_t irq_now   = 0;                    //!< Signal right away.
+            static constexpr std::uint64_t irq_never = ~std::uint64_t{ 0 }; //!< Signal never.
+
+            /**
+             * A word in an output data FIFO.
+             */
+            struct fifo_word {
+                std::uint32_t data; //!< The data bytes.
+                std::uint32_t mask; //!< The byte mask latched when the word was written.
+                bool          last; //!< Whether the word is an end-of-frame marker.
+            };
+
+            /**
+             * A tally of FIFO words, from which the time they take to transmit follows.
+             */
+            struct word_tally {
+                std::uint64_t words = 0; //!< The number of words.
+                std::uint64_t bytes = 0; //!< The number of active bytes of the words.
+                std::uint64_t empty = 0; //!< The number of words without active bytes.
+                std::uint64_t marks = 0; //!< The number of end-of-frame markers.
+
+                /**
+                 * Add a word to, or remove it from, the tally.
+                 * 
+                 * \param word  The word to count.
+                 * \param count One to add the word, or minus one to remove it.
+                 */
+                void add( const fifo_word& word, int count ) {
+                    words += count;
+                    bytes += count * std::popcount( word.mask );
+                    empty += ( word.mask == 0 ) ? count : 0;
+                    marks += word.last ? count : 0;
+                }
+            };
+
+            /**
+             * Simulation state of a single output.
+             */
+            struct output_state {
+                std::deque<fifo_word>     fifo;        //!< The output data FIFO.
+                word_tally                ahead;       //!< All but the last watermark + 1 words.
+                fifo_word                 current;     //!< The word being transmitted.
+                pw_bit_cell               cell;        //!< The shift logic transmitting it.
+                bool                      line;        //!< The line level in the last cycle.
+                std::uint64_t             gap;         //!< Cycles left of the reset gap.
+                std::vector<std::uint8_t> transmitted; //!< Bytes finished transmitting.
+                bool                      in_frame;    //!< Whether a frame is being transmitted.
+                bool                      starved;     //!< Whether the underrun was counted.
+                std::uint32_t             overflows;   //!< The saturating overflow count.
+                std::uint32_t             underruns;   //!< The saturating underrun count.
+            };
+
+            /**
+             * The register window, laid out as in axi_pw_bit.
+             */
+            alignas( block_size ) std::array<volatile std::uint32_t,num_outputs*output_regs> regs;
+
+            std::array<output_state,num_outputs> outputs;   //!< The output states.
+            int                                  irq_timer; //!< The interrupt timerfd, or negative.
+            std::uint64_t                        irq_armed; //!< The cycle the timerfd is set to.
+            bool                                 irq_state; //!< The refill interrupt line.
+            vcd_writer*                          vcd;       //!< The line recorder, or null.
+            std::array<std::size_t,num_outputs>  traces;    //!< The line signal of each output.
+
+            /**
+             * Simulate a number of clock cycles of a single output.
+             * 
+             * \param index      The index of the output.
+             * \param num_cycles The number of clock cycles to simulate.
+             */
+            void run_output( std::size_t index, std::uint64_t num_cycles );
+
+            /**
+             * Append a word to the FIFO of an output.
+             * 
+             * \param[in,out] out  The output state.
+             * \param         word The word to append.
+             */
+            static void push_word( output_state& out, const fifo_word& word );
+
+            /**
+             * Remove the first word from the non-empty FIFO of an output.
+             * 
+             * \param[in,out] out The output state.
+             * 
+             * \return Returns the removed word.
+             */
+            static fifo_word pop_word( output_state& out );
+
+            /**
+             * Predict the number of clock cycles until the FIFO of an output falls to its
+             * almost-empty watermark, assuming no more words are written.
+             * 
+             * \param index The index of the output.
+             * 
+             * \return Returns the number of cycles until the FIFO is almost empty, zero if it
+             *         already is.
+             */
+            std::uint64_t cycles_to_refill( std::size_t index ) const;
+
+            /**
+             * Set the cycle to signal the refill interrupt descriptor at.
+             * 
+             * \param cycle The cycle to signal at, irq_now to signal right away, or irq_never to
+             *              withdraw any signal.
+             */
+            void arm_irq( std::uint64_t cycle );
+    };
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_MODEL_HPP
@@ -0,0 +1,252 @@
+#ifndef PERIPH_PW_BIT_QUEUE_HPP
+#define PERIPH_PW_BIT_QUEUE_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <stop_token>
+#include <vector>
+
+#include "periph_pw_bit.hpp"
+#include "periph_pw_bit_group.hpp"
+
+namespace periph {
+
+    /**
+     * A callback releasing a frame buffer, called with the frame's context and whether the
+     * frame was queued in the peripheral (true) or dropped (false).
+     */
+    using frame_release = void (*)( void* context, bool sent );
+
+    /**
+     * A frame handed from a producer thread to the thread owning the peripherals.
+     */
+    struct frame_desc {
+        std::span<const std::byte> frame;   //!< The frame bytes, valid until released.
+        frame_release              release; //!< Called once the frame is done with, or null.
+        void*                      context; //!< Passed to release.
+    };
+
+    /**
+     * What a frame_queue does with a frame pushed while it is full.
+     */
+    enum class queue_policy : std::uint8_t {
+        backpressure, //!< Refuse the new frame, and let the producer decide.
+        drop_oldest   //!< Drop the oldest queued frame to make room for the new one.
+    };
+
+    /**
+     * Counters of a frame_queue, as a snapshot.
+     * 
+     * Enqueue latency is the time a push takes, including retries under contention and any
+     * frame dropped to make room. Wait latency is the time from a push to the matching pop.
+     */
+    struct queue_stats {
+        std::uint64_t pushed;      //!< The number of frames accepted.
+        std::uint64_t rejected;    //!< The number of frames refused while full.
+        std::uint64_t dropped;     //!< The number of frames dropped while full.
+        std::uint64_t popped;      //!< The number of frames taken by the consumer.
+        std::uint64_t push_ns;     //!< The total enqueue latency, in nanoseconds.
+        std::uint64_t push_ns_max; //!< The longest enqueue latency, in nanoseconds.
+        std::uint64_t wait_ns;     //!< The total wait latency, in nanoseconds.
+        std::uint64_t wait_ns_max; //!< The longest wait latency, in nanoseconds.
+    };
+
+    /**
+     * A bounded lock-free queue of frame descriptors with many producers and one consumer.
+     * 
+     * The queue is a ring of slots each carrying a sequence number, so producers claim slots with
+     * a single compare-and-swap and never wait on each other or on the consumer. All memory is
+     * allocated at construction. Under queue_policy::drop_oldest, a producer finding the queue
+     * full takes the oldest frame itself and releases it as not sent, from the producer thread.
+     */
+    class frame_queue {
+        public:
+            /**
+             * Create an empty queue.
+             * 
+             * \param capacity The number of frames the queue holds, rounded up to a power of two.
+             * \param policy   What to do with frames pushed while the queue is full.
+             */
+            explicit frame_queue(
+                std::size_t  capacity,
+                queue_policy policy = queue_policy::backpressure
+            );
+
+            frame_queue( const frame_queue& ) = delete;
+            frame_queue& operator=( const frame_queue& ) = delete;
+
+            /**
+             * Read the number of frames the queue holds.
+             * 
+             * \return Returns the capacity of the queue.
+             */
+            std::size_t capacity() const { return slots.size(); }
+
+            /**
+             * Queue a frame. Safe to call from any number of threads.
+             * 
+             * \param desc The frame to queue.
+             * 
+             * \retval true  The frame was queued.
+             * \retval false The queue is full and its policy is queue_policy::backpressure.
+             */
+            bool push( const frame_desc& desc );
+
+            /**
+             * Take the oldest frame. Must only be called from the consumer thread.
+             * 
+             * \param[out] desc The frame taken, if any.
+             * 
+             * \retval true  A frame was taken.
+             * \retval false The queue is empty.
+             */
+            bool pop( frame_desc& desc );
+
+            /**
+             * Read the counters of the queue.
+             * 
+             * \return Returns a snapshot of the counters, which are updated with relaxed ordering
+             *         and so may be mutually inconsistent while producers are running.
+             */
+            queue_stats stats() const;
+
+        private:
+            static constexpr std::size_t line_size = 64; //!< Assumed cache line size.
+
+            /**
+             * A frame slot, on its own cache line so producers of neighbouring slots do not
+             * contend.
+             */
+            struct alignas( line_size ) slot {
+                std::atomic<std::size_t> sequence; //!< The position the slot is ready for.
+                frame_desc               desc;     //!< The frame held.
+                std::uint64_t            stamp;    //!< The time the frame was pushed, in ns.
+            };
+
+            /**
+             * Counters shared by the producers, kept apart from the ring indices.
+             */
+            struct alignas( line_size ) counters {
+                std::atomic<std::uint64_t> pushed;      //!< See queue_stats::pushed.
+                std::atomic<std::uint64_t> rejected;    //!< See queue_stats::rejected.
+                std::atomic<std::uint64_t> dropped;     //!< See queue_stats::dropped.
+                std::atomic<std::uint64_t> popped;      //!< See queue_stats::popped.
+                std::atomic<std::uint64_t> push_ns;     //!< See queue_stats::push_ns.
+                std::atomic<std::uint64_t> push_ns_max; //!< See queue_stats::push_ns_max.
+                std::atomic<std::uint64_t> wait_ns;     //!< See queue_stats::wait_ns.
+                std::atomic<std::uint64_t> wait_ns_max; //!< See queue_stats::wait_ns_max.
+            };
+
+            std::vector<slot> slots;  //!< The ring of slots.
+            std::size_t       mask;   //!< The mask wrapping positions to slot indices.
+            queue_policy      policy; //!< What to do with frames pushed while full.
+
+            alignas( line_size ) std::atomic<std::size_t> tail; //!< The next position to push.
+            alignas( line_size ) std::atomic<std::size_t> head; //!< The next position to pop.
+
+            counters count; //!< The counters of the queue.
+
+            /**
+             * Claim the slot at the tail and fill it.
+             * 
+             * \param desc  The frame to queue.
+             * \param stamp The time of the push, in nanoseconds.
+             * 
+             * \retval true  The frame was queued.
+             * \retval false The queue is full.
+             */
+            bool try_push( const frame_desc& desc, std::uint64_t stamp );
+
+            /**
+             * Claim the slot at the head and empty it. Safe against concurrent takers.
+             * 
+             * \param[out] desc  The frame taken, if any.
+             * \param[out] stamp The time the frame was pushed, in nanoseconds.
+             * 
+             * \retval true  A frame was taken.
+             * \retval false The queue is empty.
+             */
+            bool take( frame_desc& desc, std::uint64_t& stamp );
+    };
+
+    /**
+     * The consumer side of per-channel frame queues, owning the peripherals of a pw_bit_group.
+     * 
+     * Any thread may push frames to any channel. One thread calls service() or run(), and is
+     * the only one touching the bus. Each channel takes its next queued frame once the previous
+     * one is fully queued in the peripheral, at which point the previous frame is released as
+     * sent, so its buffer may be reused.
+     */
+    class pw_bit_dispatcher {
+        public:
+            /**
+             * Create a dispatcher over the given peripherals.
+             * 
+             * \param channels The peripherals to drive, in channel index order. The peripherals
+             *                 must outlive the dispatcher.
+             * \param depth    The number of frames each channel queue holds.
+             * \param policy   What to do with frames pushed to a full channel queue.
+             */
+            pw_bit_dispatcher(
+                std::span<pw_bit* const> channels,
+                std::size_t              depth,
+                queue_policy             policy = queue_policy::backpressure
+            );
+
+            /**
+             * Read the number of channels.
+             * 
+             * \return Returns the number of channels.
+             */
+            std::size_t size() const { return queues.size(); }
+
+            /**
+             * Queue a frame on a channel. Safe to call from any thread.
+             * 
+             * \param channel The index of the channel to transmit the frame on.
+             * \param desc    The frame to transmit.
+             * 
+             * \retval true  The frame was queued.
+             * \retval false The channel index is invalid, or its queue is full and applies
+             *               backpressure.
+             */
+            bool push( std::size_t channel, const frame_desc& desc );
+
+            /**
+             * Perform one non-blocking pass, starting queued frames on idle channels and refilling
+             * busy ones. Must only be called from the consumer thread.
+             * 
+             * \return Returns the number of channels with a frame in flight.
+             */
+            std::size_t service();
+
+            /**
+             * Service the channels until stop is requested, yielding when all channels are idle.
+             * 
+             * \param stop The token to stop on, e.g. from the std::jthread running this.
+             */
+            void run( std::stop_token stop );
+
+            /**
+             * Read the counters of a channel queue.
+             * 
+             * \param channel The index of the channel to read.
+             * 
+             * \return Returns a snapshot of the counters, or all zero for an invalid channel.
+             */
+            queue_stats stats( std::size_t channel ) const;
+
+        private:
+            pw_bit_group                              group;    //!< The refill scheduler.
+            std::vector<std::unique_ptr<frame_queue>> queues;   //!< The queue of each channel.
+            std::vector<frame_desc>                   current;  //!< The frame of each channel.
+            std::vector<bool>                         inflight; //!< Whether current is valid.
+    };
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_QUEUE_HPP
@@ -0,0 +1,85 @@
+#ifndef PERIPH_PW_BIT_REFILL_HPP
+#define PERIPH_PW_BIT_REFILL_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+
+#include "periph_irq.hpp"
+#include "periph_pw_bit.hpp"
+
+namespace periph {
+
+    /**
+     * Interrupt-driven refill engine streaming data into a pulse-width-bit peripheral.
+     * 
+     * The engine writes as much data as fits into the output data FIFO, then sleeps on an event
+     * file descriptor until the peripheral's refill interrupt signals that the FIFO dropped below
+     * its almost-empty watermark. No CPU time is spent polling the FIFO status in between.
+     */
+    class pw_bit_refill {
+        public:
+            using event_kind = periph::event_kind; //!< The kind of the interrupt source.
+
+            /**
+             * Attach a refill engine to a pulse-width-bit peripheral.
+             * 
+             * Enables the peripheral's refill interrupt. The event file descriptor is not owned
+             * by the engine and must outlive it.
+             * 
+             * \param[in,out] dev      The peripheral to stream data into.
+             * \param         event_fd The file descriptor refill interrupts are delivered through.
+             * \param         kind     The kind of file descriptor \a event_fd is.
+             */
+            pw_bit_refill( pw_bit& dev, int event_fd, event_kind kind = event_kind::uio );
+
+            /**
+             * Detach the refill engine, disabling the peripheral's refill interrupt.
+             */
+            ~pw_bit_refill();
+
+            pw_bit_refill( const pw_bit_refill& ) = delete;            //!< Disallow copying.
+            pw_bit_refill& operator=( const pw_bit_refill& ) = delete; //!< Disallow copying.
+
+            /**
+             * Stream a byte buffer out through the peripheral, blocking until all of it is queued.
+             * 
+             * \param data       The bytes to transmit.
+             * \param timeout_ms The longest time to wait for a single refill interrupt, in
+             *                   milliseconds. A negative value waits indefinitely.
+             * 
+             * \return Returns the number of bytes queued into the output data FIFO. This is less
+             *         than the size of \a data only if waiting for a refill interrupt failed or
+             *         timed out.
+             */
+            std::size_t stream( std::span<const std::byte> data, int timeout_ms = -1 );
+
+            /**
+             * Read the number of refill interrupts the engine has woken up on.
+             * 
+             * \return Returns the number of refill interrupts handled since construction.
+             */
+            std::size_t wakeups() const { return num_wakeups; }
+
+        private:
+            pw_bit&     dev;         //!< The peripheral being fed.
+            int         fd;          //!< The refill interrupt file descriptor.
+            event_kind  kind;        //!< The kind of refill interrupt file descriptor.
+            std::size_t num_wakeups; //!< The number of refill interrupts handled.
+
+            /**
+             * Block until the next refill interrupt.
+             * 
+             * \param timeout_ms The longest time to wait, in milliseconds, or negative to wait
+             *                   indefinitely.
+             * 
+             * \retval true  A refill interrupt occurred.
+             * \retval false Waiting failed or timed out.
+             */
+            bool wait( int timeout_ms );
+    };
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_REFILL_HPP
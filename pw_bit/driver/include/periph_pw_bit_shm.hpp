@@ -0,0 +1,153 @@
+#ifndef PERIPH_PW_BIT_SHM_HPP
+#define PERIPH_PW_BIT_SHM_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <span>
+
+#include "periph_pw_bit_group.hpp"
+
+namespace periph {
+
+    constexpr std::size_t frame_buffer_slots = 3; //!< The number of frames of a frame buffer.
+
+    /**
+     * A triple-buffered frame buffer in memory shared between a producer and a feeder process.
+     * 
+     * The buffer lives in a memfd, so it can be mapped by a process rendering frames and by the
+     * process owning the pulse-width-bit peripherals, which streams frames straight out of the
+     * shared memory. Of its three slots, the producer owns one to render into, the feeder owns one
+     * to transmit from, and the third holds the latest completed frame. Handing a frame over is a
+     * single atomic swap of slot indices on either side, so neither side ever waits for the other,
+     * copies a frame or allocates memory. A frame published while the previous one is still
+     * waiting replaces it, so the feeder always transmits the newest frame.
+     * 
+     * There must be one producer and one feeder. The slot each side owns is kept in the shared
+     * memory, so either process may restart and map the buffer again.
+     */
+    class shared_frame_buffer {
+        public:
+            /**
+             * Create a frame buffer in a new memfd.
+             * 
+             * \param capacity The size of each frame slot, in bytes.
+             */
+            explicit shared_frame_buffer( std::size_t capacity );
+
+            /**
+             * Map an existing frame buffer.
+             * 
+             * A process holding the memfd of a buffer, e.g. received over a UNIX socket, maps it
+             * through /proc/self/fd/<fd>. Another process of the same user can map it through
+             * /proc/<pid>/fd/<fd> of the creating process.
+             * 
+             * \param[in] path The file to map the frame buffer from.
+             */
+            explicit shared_frame_buffer( const char* path );
+
+            /**
+             * Unmap the frame buffer, and close its file descriptor.
+             */
+            ~shared_frame_buffer();
+
+            shared_frame_buffer( const shared_frame_buffer& ) = delete; //!< Disallow copying.
+            shared_frame_buffer& operator=( const shared_frame_buffer& ) = delete; //!< Ditto.
+
+            /**
+             * Check whether or not the frame buffer was created or mapped successfully.
+             * 
+             * \retval true  The frame buffer is mapped.
+             * \retval false Creating, opening or mapping the file failed, or it holds no frame
+             *               buffer.
+             */
+            bool valid() const { return header != nullptr; }
+
+            /**
+             * Read the file descriptor of the frame buffer, to hand to another process.
+             * 
+             * \return Returns the file descriptor, or a negative value if invalid.
+             */
+            int fd() const { return file; }
+
+            /**
+             * Read the size of each frame slot.
+             * 
+             * \return Returns the size of each frame slot, in bytes.
+             */
+            std::size_t capacity() const;
+
+            /**
+             * Access the slot the producer renders the next frame into.
+             * 
+             * The slot holds an older frame, which the producer may update rather than render
+             * from scratch if it keeps track of which one it was.
+             * 
+             * \return Returns the producer's slot.
+             */
+            std::span<std::byte> back();
+
+            /**
+             * Publish the frame rendered into the producer's slot as the latest frame, and take
+             * over another slot to render the next frame into.
+             * 
+             * \param length The length of the frame, in bytes, at most the slot size.
+             */
+            void publish( std::size_t length );
+
+            /**
+             * Take over the latest frame, if one was published since the last call.
+             * 
+             * The slot of the previous frame is handed back to the producer, so the previous
+             * frame must be done with, i.e. fully queued in the peripheral.
+             * 
+             * \return Returns the new frame, or an empty span if no new frame was published.
+             */
+            std::span<const std::byte> acquire();
+
+            /**
+             * Hand the latest frame to a channel of a scheduler, once the channel is idle.
+             * 
+             * The frame is transmitted in place from the shared memory. Calling this on every
+             * pass of the scheduler starts each frame as soon as the previous one is fully queued,
+             * keeping the latency from publishing to transmitting within one frame.
+             * 
+             * \param[in,out] group   The scheduler transmitting the frames.
+             * \param         channel The index of the channel to transmit the frames on.
+             * 
+             * \retval true  A new frame was handed to the channel.
+             * \retval false The channel is busy, or no new frame was published.
+             */
+            bool feed( pw_bit_group& group, std::size_t channel );
+
+        private:
+            struct layout;
+
+            layout*     header; //!< The shared control block, or null if invalid.
+            std::byte*  slots;  //!< The first frame slot.
+            std::size_t size;   //!< The size of the mapping, in bytes.
+            int         file;   //!< The memfd of the frame buffer, or negative.
+
+            /**
+             * Map the frame buffer from its file.
+             * 
+             * \param create Whether to initialize a new frame buffer of the file's size.
+             * 
+             * \retval true  The frame buffer was mapped.
+             * \retval false Mapping failed, or the file holds no frame buffer.
+             */
+            bool map( bool create );
+
+            /**
+             * Access a frame slot.
+             * 
+             * \param index The index of the slot.
+             * 
+             * \return Returns the first byte of the slot.
+             */
+            std::byte* slot( std::uint32_t index ) const;
+    };
+
+}
+
+#endif // #ifndef PERIPH_PW_BIT_SHM_HPP
@@ -1,153 +1,8 @@
-#include <atomic>
-
 #include "periph_pw_bit.hpp"
 
-using namespace periph;
-
-namespace {
-
-    /**
-     * Register-wise access struct for pulse-width-bit peripheral memory-mapped registers.
-     */
-    struct memory_map {
-        volatile       std::atomic_uint32_t fifo_write;    //!< Data FIFO write register.
-        volatile       std::uint32_t        byte_mask;     //!< Byte mask register.
-        volatile const std::uint32_t        RESERVED_0x08; //!< Reserved.
-        volatile const std::uint32_t        RESERVED_0x0C; //!< Reserved.
-        volatile       std::uint32_t        period;        //!< Bit period register.
-        volatile       std::uint32_t        duty_1b;       //!< 1-bit duty time register.
-        volatile       std::uint32_t        duty_0b;       //!< 0-bit duty time register.
-        union {
-            struct {
-                volatile const std::uint32_t RESERVED_0x1C : 29; //!< Reserved.
-                volatile const bool          full          : 1;  //!< FIFO full bit.
-                volatile const bool          empty         : 1;  //!< FIFO empty bit.
-                volatile       std::uint32_t rst           : 1;  //!< Enable bit.
-            } b;
-            volatile std::uint32_t w;
-        } cfg;
-
-        /**
-         * Copy configurations from another pulse-width-bit memory block.
-         * 
-         * \param[in] rhs The peripheral memory block to copy from.
-         * 
-         * \return Returns self-reference.
-         */
-        memory_map& operator=( const memory_map& rhs ) {
-            this->byte_mask = rhs.byte_mask;
-            this->period = rhs.period;
-            this->duty_1b = rhs.duty_1b;
-            this->duty_0b = rhs.duty_0b;
-            this->cfg.b.rst = rhs.cfg.b.rst;
-
-            return *this;
-        }
-    };
-    static_assert(
-        sizeof( pw_bit ) == sizeof( memory_map ),
-        "User handle and register memory map size mismatch"
-    );
-
-    /**
-     * Cast a user pulse-width-bit class to a register memory map.
-     * 
-     * \param[in] dev The opaque user class to cast.
-     * 
-     * \return Returns the memory-mapped registers corresponding to the opaque user class.
-     */
-    memory_map& to_map( pw_bit& dev ) {
-        return *reinterpret_cast<memory_map*>( &dev );
-    }
-
-    /**
-     * Cast a read-only user pulse-width-bit class to a register memory map.
-     * 
-     * \param[in] dev The read-only opaque user class to cast.
-     * 
-     * \return Returns the read-only memory-mapped registers corresponding to the opaque user class.
-     */
-    const memory_map& to_map( const pw_bit& dev ) {
-        return *reinterpret_cast<const memory_map*>( &dev );
-    }
-
-}
-
-pw_bit& pw_bit::operator=( const pw_bit& rhs ) {
-    to_map( *this ) = to_map( rhs );
-
-    return *this;
-}
-
-pw_bit& pw_bit::operator=( pw_bit&& rhs ) {
-    auto& other_map = to_map( rhs );
-
-    to_map( *this ) = other_map;
-
-    other_map.byte_mask = 0;
-    other_map.period = 0;
-    other_map.duty_1b = 0;
-    other_map.duty_0b = 0;
-    other_map.cfg.b.rst = 0;
-
-    return *this;
-}
-
-void pw_bit::enable() {
-    to_map( *this ).cfg.w = 1;
-}
+namespace periph {
 
-void pw_bit::disable() {
-    to_map( *this ).cfg.w = 0;
-}
-
-void pw_bit::write( std::uint32_t data ) {
-    to_map( *this ).fifo_write = data;
-}
-
-bool pw_bit::fifo_empty() const {
-    return to_map( *this ).cfg.b.empty;
-}
-
-bool pw_bit::fifo_full() const {
-    return to_map( *this ).cfg.b.full;
-}
-
-void pw_bit::set_active_bytes( int num_bytes ) {
-    switch(num_bytes) {
-        case 0  :
-            to_map( *this ).byte_mask = 0x00000000;
-            break;
-
-        case 1  :
-            to_map( *this ).byte_mask = 0x00000001;
-            break;
-
-        case 2  :
-            to_map( *this ).byte_mask = 0x00000003;
-            break;
-
-        case 3  :
-            to_map( *this ).byte_mask = 0x00000007;
-            break;
-
-        case 4  :
-            to_map( *this ).byte_mask = 0x0000000F;
-            break;
-
-        default :
-            return;
-    }
-}
-
-void pw_bit::set_period( std::uint32_t period ) {
-    to_map( *this ).period = period;
-}
-
-void pw_bit::set_1b_duty( std::uint32_t duty ) {
-    to_map( *this ).duty_1b = duty;
-}
+    // The 32-bit peripheral behind the pw_bit alias is compiled once, here.
+    template class basic_pw_bit<>;
 
-void pw_bit::set_0b_duty( std::uint32_t duty ) {
-    to_map( *this ).duty_0b = duty;
 }
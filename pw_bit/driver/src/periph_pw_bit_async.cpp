@@ -0,0 +1,32 @@
+#include "periph_pw_bit_async.hpp"
+
+using namespace periph;
+
+frame_write::frame_write( reactor& io, pw_bit& dev, std::span<const std::byte> frame ) :
+    operation( io, true ),
+    dev( dev ),
+    rest( frame )
+{}
+
+bool frame_write::poll() {
+    if ( !rest.empty() ) {
+        rest = rest.subspan( dev.write( rest ) );
+        if ( !rest.empty() ) {
+            return false;
+        }
+    }
+
+    // A full FIFO rejects the marker, which is retried on the next pass.
+    return dev.end_frame();
+}
+
+// The refill interrupt rises at the almost-empty watermark, long before the FIFO runs empty, and
+// stays raised until it is refilled, so no interrupt marks the drain and it must be polled.
+fifo_drain::fifo_drain( reactor& io, const pw_bit& dev ) :
+    operation( io, false ),
+    dev( dev )
+{}
+
+bool fifo_drain::poll() {
+    return dev.fifo_empty();
+}
@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <cstring>
+
+#include "periph_pw_bit_cache.hpp"
+
+using namespace periph;
+
+namespace {
+
+    /**
+     * Find the end of the last difference between two equally sized buffers.
+     * 
+     * \param[in] lhs  The first buffer.
+     * \param[in] rhs  The second buffer.
+     * \param     size The size of both buffers, in bytes.
+     * 
+     * \return Returns one past the offset of the last differing byte, or zero if the buffers are
+     *         equal.
+     */
+    std::size_t diff_end( const std::byte* lhs, const std::byte* rhs, std::size_t size ) {
+        std::size_t end = size;
+
+        // Static tails are the common case, so compare whole words backwards before narrowing down.
+        for ( ; end >= sizeof( std::uint64_t ); end -= sizeof( std::uint64_t ) ) {
+            std::uint64_t lhs_word;
+            std::uint64_t rhs_word;
+
+            std::memcpy( &lhs_word, lhs + end - sizeof( lhs_word ), sizeof( lhs_word ) );
+            std::memcpy( &rhs_word, rhs + end - sizeof( rhs_word ), sizeof( rhs_word ) );
+            if ( lhs_word != rhs_word ) {
+                break;
+            }
+        }
+
+        for ( ; end > 0; end-- ) {
+            if ( lhs[end - 1] != rhs[end - 1] ) {
+                break;
+            }
+        }
+
+        return end;
+    }
+
+}
+
+frame_cache::frame_cache( std::size_t bytes_per_pixel, bool truncate ) :
+    pixel_size( std::max<std::size_t>( bytes_per_pixel, 1 ) ),
+    truncate( truncate ),
+    valid( false ),
+    last_saved( 0 ),
+    total_saved( 0 )
+{}
+
+std::span<const std::byte> frame_cache::update( std::span<const std::byte> frame ) {
+    std::size_t length = frame.size();
+
+    if ( valid && ( previous.size() == frame.size() ) ) {
+        length = diff_end( previous.data(), frame.data(), frame.size() );
+
+        // Bytes past the last change already match, so only the changed part needs caching.
+        std::copy( frame.begin(), frame.begin() + length, previous.begin() );
+
+        if ( length > 0 ) {
+            length = truncate
+                ? std::min( ( length + pixel_size - 1 ) / pixel_size * pixel_size, frame.size() )
+                : frame.size();
+        }
+    } else {
+        previous.assign( frame.begin(), frame.end() );
+        valid = true;
+    }
+
+    last_saved   = frame.size() - length;
+    total_saved += last_saved;
+
+    return frame.first( length );
+}
+
+void frame_cache::invalidate() {
+    valid = false;
+}
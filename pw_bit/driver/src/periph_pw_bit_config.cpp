@@ -0,0 +1,14 @@
+#include "periph_pw_bit_config.hpp"
+
+namespace periph {
+
+    // The configuration of the 32-bit peripheral behind the pw_bit alias is compiled once, here.
+    template struct basic_pw_bit_config<>;
+
+    static_assert(
+        ( pw_bit_config::preset( pw_bit_protocol::ws2812b, 100'000'000 ).period == 125 ) &&
+        ( pw_bit_config::preset( pw_bit_protocol::ws2812b, 100'000'000 ).duty_1b == 80 ),
+        "Preset timing mismatch"
+    );
+
+}
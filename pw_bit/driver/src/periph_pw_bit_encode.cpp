@@ -0,0 +1,313 @@
+#include <algorithm>
+
+#if defined( __SSE2__ )
+#include <immintrin.h>
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+#include <arm_neon.h>
+#endif
+
+#include "periph_pw_bit_encode.hpp"
+
+using namespace periph;
+
+namespace {
+
+    /**
+     * The source channel of each encoded byte of a pixel.
+     */
+    using swizzle_map = std::array<std::uint8_t,frame_encoder::bytes_per_pixel>;
+
+    /**
+     * The swizzle map of each color order.
+     */
+    constexpr std::array<swizzle_map,6> swizzles = {{
+        { 0, 1, 2 }, // rgb
+        { 0, 2, 1 }, // rbg
+        { 1, 0, 2 }, // grb
+        { 1, 2, 0 }, // gbr
+        { 2, 0, 1 }, // brg
+        { 2, 1, 0 }  // bgr
+    }};
+
+    constexpr std::size_t simd_pixels = 5;   //!< Whole pixels in a 16-byte vector.
+    constexpr std::size_t chunk_size  = 256; //!< Pixels converted from float at a time.
+
+#if defined( __SSE2__ ) || ( defined( __ARM_NEON ) && defined( __aarch64__ ) )
+    /**
+     * Build the byte shuffle reordering the whole pixels of a 16-byte vector.
+     * 
+     * \param swizzle The source channel of each reordered byte.
+     * 
+     * \return Returns the source byte of each byte of the vector; the last byte is cleared.
+     */
+    std::array<std::uint8_t,16> make_shuffle( const swizzle_map& swizzle ) {
+        constexpr std::size_t bpp = frame_encoder::bytes_per_pixel;
+
+        std::array<std::uint8_t,16> shuffle;
+        for ( std::size_t j = 0; j < simd_pixels * bpp; j++ ) {
+            shuffle[j] = ( j / bpp ) * bpp + swizzle[j % bpp];
+        }
+        shuffle[15] = 0x80;
+
+        return shuffle;
+    }
+#endif
+
+#if defined( __SSE2__ )
+    /**
+     * Reorder the channels of a run of pixels with SSSE3, five pixels per vector.
+     * 
+     * Compiled for SSSE3 whatever the target, so it may only be called once the CPU is known to
+     * support it.
+     * 
+     * \param[in]  src        The source pixels.
+     * \param[out] dst        The reordered pixels, which must not overlap \a src.
+     * \param      num_pixels The number of pixels to reorder.
+     * \param      swizzle    The source channel of each reordered byte.
+     * 
+     * \return Returns the number of leading pixels reordered.
+     */
+    __attribute__(( target( "ssse3" ) ))
+    std::size_t reorder_simd(
+        const std::uint8_t* src,
+        std::uint8_t*       dst,
+        std::size_t         num_pixels,
+        const swizzle_map&  swizzle
+    ) {
+        constexpr std::size_t bpp = frame_encoder::bytes_per_pixel;
+
+        const std::array<std::uint8_t,16> shuffle = make_shuffle( swizzle );
+        const __m128i mask = _mm_loadu_si128( reinterpret_cast<const __m128i*>( shuffle.data() ) );
+
+        // Each vector store spills one byte into the next pixel, which the following iteration
+        // overwrites, so stop one pixel short of the end.
+        std::size_t i = 0;
+        for ( ; i + simd_pixels + 1 <= num_pixels; i += simd_pixels ) {
+            const __m128i pixels =
+                _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + bpp * i ) );
+
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>( dst + bpp * i ),
+                _mm_shuffle_epi8( pixels, mask )
+            );
+        }
+
+        return i;
+    }
+
+    /**
+     * Check whether reorder_simd() can run on this CPU.
+     */
+    bool has_reorder_simd() {
+#if defined( __SSSE3__ )
+        return true;
+#else
+        static const bool supported = __builtin_cpu_supports( "ssse3" );
+
+        return supported;
+#endif
+    }
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+    /**
+     * Reorder the channels of a run of pixels with NEON, five pixels per vector.
+     * 
+     * \param[in]  src        The source pixels.
+     * \param[out] dst        The reordered pixels, which must not overlap \a src.
+     * \param      num_pixels The number of pixels to reorder.
+     * \param      swizzle    The source channel of each reordered byte.
+     * 
+     * \return Returns the number of leading pixels reordered.
+     */
+    std::size_t reorder_simd(
+        const std::uint8_t* src,
+        std::uint8_t*       dst,
+        std::size_t         num_pixels,
+        const swizzle_map&  swizzle
+    ) {
+        constexpr std::size_t bpp = frame_encoder::bytes_per_pixel;
+
+        const std::array<std::uint8_t,16> shuffle = make_shuffle( swizzle );
+        const uint8x16_t                  mask    = vld1q_u8( shuffle.data() );
+
+        // Each vector store spills one byte into the next pixel, which the following iteration
+        // overwrites, so stop one pixel short of the end.
+        std::size_t i = 0;
+        for ( ; i + simd_pixels + 1 <= num_pixels; i += simd_pixels ) {
+            vst1q_u8( dst + bpp * i, vqtbl1q_u8( vld1q_u8( src + bpp * i ), mask ) );
+        }
+
+        return i;
+    }
+
+    /**
+     * Check whether reorder_simd() can run on this CPU, which AArch64 always can.
+     */
+    bool has_reorder_simd() {
+        return true;
+    }
+#endif
+
+    /**
+     * Reorder the channels of a run of pixels.
+     * 
+     * \param[in]  src        The source pixels.
+     * \param[out] dst        The reordered pixels, which must not overlap \a src.
+     * \param      num_pixels The number of pixels to reorder.
+     * \param      swizzle    The source channel of each reordered byte.
+     */
+    void reorder(
+        const std::uint8_t* src,
+        std::uint8_t*       dst,
+        std::size_t         num_pixels,
+        const swizzle_map&  swizzle
+    ) {
+        constexpr std::size_t bpp = frame_encoder::bytes_per_pixel;
+
+        std::size_t i = 0;
+
+#if defined( __SSE2__ ) || ( defined( __ARM_NEON ) && defined( __aarch64__ ) )
+        if ( has_reorder_simd() ) {
+            i = reorder_simd( src, dst, num_pixels, swizzle );
+        }
+#endif
+
+        for ( ; i < num_pixels; i++ ) {
+            for ( std::size_t j = 0; j < bpp; j++ ) {
+                dst[bpp * i + j] = src[bpp * i + swizzle[j]];
+            }
+        }
+    }
+
+    /**
+     * Convert intensities from zero to one into 8-bit values, rounding and clamping.
+     * 
+     * Every path computes x * 255 + 0.5, clamps it to [0,255] with NaN mapping to zero, and
+     * truncates, so that a value converts alike wherever it falls in the buffer.
+     * 
+     * \param[in]  src   The intensities to convert.
+     * \param[out] dst   The converted values.
+     * \param      count The number of values to convert.
+     */
+    void quantize( const float* src, std::uint8_t* dst, std::size_t count ) {
+        std::size_t i = 0;
+
+#if defined( __SSE2__ )
+        const __m128 scale = _mm_set1_ps( 255.0f );
+        const __m128 half  = _mm_set1_ps( 0.5f );
+        const __m128 zero  = _mm_setzero_ps();
+
+        // maxps returns its second operand if either is NaN, so NaN clamps to zero.
+        const auto convert = [&]( const float* four ) {
+            const __m128 level = _mm_add_ps( _mm_mul_ps( _mm_loadu_ps( four ), scale ), half );
+
+            return _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( level, zero ), scale ) );
+        };
+
+        for ( ; i + 8 <= count; i += 8 ) {
+            const __m128i lo = convert( src + i );
+            const __m128i hi = convert( src + i + 4 );
+            const __m128i u8 = _mm_packus_epi16( _mm_packs_epi32( lo, hi ), _mm_setzero_si128() );
+
+            _mm_storel_epi64( reinterpret_cast<__m128i*>( dst + i ), u8 );
+        }
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+        const float32x4_t scale = vdupq_n_f32( 255.0f );
+        const float32x4_t half  = vdupq_n_f32( 0.5f );
+        const float32x4_t zero  = vdupq_n_f32( 0.0f );
+
+        // fmaxnm returns the number if one operand is NaN, so NaN clamps to zero.
+        const auto convert = [&]( const float* four ) {
+            const float32x4_t level = vaddq_f32( vmulq_f32( vld1q_f32( four ), scale ), half );
+
+            return vcvtq_s32_f32( vminq_f32( vmaxnmq_f32( level, zero ), scale ) );
+        };
+
+        for ( ; i + 8 <= count; i += 8 ) {
+            const int32x4_t lo = convert( src + i );
+            const int32x4_t hi = convert( src + i + 4 );
+
+            vst1_u8( dst + i, vqmovun_s16( vcombine_s16( vqmovn_s32( lo ), vqmovn_s32( hi ) ) ) );
+        }
+#endif
+
+        for ( ; i < count; i++ ) {
+            const float level = src[i] * 255.0f + 0.5f;
+
+            // Written so that NaN maps to zero.
+            if ( !( level > 0.0f ) ) {
+                dst[i] = 0;
+            } else if ( level >= 255.0f ) {
+                dst[i] = 255;
+            } else {
+                dst[i] = static_cast<std::uint8_t>( level );
+            }
+        }
+    }
+
+}
+
+frame_encoder::frame_encoder( color_order order, const gamma_table& gamma ) :
+    swizzle( swizzles[static_cast<std::size_t>( order )] ),
+    gamma( gamma ),
+    lut{},
+    brightness( 255 ),
+    identity( false )
+{
+    update_lut();
+}
+
+void frame_encoder::set_gamma( const gamma_table& gamma ) {
+    this->gamma = gamma;
+    update_lut();
+}
+
+void frame_encoder::set_brightness( std::uint8_t brightness ) {
+    this->brightness = brightness;
+    update_lut();
+}
+
+std::size_t frame_encoder::encode(
+    std::span<const std::uint8_t> rgb,
+    std::span<std::byte>          out
+) const {
+    const std::size_t num_pixels = std::min( rgb.size(), out.size() ) / bytes_per_pixel;
+    auto*             dst        = reinterpret_cast<std::uint8_t*>( out.data() );
+
+    reorder( rgb.data(), dst, num_pixels, swizzle );
+
+    // The table applies to every channel alike, so it can be applied after reordering.
+    if ( !identity ) {
+        for ( std::size_t i = 0; i < num_pixels * bytes_per_pixel; i++ ) {
+            dst[i] = lut[dst[i]];
+        }
+    }
+
+    return num_pixels;
+}
+
+std::size_t frame_encoder::encode( std::span<const float> rgb, std::span<std::byte> out ) const {
+    const std::size_t num_pixels = std::min( rgb.size(), out.size() ) / bytes_per_pixel;
+
+    std::array<std::uint8_t,chunk_size*bytes_per_pixel> chunk;
+
+    for ( std::size_t i = 0; i < num_pixels; i += chunk_size ) {
+        const std::size_t num_chunk = std::min( chunk_size, num_pixels - i );
+
+        quantize( rgb.data() + i * bytes_per_pixel, chunk.data(), num_chunk * bytes_per_pixel );
+        encode(
+            std::span( chunk.data(), num_chunk * bytes_per_pixel ),
+            out.subspan( i * bytes_per_pixel, num_chunk * bytes_per_pixel )
+        );
+    }
+
+    return num_pixels;
+}
+
+void frame_encoder::update_lut( void ) {
+    identity = true;
+
+    for ( std::size_t i = 0; i < lut.size(); i++ ) {
+        lut[i]   = ( gamma[i] * brightness + 127 ) / 255;
+        identity = identity && ( lut[i] == i );
+    }
+}
@@ -0,0 +1,108 @@
+#include "periph_pw_bit_group.hpp"
+
+using namespace periph;
+
+pw_bit_group::pw_bit_group( std::span<pw_bit* const> channels, std::size_t bytes_per_pixel ) :
+    next( 0 )
+{
+    this->channels.reserve( channels.size() );
+    for ( auto dev : channels ) {
+        const std::size_t count = dev->underruns();
+
+        this->channels.push_back(
+            { dev, {}, 0, false, count, count, frame_cache( bytes_per_pixel ), {} }
+        );
+    }
+}
+
+bool pw_bit_group::submit( std::size_t channel, std::span<const std::byte> frame ) {
+    if ( ( channel >= channels.size() ) || busy( channel ) ) {
+        return false;
+    }
+
+    channels[channel].frame  = frame;
+    channels[channel].queued = 0;
+    channels[channel].framed = !frame.empty();
+    channels[channel].timer.start();
+
+    return true;
+}
+
+bool pw_bit_group::submit_changes( std::size_t channel, std::span<const std::byte> frame ) {
+    if ( ( channel >= channels.size() ) || busy( channel ) ) {
+        return false;
+    }
+
+    return submit( channel, channels[channel].cache.update( frame ) );
+}
+
+void pw_bit_group::invalidate( std::size_t channel ) {
+    if ( channel < channels.size() ) {
+        channels[channel].cache.invalidate();
+    }
+}
+
+std::size_t pw_bit_group::service() {
+    std::size_t pending = 0;
+
+    for ( std::size_t i = 0; i < channels.size(); i++ ) {
+        auto& chan = channels[( next + i ) % channels.size()];
+
+        if ( chan.queued < chan.frame.size() ) {
+            chan.queued += chan.dev->write( chan.frame.subspan( chan.queued ) );
+        }
+
+        // The marker goes in as soon as the whole frame is queued, so the reset gap starts
+        // right after the frame while the next frame can already be queued behind it. The frame
+        // is flushed once, at its boundary.
+        if ( ( chan.queued == chan.frame.size() ) && chan.framed && chan.dev->end_frame() ) {
+            chan.dev->flush();
+            chan.framed = false;
+            chan.timer.stop( chan.dev );
+
+            // The hardware counter is polled once per frame, to report new underruns to tracing.
+            const std::size_t count = chan.dev->underruns();
+            for ( ; chan.underruns_seen < count; chan.underruns_seen++ ) {
+                trace::on_underrun( chan.dev );
+            }
+            chan.underruns_seen = count;
+        }
+
+        if ( ( chan.queued < chan.frame.size() ) || chan.framed ) {
+            pending++;
+        }
+    }
+
+    // Rotate the starting channel so no channel is systematically refilled last.
+    if ( !channels.empty() ) {
+        next = ( next + 1 ) % channels.size();
+    }
+
+    return pending;
+}
+
+void pw_bit_group::run() {
+    while ( service() > 0 );
+}
+
+bool pw_bit_group::busy( std::size_t channel ) const {
+    return ( channel < channels.size() )
+        && ( ( channels[channel].queued < channels[channel].frame.size() )
+          || channels[channel].framed );
+}
+
+std::size_t pw_bit_group::underruns( std::size_t channel ) const {
+    if ( channel >= channels.size() ) {
+        return 0;
+    }
+
+    const auto&       chan  = channels[channel];
+    const std::size_t count = chan.dev->underruns();
+
+    // Counters cleared since the group was created count from zero again.
+    return ( count >= chan.underruns_base ) ? ( count - chan.underruns_base ) : count;
+}
+
+std::size_t pw_bit_group::bytes_saved( std::size_t channel ) const {
+    return ( channel < channels.size() ) ? channels[channel].cache.bytes_saved() : 0;
+}
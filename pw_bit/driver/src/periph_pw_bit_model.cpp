@@ -0,0 +1,343 @@
+#include <algorithm>
+#include <string>
+
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "periph_pw_bit_model.hpp"
+
+using namespace periph;
+using namespace periph::sim;
+
+namespace {
+
+    constexpr std::size_t reg_data   = 0; //!< Index of the data FIFO write register of an output.
+    constexpr std::size_t reg_mask   = 1; //!< Index of the byte mask register of an output.
+    constexpr std::size_t reg_gap    = 2; //!< Index of the reset gap register of an output.
+    constexpr std::size_t reg_id     = 3; //!< Index of the identification register of an output.
+    constexpr std::size_t reg_period = 4; //!< Index of the bit period register of an output.
+    constexpr std::size_t reg_duty_1 = 5; //!< Index of the 1-bit duty time register of an output.
+    constexpr std::size_t reg_duty_0 = 6; //!< Index of the 0-bit duty time register of an output.
+    constexpr std::size_t reg_cfg    = 7; //!< Index of the configuration register of an output.
+
+    constexpr std::uint32_t cfg_rst_bit          = 0x00000001; //!< Enable bit of the cfg register.
+    constexpr std::uint32_t cfg_empty_bit        = 0x00000002; //!< FIFO empty bit.
+    constexpr std::uint32_t cfg_full_bit         = 0x00000004; //!< FIFO full bit.
+    constexpr std::uint32_t cfg_almost_empty_bit = 0x00000008; //!< FIFO almost empty bit.
+    constexpr std::uint32_t cfg_almost_full_bit  = 0x00000010; //!< FIFO almost full bit.
+    constexpr std::uint32_t cfg_refill_irq_bit   = 0x00000020; //!< Refill interrupt enable bit.
+    constexpr std::uint32_t cfg_clear_bit        = 0x00000040; //!< Counter clear bit, reads zero.
+    constexpr std::uint32_t cfg_counter_bits     = 0xFFFF0000; //!< Both error counters.
+    constexpr std::uint32_t cfg_status_bits      = 0xFFFF005E; //!< All bits driven by the model.
+    constexpr std::size_t   cfg_overflows_shift  = 16;         //!< Overflow count LSB.
+    constexpr std::size_t   cfg_underruns_shift  = 24;         //!< Underrun count LSB.
+
+    constexpr std::uint32_t word_byte_mask = 0x0000000F; //!< Mask of all word bytes.
+    constexpr std::uint32_t eof_marker     = 0x00000001; //!< End-of-frame word data.
+
+}
+
+pw_bit_model::pw_bit_model( std::uint64_t clock_hz ) :
+    model( &regs, sizeof( regs ), clock_hz ),
+    regs{},
+    outputs{},
+    irq_timer( ::timerfd_create( CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC ) ),
+    irq_armed( irq_never ),
+    irq_state( false ),
+    vcd( nullptr ),
+    traces{}
+{
+    for ( std::size_t i = 0; i < num_outputs; i++ ) {
+        regs[i * output_regs + reg_id] = encode_id( {
+            device_type::pw_bit, device_traits<pw_bit>::version, fifo_depth, i, num_outputs, 0
+        } );
+    }
+
+    run( 0 );
+}
+
+pw_bit_model::~pw_bit_model() {
+    if ( irq_timer >= 0 ) {
+        ::close( irq_timer );
+    }
+}
+
+pw_bit& pw_bit_model::output( std::size_t index ) {
+    return *reinterpret_cast<pw_bit*>( const_cast<std::uint32_t*>( &regs[index * output_regs] ) );
+}
+
+void pw_bit_model::set_vcd( vcd_writer* writer ) {
+    vcd = writer;
+    if ( vcd == nullptr ) {
+        return;
+    }
+
+    for ( std::size_t i = 0; i < num_outputs; i++ ) {
+        traces[i] = vcd->add( "txd" + std::to_string( i ) );
+    }
+}
+
+std::vector<std::uint8_t> pw_bit_model::take_transmitted( std::size_t index ) {
+    std::vector<std::uint8_t> bytes;
+    bytes.swap( outputs[index].transmitted );
+
+    return bytes;
+}
+
+void pw_bit_model::run( std::uint64_t num_cycles ) {
+    bool irq_next = false;
+
+    for ( std::size_t i = 0; i < num_outputs; i++ ) {
+        if ( regs[i * output_regs + reg_cfg] & cfg_clear_bit ) {
+            outputs[i].overflows = 0;
+            outputs[i].underruns = 0;
+        }
+    }
+
+    // Recorded lines must be sampled in time order across all outputs, so the outputs are
+    // simulated together, one cycle at a time.
+    if ( vcd != nullptr ) {
+        for ( std::uint64_t cycle = 0; cycle < num_cycles; cycle++ ) {
+            for ( std::size_t i = 0; i < num_outputs; i++ ) {
+                outputs[i].line = false;
+                run_output( i, 1 );
+                vcd->change( now() + cycle, traces[i], outputs[i].line );
+            }
+        }
+    } else {
+        for ( std::size_t i = 0; i < num_outputs; i++ ) {
+            run_output( i, num_cycles );
+        }
+    }
+
+    for ( std::size_t i = 0; i < num_outputs; i++ ) {
+        auto& out = outputs[i];
+        auto& cfg = regs[i * output_regs + reg_cfg];
+
+        const std::size_t level = out.fifo.size();
+
+        std::uint32_t status = 0;
+        if ( level == 0 ) {
+            status |= cfg_empty_bit;
+        }
+        if ( level == fifo_depth ) {
+            status |= cfg_full_bit;
+        }
+        if ( level <= fifo_watermark ) {
+            status |= cfg_almost_empty_bit;
+        }
+        if ( level >= fifo_depth - fifo_watermark ) {
+            status |= cfg_almost_full_bit;
+        }
+        status |= ( out.overflows << cfg_overflows_shift ) & cfg_counter_bits;
+        status |= ( out.underruns << cfg_underruns_shift ) & cfg_counter_bits;
+        cfg = ( cfg & ~cfg_status_bits ) | status;
+
+        regs[i * output_regs + reg_data] = level;
+
+        const std::uint32_t irq_bits = cfg_rst_bit | cfg_refill_irq_bit | cfg_almost_empty_bit;
+        irq_next = irq_next || ( ( cfg & irq_bits ) == irq_bits );
+    }
+
+    // While the interrupt is low, the timer is set to the earliest predicted watermark crossing,
+    // which only a model running in real time reaches without being accessed.
+    if ( irq_next ) {
+        if ( !irq_state ) {
+            arm_irq( irq_now );
+        }
+    } else {
+        std::uint64_t next = irq_never;
+        if ( time_of( 0 ) != clock::time_point::max() ) {
+            const std::uint32_t irq_enable_bits = cfg_rst_bit | cfg_refill_irq_bit;
+            for ( std::size_t i = 0; i < num_outputs; i++ ) {
+                if ( ( regs[i * output_regs + reg_cfg] & irq_enable_bits ) == irq_enable_bits ) {
+                    next = std::min( next, now() + num_cycles + cycles_to_refill( i ) );
+                }
+            }
+        }
+        arm_irq( next );
+    }
+    irq_state = irq_next;
+}
+
+void pw_bit_model::write_fifo( std::size_t offset, std::uint32_t data ) {
+    const std::size_t index = offset / block_size;
+    const std::size_t reg   = ( offset % block_size ) / sizeof( std::uint32_t );
+    auto&             out   = outputs[index];
+
+    // A disabled output holds its FIFO in reset, and a full FIFO drops the write.
+    if ( ( reg != reg_data ) || !( regs[index * output_regs + reg_cfg] & cfg_rst_bit ) ) {
+        return;
+    }
+
+    // The only word without active bytes that is queued is the end-of-frame marker.
+    const std::uint32_t mask = regs[index * output_regs + reg_mask] & word_byte_mask;
+    if ( ( mask == 0 ) && ( data != eof_marker ) ) {
+        return;
+    }
+
+    if ( out.fifo.size() >= fifo_depth ) {
+        out.overflows = std::min<std::uint32_t>( out.overflows + 1, error_count_max );
+        run( 0 );
+        return;
+    }
+
+    push_word( out, { data, mask, mask == 0 } );
+    run( 0 );
+}
+
+bool pw_bit_model::push( std::uint32_t dest, std::uint32_t data, std::uint32_t keep, bool last ) {
+    // Beats for nonexistent or disabled outputs are dropped rather than stalling the stream.
+    if ( ( dest >= num_outputs ) || !( regs[dest * output_regs + reg_cfg] & cfg_rst_bit ) ) {
+        return true;
+    }
+
+    // A beat ending a frame is followed by an end-of-frame marker, so it needs room for both.
+    auto& out = outputs[dest];
+    if ( out.fifo.size() + ( last ? 1 : 0 ) >= fifo_depth ) {
+        return false;
+    }
+
+    // A beat without active bytes only ends the frame, if it has TLAST set.
+    if ( ( keep & word_byte_mask ) != 0 ) {
+        push_word( out, { data, keep & word_byte_mask, false } );
+    }
+    if ( last ) {
+        push_word( out, { eof_marker, 0, true } );
+    }
+    run( 0 );
+
+    return true;
+}
+
+void pw_bit_model::run_output( std::size_t index, std::uint64_t num_cycles ) {
+    auto& out = outputs[index];
+
+    if ( !( regs[index * output_regs + reg_cfg] & cfg_rst_bit ) ) {
+        out.fifo.clear();
+        out.ahead     = {};
+        out.cell      = {};
+        out.gap       = 0;
+        out.in_frame  = false;
+        out.starved   = false;
+        return;
+    }
+
+    while ( true ) {
+        // The next word leaves the FIFO as soon as the previous one and any reset gap after it
+        // are over.
+        if ( !out.cell.busy() ) {
+            const std::uint64_t gap_step = std::min( num_cycles, out.gap );
+            out.gap    -= gap_step;
+            num_cycles -= gap_step;
+
+            if ( out.gap > 0 ) {
+                return;
+            }
+            if ( out.fifo.empty() ) {
+                if ( out.in_frame && !out.starved ) {
+                    out.underruns = std::min<std::uint32_t>( out.underruns + 1, error_count_max );
+                    out.starved   = true;
+                }
+                return;
+            }
+
+            out.current = pop_word( out );
+            out.cell.load(
+                out.current.data,
+                out.current.mask,
+                regs[index * output_regs + reg_period]
+            );
+            out.in_frame = !out.current.last;
+            out.starved  = false;
+        }
+
+        if ( num_cycles == 0 ) {
+            return;
+        }
+
+        out.line = out.cell.txd(
+            regs[index * output_regs + reg_duty_1],
+            regs[index * output_regs + reg_duty_0]
+        );
+        num_cycles -= out.cell.advance( num_cycles );
+
+        if ( !out.cell.busy() ) {
+            for ( std::size_t j = 0; j < sizeof( std::uint32_t ); j++ ) {
+                if ( out.current.mask & ( 1u << j ) ) {
+                    out.transmitted.push_back( out.current.data >> ( 8 * j ) );
+                }
+            }
+            if ( out.current.last ) {
+                out.gap = regs[index * output_regs + reg_gap];
+            }
+        }
+    }
+}
+
+void pw_bit_model::push_word( output_state& out, const fifo_word& word ) {
+    out.fifo.push_back( word );
+    if ( out.fifo.size() > fifo_watermark + 1 ) {
+        out.ahead.add( out.fifo[out.fifo.size() - fifo_watermark - 2], 1 );
+    }
+}
+
+pw_bit_model::fifo_word pw_bit_model::pop_word( output_state& out ) {
+    const fifo_word word = out.fifo.front();
+
+    if ( out.fifo.size() > fifo_watermark + 1 ) {
+        out.ahead.add( word, -1 );
+    }
+    out.fifo.pop_front();
+
+    return word;
+}
+
+std::uint64_t pw_bit_model::cycles_to_refill( std::size_t index ) const {
+    const auto&         out    = outputs[index];
+    const std::size_t   level  = out.fifo.size();
+    const std::uint64_t period = regs[index * output_regs + reg_period];
+    const std::uint64_t gap    = regs[index * output_regs + reg_gap];
+
+    if ( level <= fifo_watermark ) {
+        return 0;
+    }
+
+    // Words leave the FIFO as their transmission starts, so the first one leaves once the word
+    // being transmitted and the reset gap after it are over, and each further one a word later.
+    // The FIFO is almost empty once all words but the last fifo_watermark + 1 have left.
+    const word_tally& ahead  = out.ahead;
+    std::uint64_t     cycles = out.cell.busy()
+                             ? out.cell.remaining() + ( out.current.last ? gap : 0 )
+                             : out.gap;
+
+    cycles += ( period == 0 ) ? ahead.words : ( 8 * period * ahead.bytes + ahead.empty );
+    cycles += gap * ahead.marks;
+
+    return cycles;
+}
+
+void pw_bit_model::arm_irq( std::uint64_t cycle ) {
+    if ( ( irq_timer < 0 ) || ( cycle == irq_armed ) ) {
+        return;
+    }
+
+    // An all-zero setting disarms the timer and withdraws any expiration not yet read, and an
+    // absolute time in the past expires right away.
+    itimerspec setting{};
+    if ( cycle == irq_now ) {
+        setting.it_value.tv_nsec = 1;
+    } else if ( cycle != irq_never ) {
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            time_of( cycle ).time_since_epoch()
+        ).count();
+
+        setting.it_value.tv_sec  = ns / 1000000000;
+        setting.it_value.tv_nsec = ns % 1000000000;
+    }
+
+    // On failure the timer is left as it was, and setting it is retried on the next update.
+    if ( ::timerfd_settime( irq_timer, TFD_TIMER_ABSTIME, &setting, nullptr ) == 0 ) {
+        irq_armed = cycle;
+    }
+}
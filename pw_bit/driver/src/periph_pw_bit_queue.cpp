@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <thread>
+
+#include "periph_pw_bit_queue.hpp"
+
+using namespace periph;
+
+namespace {
+
+    /**
+     * Read a monotonic timestamp.
+     * 
+     * \return Returns the current time, in nanoseconds.
+     */
+    std::uint64_t now_ns( void ) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    /**
+     * Raise an atomic maximum.
+     * 
+     * \param[in,out] max   The maximum to raise.
+     * \param         value The value to raise the maximum to, if larger.
+     */
+    void raise_max( std::atomic<std::uint64_t>& max, std::uint64_t value ) {
+        std::uint64_t current = max.load( std::memory_order_relaxed );
+
+        while ( ( value > current )
+             && !max.compare_exchange_weak( current, value, std::memory_order_relaxed ) );
+    }
+
+    /**
+     * Release a frame, if it has a release callback.
+     * 
+     * \param desc The frame to release.
+     * \param sent Whether the frame was queued in the peripheral.
+     */
+    void release( const frame_desc& desc, bool sent ) {
+        if ( desc.release != nullptr ) {
+            desc.release( desc.context, sent );
+        }
+    }
+
+}
+
+frame_queue::frame_queue( std::size_t capacity, queue_policy policy ) :
+    slots( std::bit_ceil( std::max<std::size_t>( capacity, 1 ) ) ),
+    mask( slots.size() - 1 ),
+    policy( policy ),
+    tail( 0 ),
+    head( 0 ),
+    count{}
+{
+    for ( std::size_t i = 0; i < slots.size(); i++ ) {
+        slots[i].sequence.store( i, std::memory_order_relaxed );
+    }
+}
+
+bool frame_queue::push( const frame_desc& desc ) {
+    const std::uint64_t start = now_ns();
+
+    bool queued = try_push( desc, start );
+
+    // Dropping is done by the producer itself, as a second consumer, so that the consumer thread
+    // never has to be waited for. Another producer may take the freed slot first, so retry.
+    while ( !queued && ( policy == queue_policy::drop_oldest ) ) {
+        frame_desc    oldest;
+        std::uint64_t stamp;
+        if ( take( oldest, stamp ) ) {
+            count.dropped.fetch_add( 1, std::memory_order_relaxed );
+            release( oldest, false );
+        }
+
+        queued = try_push( desc, start );
+    }
+
+    if ( !queued ) {
+        count.rejected.fetch_add( 1, std::memory_order_relaxed );
+        return false;
+    }
+
+    const std::uint64_t elapsed = now_ns() - start;
+
+    count.pushed.fetch_add( 1, std::memory_order_relaxed );
+    count.push_ns.fetch_add( elapsed, std::memory_order_relaxed );
+    raise_max( count.push_ns_max, elapsed );
+
+    return true;
+}
+
+bool frame_queue::pop( frame_desc& desc ) {
+    std::uint64_t stamp;
+    if ( !take( desc, stamp ) ) {
+        return false;
+    }
+
+    const std::uint64_t waited = now_ns() - stamp;
+
+    count.popped.fetch_add( 1, std::memory_order_relaxed );
+    count.wait_ns.fetch_add( waited, std::memory_order_relaxed );
+    raise_max( count.wait_ns_max, waited );
+
+    return true;
+}
+
+queue_stats frame_queue::stats() const {
+    return {
+        count.pushed.load( std::memory_order_relaxed ),
+        count.rejected.load( std::memory_order_relaxed ),
+        count.dropped.load( std::memory_order_relaxed ),
+        count.popped.load( std::memory_order_relaxed ),
+        count.push_ns.load( std::memory_order_relaxed ),
+        count.push_ns_max.load( std::memory_order_relaxed ),
+        count.wait_ns.load( std::memory_order_relaxed ),
+        count.wait_ns_max.load( std::memory_order_relaxed )
+    };
+}
+
+bool frame_queue::try_push( const frame_desc& desc, std::uint64_t stamp ) {
+    std::size_t pos = tail.load( std::memory_order_relaxed );
+    slot*       cell;
+
+    for ( ;; ) {
+        cell = &slots[pos & mask];
+
+        const std::size_t seq  = cell->sequence.load( std::memory_order_acquire );
+        const auto        diff = static_cast<std::ptrdiff_t>( seq - pos );
+
+        if ( diff == 0 ) {
+            if ( tail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+                break;
+            }
+        } else if ( diff < 0 ) {
+            return false;
+        } else {
+            pos = tail.load( std::memory_order_relaxed );
+        }
+    }
+
+    cell->desc  = desc;
+    cell->stamp = stamp;
+    cell->sequence.store( pos + 1, std::memory_order_release );
+
+    return true;
+}
+
+bool frame_queue::take( frame_desc& desc, std::uint64_t& stamp ) {
+    std::size_t pos = head.load( std::memory_order_relaxed );
+    slot*       cell;
+
+    for ( ;; ) {
+        cell = &slots[pos & mask];
+
+        const std::size_t seq  = cell->sequence.load( std::memory_order_acquire );
+        const auto        diff = static_cast<std::ptrdiff_t>( seq - ( pos + 1 ) );
+
+        if ( diff == 0 ) {
+            if ( head.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+                break;
+            }
+        } else if ( diff < 0 ) {
+            return false;
+        } else {
+            pos = head.load( std::memory_order_relaxed );
+        }
+    }
+
+    desc  = cell->desc;
+    stamp = cell->stamp;
+
+    // Hand the slot back to producers one lap ahead.
+    cell->sequence.store( pos + mask + 1, std::memory_order_release );
+
+    return true;
+}
+
+pw_bit_dispatcher::pw_bit_dispatcher(
+    std::span<pw_bit* const> channels,
+    std::size_t              depth,
+    queue_policy             policy
+) :
+    group( channels ),
+    current( channels.size() ),
+    inflight( channels.size(), false )
+{
+    queues.reserve( channels.size() );
+    for ( std::size_t i = 0; i < channels.size(); i++ ) {
+        queues.push_back( std::make_unique<frame_queue>( depth, policy ) );
+    }
+}
+
+bool pw_bit_dispatcher::push( std::size_t channel, const frame_desc& desc ) {
+    return ( channel < queues.size() ) && queues[channel]->push( desc );
+}
+
+std::size_t pw_bit_dispatcher::service() {
+    std::size_t active = 0;
+
+    for ( std::size_t i = 0; i < queues.size(); i++ ) {
+        // Once the whole frame is in the peripheral, its buffer is no longer needed.
+        if ( inflight[i] && !group.busy( i ) ) {
+            release( current[i], true );
+            inflight[i] = false;
+        }
+
+        if ( !inflight[i] && queues[i]->pop( current[i] ) ) {
+            inflight[i] = group.submit( i, current[i].frame );
+            if ( !inflight[i] ) {
+                release( current[i], false );
+            }
+        }
+
+        if ( inflight[i] ) {
+            active++;
+        }
+    }
+
+    group.service();
+
+    return active;
+}
+
+void pw_bit_dispatcher::run( std::stop_token stop ) {
+    while ( !stop.stop_requested() ) {
+        if ( service() == 0 ) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+queue_stats pw_bit_dispatcher::stats( std::size_t channel ) const {
+    return ( channel < queues.size() ) ? queues[channel]->stats() : queue_stats{};
+}
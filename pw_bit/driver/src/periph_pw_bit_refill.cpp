@@ -0,0 +1,51 @@
+#include "periph_pw_bit_refill.hpp"
+
+using namespace periph;
+
+pw_bit_refill::pw_bit_refill( pw_bit& dev, int event_fd, event_kind kind ) :
+    dev( dev ),
+    fd( event_fd ),
+    kind( kind ),
+    num_wakeups( 0 )
+{
+    dev.set_refill_irq( true );
+}
+
+pw_bit_refill::~pw_bit_refill() {
+    dev.set_refill_irq( false );
+}
+
+std::size_t pw_bit_refill::stream( std::span<const std::byte> data, int timeout_ms ) {
+    std::size_t queued = 0;
+
+    while ( true ) {
+        queued += dev.write( data.subspan( queued ) );
+        if ( queued == data.size() ) {
+            return queued;
+        }
+
+        if ( !wait( timeout_ms ) ) {
+            return queued;
+        }
+
+        // The interrupt fires at the almost-empty watermark, so waking to an empty FIFO means the
+        // wakeup came too late. Only checked when instrumented, as it costs a register read.
+        if constexpr ( trace::enabled ) {
+            if ( dev.fifo_empty() ) {
+                trace::on_underrun( &dev );
+            }
+        }
+    }
+}
+
+bool pw_bit_refill::wait( int timeout_ms ) {
+    pollfd pfd = { fd, POLLIN, 0 };
+
+    if ( wait_irq( std::span( &pfd, 1 ), std::span( &kind, 1 ), timeout_ms ) == 0 ) {
+        return false;
+    }
+
+    num_wakeups++;
+
+    return true;
+}
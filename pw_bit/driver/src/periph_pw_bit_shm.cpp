@@ -0,0 +1,191 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <new>
+
+#include "periph_pw_bit_shm.hpp"
+
+using namespace periph;
+
+namespace {
+
+    constexpr std::uint64_t frame_buffer_magic = 0x5042'5746'0001'0000; //!< "PWBF", version 1.0.
+    constexpr std::size_t   slot_alignment     = 64;                    //!< A cache line.
+    constexpr std::uint32_t slot_mask          = 0x3;                   //!< The slot index bits.
+    constexpr std::uint32_t fresh              = 0x4;                   //!< An unread frame.
+
+    /**
+     * Round a size up to a whole number of cache lines.
+     * 
+     * \param bytes The size to round up.
+     * 
+     * \return Returns the rounded size.
+     */
+    constexpr std::size_t align_slot( std::size_t bytes ) {
+        return ( bytes + slot_alignment - 1 ) / slot_alignment * slot_alignment;
+    }
+
+}
+
+/**
+ * The control block at the start of the shared memory, followed by the frame slots.
+ * 
+ * Each side's slot index sits on a cache line of its own, so that only the exchange of the latest
+ * slot index is shared between the processes.
+ */
+struct shared_frame_buffer::layout {
+    std::uint64_t magic;    //!< Identifies an initialized frame buffer.
+    std::uint64_t capacity; //!< The size of each frame slot, in bytes.
+    std::uint64_t stride;   //!< The distance between frame slots, in bytes.
+
+    //! The latest slot, with the fresh bit set until the feeder takes its frame.
+    alignas( slot_alignment ) std::atomic<std::uint32_t> latest;
+
+    alignas( slot_alignment ) std::uint32_t      back;    //!< The producer's slot.
+    std::array<std::uint64_t,frame_buffer_slots> lengths; //!< The frame length of each slot.
+
+    alignas( slot_alignment ) std::uint32_t front; //!< The feeder's slot.
+};
+
+static_assert(
+    std::atomic<std::uint32_t>::is_always_lock_free,
+    "the latest slot index must be lock-free to be shared between processes"
+);
+
+shared_frame_buffer::shared_frame_buffer( std::size_t capacity ) :
+    header( nullptr ),
+    slots( nullptr ),
+    size( align_slot( sizeof( layout ) ) + frame_buffer_slots * align_slot( capacity ) ),
+    file( ::memfd_create( "periph_frames", MFD_CLOEXEC ) )
+{
+    if ( ( file < 0 ) || ( capacity == 0 ) || ( ::ftruncate( file, off_t( size ) ) != 0 ) ) {
+        return;
+    }
+    if ( !map( true ) ) {
+        return;
+    }
+
+    header->capacity = capacity;
+    header->stride   = align_slot( capacity );
+    header->back     = 0;
+    header->lengths  = {};
+    header->front    = 2;
+    header->latest.store( 1, std::memory_order_relaxed );
+
+    // Written last, so a process mapping the buffer early sees no frame buffer rather than a torn
+    // one.
+    std::atomic_ref( header->magic ).store( frame_buffer_magic, std::memory_order_release );
+}
+
+shared_frame_buffer::shared_frame_buffer( const char* path ) :
+    header( nullptr ),
+    slots( nullptr ),
+    size( 0 ),
+    file( ::open( path, O_RDWR | O_CLOEXEC ) )
+{
+    struct stat info;
+    if ( ( file < 0 ) || ( ::fstat( file, &info ) != 0 ) ) {
+        return;
+    }
+
+    size = std::size_t( info.st_size );
+    if ( size < align_slot( sizeof( layout ) ) ) {
+        return;
+    }
+
+    map( false );
+}
+
+shared_frame_buffer::~shared_frame_buffer() {
+    if ( header != nullptr ) {
+        ::munmap( header, size );
+    }
+    if ( file >= 0 ) {
+        ::close( file );
+    }
+}
+
+std::size_t shared_frame_buffer::capacity() const {
+    return valid() ? std::size_t( header->capacity ) : 0;
+}
+
+std::span<std::byte> shared_frame_buffer::back() {
+    return { slot( header->back ), std::size_t( header->capacity ) };
+}
+
+void shared_frame_buffer::publish( std::size_t length ) {
+    header->lengths[header->back] = std::min<std::uint64_t>( length, header->capacity );
+
+    // Releases the frame to the feeder, and acquires the slot the feeder released, if any.
+    const std::uint32_t previous =
+        header->latest.exchange( header->back | fresh, std::memory_order_acq_rel );
+
+    header->back = previous & slot_mask;
+}
+
+std::span<const std::byte> shared_frame_buffer::acquire() {
+    if ( ( header->latest.load( std::memory_order_relaxed ) & fresh ) == 0 ) {
+        return {};
+    }
+
+    // Only the producer sets the fresh bit, so it is still set, though the slot may have moved on.
+    const std::uint32_t latest =
+        header->latest.exchange( header->front, std::memory_order_acq_rel );
+
+    header->front = latest & slot_mask;
+
+    return { slot( header->front ), std::size_t( header->lengths[header->front] ) };
+}
+
+bool shared_frame_buffer::feed( pw_bit_group& group, std::size_t channel ) {
+    if ( ( channel >= group.size() ) || group.busy( channel ) ) {
+        return false;
+    }
+
+    const auto frame = acquire();
+
+    return !frame.empty() && group.submit( channel, frame );
+}
+
+bool shared_frame_buffer::map( bool create ) {
+    void* addr = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0 );
+    if ( addr == MAP_FAILED ) {
+        return false;
+    }
+
+    auto* block = create ? new( addr ) layout{} : static_cast<layout*>( addr );
+
+    if ( !create ) {
+        const std::uint64_t magic =
+            std::atomic_ref( block->magic ).load( std::memory_order_acquire );
+        const std::uint32_t latest = block->latest.load( std::memory_order_acquire );
+        const std::uint32_t owned  = ( block->back < frame_buffer_slots ) &&
+                                     ( block->front < frame_buffer_slots ) ?
+            ( ( 1u << block->back ) | ( 1u << block->front ) | ( 1u << ( latest & slot_mask ) ) ) :
+            0;
+
+        const bool intact = ( magic == frame_buffer_magic ) && ( block->capacity > 0 ) &&
+            ( block->stride == align_slot( block->capacity ) ) &&
+            ( size >= align_slot( sizeof( layout ) ) + frame_buffer_slots * block->stride ) &&
+            ( owned == ( 1u << frame_buffer_slots ) - 1 );
+
+        if ( !intact ) {
+            ::munmap( addr, size );
+            return false;
+        }
+    }
+
+    header = block;
+    slots  = static_cast<std::byte*>( addr ) + align_slot( sizeof( layout ) );
+
+    return true;
+}
+
+std::byte* shared_frame_buffer::slot( std::uint32_t index ) const {
+    return slots + std::size_t( index ) * header->stride;
+}
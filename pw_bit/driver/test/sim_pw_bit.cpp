@@ -0,0 +1,769 @@
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include "periph_check.hpp"
+#include "periph_dma.hpp"
+#include "periph_dma_model.hpp"
+#include "periph_pw_bit.hpp"
+#include "periph_pw_bit_async.hpp"
+#include "periph_pw_bit_cache.hpp"
+#include "periph_pw_bit_cell.hpp"
+#include "periph_pw_bit_config.hpp"
+#include "periph_pw_bit_encode.hpp"
+#include "periph_pw_bit_group.hpp"
+#include "periph_pw_bit_model.hpp"
+#include "periph_pw_bit_queue.hpp"
+#include "periph_pw_bit_refill.hpp"
+#include "periph_pw_bit_shm.hpp"
+#include "periph_reactor.hpp"
+
+using namespace periph;
+
+namespace {
+
+    constexpr std::size_t fifo_bytes = fifo_depth * pw_bit::word_bytes; //!< FIFO size, in bytes.
+
+    /**
+     * A fast bit timing, so that frames take few simulated cycles.
+     */
+    constexpr pw_bit_config fast_config = [] {
+        pw_bit_config config;
+        config.active_bytes = 4;
+        config.reset_gap    = 16;
+        config.period       = 4;
+        config.duty_1b      = 3;
+        config.duty_0b      = 1;
+
+        return config;
+    }();
+
+    /**
+     * Build a frame of recognizable bytes.
+     */
+    std::vector<std::byte> make_frame( std::size_t size, std::uint8_t seed ) {
+        std::vector<std::byte> frame( size );
+        for ( std::size_t i = 0; i < size; i++ ) {
+            frame[i] = static_cast<std::byte>( seed + i * 7 );
+        }
+
+        return frame;
+    }
+
+    /**
+     * Check that an output transmitted exactly the given bytes.
+     */
+    bool transmitted(
+        sim::pw_bit_model&         model,
+        std::size_t                index,
+        std::span<const std::byte> bytes
+    ) {
+        const std::vector<std::uint8_t> sent = model.take_transmitted( index );
+
+        return std::equal(
+            sent.begin(), sent.end(),
+            bytes.begin(), bytes.end(),
+            []( std::uint8_t a, std::byte b ) { return a == static_cast<std::uint8_t>( b ); }
+        );
+    }
+
+    void test_cell() {
+        sim::pw_bit_cell cell;
+
+        // A word takes eight bit periods per strobed byte, and shifts the MSB out first.
+        cell.load( 0x00008000, 0x2, 10 );
+        PERIPH_CHECK( cell.busy() );
+        PERIPH_CHECK( cell.remaining() == 80 );
+
+        std::array<int,8> high{};
+        for ( std::size_t bit = 0; bit < high.size(); bit++ ) {
+            for ( int cycle = 0; cycle < 10; cycle++ ) {
+                high[bit] += cell.txd( 6, 3 ) ? 1 : 0;
+                cell.advance( 1 );
+            }
+        }
+        PERIPH_CHECK( ( high == std::array<int,8>{ 6, 3, 3, 3, 3, 3, 3, 3 } ) );
+        PERIPH_CHECK( !cell.busy() );
+        PERIPH_CHECK( !cell.txd( 6, 3 ) );
+
+        // A word with no strobed bytes takes a single cycle and keeps the line low.
+        cell.load( 0x00000001, 0x0, 10 );
+        PERIPH_CHECK( !cell.txd( 6, 3 ) );
+        PERIPH_CHECK( cell.advance( 100 ) == 1 );
+        PERIPH_CHECK( !cell.busy() );
+    }
+
+    void test_config() {
+        constexpr auto ws2812b = pw_bit_config::preset( pw_bit_protocol::ws2812b, 100'000'000 );
+        constexpr auto sk6812  = pw_bit_config::preset( pw_bit_protocol::sk6812, 100'000'000 );
+
+        static_assert( ws2812b.period == 125 );
+        static_assert( ws2812b.duty_1b == 80 );
+        static_assert( ws2812b.duty_0b == 40 );
+        static_assert( ws2812b.reset_gap == 28000 );
+        static_assert( ws2812b.active_bytes == 3 );
+        static_assert( sk6812.duty_1b == 60 );
+
+        sim::pw_bit_model           model;
+        const std::array<pw_bit*,2> channels = { &model.output( 0 ), &model.output( 1 ) };
+
+        const std::size_t full = ws2812b.apply( channels );
+        PERIPH_CHECK( full > 0 );
+        PERIPH_CHECK( ws2812b.apply( channels, ws2812b ) == 0 );
+
+        // Only the registers that differ are written, fewer than for a full configuration.
+        const std::size_t partial = sk6812.apply( channels, ws2812b );
+        PERIPH_CHECK( partial > 0 );
+        PERIPH_CHECK( partial < full );
+
+        pw_bit_config bad = ws2812b;
+        bad.active_bytes = 5;
+        PERIPH_CHECK( bad.apply( channels ) == 0 );
+        bad.active_bytes = 0;
+        PERIPH_CHECK( bad.apply( channels ) == 0 );
+        PERIPH_CHECK( bad.apply( channels, ws2812b ) == 0 );
+
+        // Words without active bytes are reserved for the end of frame marker, so asking for
+        // none is ignored, and a configured output transmits with the configured byte count.
+        model.output( 0 ).set_active_bytes( 0 );
+        const std::vector<std::byte> frame = make_frame( 6, 1 );
+        PERIPH_CHECK( model.output( 0 ).write( frame ) == frame.size() );
+        model.advance( 6 * 8 * 125 + 1 );
+        PERIPH_CHECK( transmitted( model, 0, frame ) );
+    }
+
+    void test_reorder() {
+        const frame_encoder encoder( color_order::brg, gamma_linear );
+
+        std::vector<std::uint8_t> rgb( 3 * 41 );
+        for ( std::size_t i = 0; i < rgb.size(); i++ ) {
+            rgb[i] = static_cast<std::uint8_t>( i * 13 + 5 );
+        }
+
+        // A long run is reordered by the vector path, if any, and must match the portable order.
+        std::vector<std::byte> out( rgb.size() );
+        PERIPH_CHECK( encoder.encode( rgb, out ) == rgb.size() / 3 );
+
+        bool ordered = true;
+        for ( std::size_t i = 0; i < rgb.size(); i += 3 ) {
+            ordered = ordered && ( out[i + 0] == static_cast<std::byte>( rgb[i + 2] ) );
+            ordered = ordered && ( out[i + 1] == static_cast<std::byte>( rgb[i + 0] ) );
+            ordered = ordered && ( out[i + 2] == static_cast<std::byte>( rgb[i + 1] ) );
+        }
+        PERIPH_CHECK( ordered );
+    }
+
+    void test_quantize() {
+        const frame_encoder encoder( color_order::rgb, gamma_linear );
+
+        // Intensities in and around [0,1], including near-ties, and values needing clamping.
+        std::vector<float> rgb = {
+            0.0f, -0.0f, 1.0f, -1.0f, 2.0f, 1e30f, -1e30f,
+            std::numeric_limits<float>::infinity(),
+            -std::numeric_limits<float>::infinity(),
+            std::numeric_limits<float>::quiet_NaN()
+        };
+        for ( int k = -8; k <= 1028; k++ ) {
+            rgb.push_back( k / 1020.0f );
+        }
+        rgb.resize( ( rgb.size() + 23 ) / 24 * 24, 0.5f );
+
+        // A whole run of eight values is converted by the vector path, if any, while a single
+        // pixel is too short for it and converted by the scalar path.
+        std::vector<std::byte> whole( rgb.size() );
+        PERIPH_CHECK( encoder.encode( rgb, whole ) == rgb.size() / 3 );
+
+        for ( std::size_t i = 0; i < rgb.size(); i += 3 ) {
+            std::array<std::byte,3> single;
+            PERIPH_CHECK( encoder.encode( std::span( rgb ).subspan( i, 3 ), single ) == 1 );
+            PERIPH_CHECK( std::equal( single.begin(), single.end(), whole.begin() + i ) );
+        }
+
+        PERIPH_CHECK( whole[0] == std::byte{ 0 } );
+        PERIPH_CHECK( whole[2] == std::byte{ 255 } );
+        PERIPH_CHECK( whole[3] == std::byte{ 0 } );
+        PERIPH_CHECK( whole[4] == std::byte{ 255 } );
+        PERIPH_CHECK( whole[9] == std::byte{ 0 } );
+    }
+
+    void test_cache() {
+        frame_cache            cache( 3 );
+        std::vector<std::byte> frame = make_frame( 12, 0 );
+
+        PERIPH_CHECK( cache.update( frame ).size() == 12 );
+        PERIPH_CHECK( cache.update( frame ).empty() );
+        PERIPH_CHECK( cache.bytes_saved() == 12 );
+
+        // A frame is cut after the pixel holding its last change.
+        frame[4] = std::byte{ 0xFF };
+        PERIPH_CHECK( cache.update( frame ).size() == 6 );
+        PERIPH_CHECK( cache.bytes_saved() == 6 );
+        PERIPH_CHECK( cache.total_bytes_saved() == 18 );
+
+        // A frame of a different size, or after invalidation, is transmitted in full.
+        PERIPH_CHECK( cache.update( std::span( frame ).first( 9 ) ).size() == 9 );
+        cache.invalidate();
+        PERIPH_CHECK( cache.update( std::span( frame ).first( 9 ) ).size() == 9 );
+
+        frame_cache whole( 3, false );
+        whole.update( frame );
+        frame[0] = std::byte{ 0xFF };
+        PERIPH_CHECK( whole.update( frame ).size() == 12 );
+    }
+
+    void test_group() {
+        sim::pw_bit_model     model;
+        std::array<pw_bit*,2> channels = { &model.output( 0 ), &model.output( 1 ) };
+        pw_bit_group          group( channels );
+
+        fast_config.apply( channels );
+
+        const std::vector<std::byte> long_frame  = make_frame( 3 * fifo_bytes, 3 );
+        const std::vector<std::byte> short_frame = make_frame( 30, 5 );
+
+        PERIPH_CHECK( group.submit( 0, long_frame ) );
+        PERIPH_CHECK( group.submit( 1, short_frame ) );
+        PERIPH_CHECK( !group.submit( 1, short_frame ) );
+        PERIPH_CHECK( !group.submit( 2, short_frame ) );
+
+        // Refill passes between short stretches of transmission keep both FIFOs from running dry.
+        while ( group.service() > 0 ) {
+            model.advance( 1000 );
+        }
+        model.advance( 4 * 8 * 4 * fifo_depth );
+
+        PERIPH_CHECK( !group.busy( 0 ) );
+        PERIPH_CHECK( !group.busy( 1 ) );
+        PERIPH_CHECK( group.underruns( 0 ) == 0 );
+        PERIPH_CHECK( model.output( 0 ).underruns() == 0 );
+        PERIPH_CHECK( transmitted( model, 0, long_frame ) );
+        PERIPH_CHECK( transmitted( model, 1, short_frame ) );
+
+        // Unchanged frames submitted against the previous one transmit nothing.
+        PERIPH_CHECK( group.submit_changes( 1, short_frame ) );
+        group.run();
+        PERIPH_CHECK( group.submit_changes( 1, short_frame ) );
+        group.run();
+        PERIPH_CHECK( group.bytes_saved( 1 ) == short_frame.size() );
+        model.advance( 4 * 8 * 4 * 16 );
+        PERIPH_CHECK( transmitted( model, 1, short_frame ) );
+    }
+
+    void test_group_underrun() {
+        sim::pw_bit_model     model;
+        std::array<pw_bit*,1> channels = { &model.output( 0 ) };
+        pw_bit_group          group( channels );
+
+        fast_config.apply( channels );
+
+        // Starving the channel between refills empties its FIFO in the middle of the frame.
+        const std::vector<std::byte> frame = make_frame( 3 * fifo_bytes, 0 );
+        PERIPH_CHECK( group.submit( 0, frame ) );
+        while ( group.service() > 0 ) {
+            model.advance( 4 * 8 * 4 * fifo_depth );
+        }
+
+        // Every underrun is counted, including those while queueing the end of the frame.
+        const std::size_t count = model.output( 0 ).underruns();
+        PERIPH_CHECK( count > 0 );
+        PERIPH_CHECK( group.underruns( 0 ) == count );
+
+        // A group created later only counts the underruns since.
+        pw_bit_group later( channels );
+        PERIPH_CHECK( later.underruns( 0 ) == 0 );
+        PERIPH_CHECK( later.submit( 0, frame ) );
+        while ( later.service() > 0 ) {
+            model.advance( 2 * 4 * 8 * 4 * fifo_depth );
+        }
+        PERIPH_CHECK( later.underruns( 0 ) == model.output( 0 ).underruns() - count );
+        PERIPH_CHECK( later.underruns( 0 ) > 0 );
+        PERIPH_CHECK( later.underruns( 1 ) == 0 );
+    }
+
+    void test_refill() {
+        sim::pw_bit_model model;
+        pw_bit&           dev = model.output( 0 );
+
+        fast_config.apply( std::array<pw_bit*,1>{ &dev } );
+
+        const std::vector<std::byte> frame = make_frame( 2 * fifo_bytes, 9 );
+        {
+            pw_bit_refill refill( dev, model.irq_fd(), pw_bit_refill::event_kind::eventfd );
+
+            // A buffer that fits into the FIFO is queued without waiting.
+            PERIPH_CHECK( refill.stream( std::span( frame ).first( 64 ) ) == 64 );
+            PERIPH_CHECK( model.irq() );
+
+            // Filling the FIFO lowers the interrupt, withdrawing the signal of the empty FIFO,
+            // and with the model stopped, waiting for the next refill times out.
+            model.advance( 4 * 8 * 4 * 16 );
+            PERIPH_CHECK( transmitted( model, 0, std::span( frame ).first( 64 ) ) );
+            PERIPH_CHECK( refill.stream( frame, 10 ) == fifo_bytes );
+            PERIPH_CHECK( refill.wakeups() == 0 );
+            PERIPH_CHECK( !model.irq() );
+
+            // Running the FIFO down to the watermark raises the interrupt again.
+            model.advance( 4 * 8 * 4 * ( fifo_depth - fifo_watermark + 1 ) );
+            PERIPH_CHECK( model.irq() );
+            PERIPH_CHECK( refill.stream( std::span( frame ).first( 4 ), 10 ) == 4 );
+        }
+        model.advance( 4 * 8 * 4 * fifo_depth );
+        PERIPH_CHECK( !model.irq() );
+    }
+
+    void test_refill_stream() {
+        sim::pw_bit_model model( 10'000'000 );
+        pw_bit&           dev = model.output( 0 );
+
+        fast_config.apply( std::array<pw_bit*,1>{ &dev } );
+
+        // A model running in real time signals each watermark crossing on its own, so the refill
+        // engine sleeps through the whole stream without polling the model. How the output keeps
+        // up depends on scheduling, so only the wakeups are checked here.
+        const std::vector<std::byte> frame = make_frame( 4 * fifo_bytes, 4 );
+
+        pw_bit_refill refill( dev, model.irq_fd(), pw_bit_refill::event_kind::eventfd );
+
+        PERIPH_CHECK( refill.stream( frame, 1000 ) == frame.size() );
+        PERIPH_CHECK( refill.wakeups() >= 3 );
+    }
+
+    void test_refill_paced() {
+        sim::pw_bit_model model;
+        pw_bit&           dev = model.output( 0 );
+
+        fast_config.apply( std::array<pw_bit*,1>{ &dev } );
+
+        // Running the output down to just below the watermark between refills leaves the FIFO
+        // some words to go on each time, so the frame goes out whole and without underruns.
+        const std::vector<std::byte> frame = make_frame( 4 * fifo_bytes, 4 );
+        {
+            pw_bit_refill refill( dev, model.irq_fd(), pw_bit_refill::event_kind::eventfd );
+
+            std::size_t queued = refill.stream( frame, 0 );
+            for ( int i = 0; ( i < 100 ) && ( queued < frame.size() ); i++ ) {
+                model.advance( 4 * 8 * 4 * ( fifo_depth - fifo_watermark + 1 ) );
+                PERIPH_CHECK( model.irq() );
+                queued += refill.stream( std::span( frame ).subspan( queued ), 0 );
+            }
+            PERIPH_CHECK( queued == frame.size() );
+            PERIPH_CHECK( dev.end_frame() );
+        }
+        model.advance( 4 * 8 * 4 * ( fifo_depth + 1 ) + fast_config.reset_gap );
+
+        PERIPH_CHECK( dev.fifo_empty() );
+        PERIPH_CHECK( dev.underruns() == 0 );
+        PERIPH_CHECK( transmitted( model, 0, frame ) );
+    }
+
+    /**
+     * Transmit a frame, then wait for the output to drain.
+     */
+    task send_and_drain( reactor& io, pw_bit& dev, std::span<const std::byte> frame, bool& done ) {
+        co_await write_frame( io, dev, frame );
+        co_await drained( io, dev );
+        done = true;
+    }
+
+    void test_async() {
+        sim::pw_bit_model model( 10'000'000 );
+        pw_bit&           dev = model.output( 0 );
+        reactor           io;
+        const int         fd  = model.irq_fd();
+
+        fast_config.apply( std::array<pw_bit*,1>{ &dev } );
+        dev.set_refill_irq( true );
+        PERIPH_CHECK( io.watch( fd, reactor::event_kind::eventfd ) );
+
+        // The frame fits into the FIFO, which stays below the watermark, so the refill interrupt
+        // raised on the empty FIFO is the last one, and is consumed before the drain is awaited.
+        const std::vector<std::byte> frame = make_frame( 64, 2 );
+        bool                         done  = false;
+
+        std::uint64_t count;
+        model.sync();
+        PERIPH_CHECK( model.irq() );
+        PERIPH_CHECK( ::read( fd, &count, sizeof( count ) ) == sizeof( count ) );
+
+        send_and_drain( io, dev, frame, done );
+        PERIPH_CHECK( io.pending() == 1 );
+        PERIPH_CHECK( io.run_once( 1000 ) == 1 );
+        PERIPH_CHECK( done );
+        PERIPH_CHECK( dev.fifo_empty() );
+        PERIPH_CHECK( io.wakeups() == 0 );
+
+        dev.set_refill_irq( false );
+    }
+
+    void test_stream_port() {
+        sim::pw_bit_model model;
+        pw_bit&           dev = model.output( 0 );
+
+        fast_config.apply( std::array<pw_bit*,1>{ &dev } );
+
+        // Beats for nonexistent or disabled outputs are dropped without stalling the stream.
+        PERIPH_CHECK( model.push( sim::pw_bit_model::num_outputs, 0x11111111, 0xF, false ) );
+        PERIPH_CHECK( model.push( 1, 0x11111111, 0xF, false ) );
+        PERIPH_CHECK( model.fifo_level( 1 ) == 0 );
+
+        // The first beat leaves the FIFO at once, and a beat with TLAST set is followed by an
+        // end-of-frame marker. Only the bytes kept by TKEEP are transmitted, lowest first.
+        PERIPH_CHECK( model.push( 0, 0x44332211, 0xF, false ) );
+        PERIPH_CHECK( model.fifo_level( 0 ) == 0 );
+        PERIPH_CHECK( model.push( 0, 0x88776655, 0x5, true ) );
+        PERIPH_CHECK( model.fifo_level( 0 ) == 2 );
+
+        model.advance( 2 * 4 * 8 * 4 + fast_config.reset_gap );
+        const std::array<std::byte,6> frame = {
+            std::byte{ 0x11 }, std::byte{ 0x22 }, std::byte{ 0x33 }, std::byte{ 0x44 },
+            std::byte{ 0x55 }, std::byte{ 0x77 }
+        };
+        PERIPH_CHECK( transmitted( model, 0, frame ) );
+        PERIPH_CHECK( dev.underruns() == 0 );
+
+        // A beat without kept bytes is dropped, even with the marker's data, but its TLAST still
+        // ends the frame.
+        PERIPH_CHECK( model.push( 0, 0x44332211, 0xF, false ) );
+        PERIPH_CHECK( model.push( 0, 0x00000001, 0x0, false ) );
+        PERIPH_CHECK( model.fifo_level( 0 ) == 0 );
+        PERIPH_CHECK( model.push( 0, 0x00000001, 0x0, true ) );
+        PERIPH_CHECK( model.fifo_level( 0 ) == 1 );
+
+        model.advance( 2 * 4 * 8 * 4 + fast_config.reset_gap );
+        PERIPH_CHECK( transmitted( model, 0, std::span( frame ).first( 4 ) ) );
+        PERIPH_CHECK( dev.underruns() == 0 );
+
+        // A full FIFO refuses beats, and a beat with TLAST set needs room for its marker too.
+        std::size_t accepted = 0;
+        while ( model.push( 0, 0x11111111, 0xF, false ) ) {
+            accepted++;
+        }
+        PERIPH_CHECK( accepted == fifo_depth + 1 );
+        PERIPH_CHECK( model.fifo_level( 0 ) == fifo_depth );
+
+        model.advance( 4 * 8 * 4 );
+        PERIPH_CHECK( model.fifo_level( 0 ) == fifo_depth - 1 );
+        PERIPH_CHECK( !model.push( 0, 0x11111111, 0xF, true ) );
+        PERIPH_CHECK( model.push( 0, 0x11111111, 0xF, false ) );
+        PERIPH_CHECK( dev.overflows() == 0 );
+    }
+
+    /**
+     * Address a buffer the way the DMA model dereferences physical addresses.
+     */
+    std::uint64_t phys( const void* ptr ) {
+        return reinterpret_cast<std::uintptr_t>( ptr );
+    }
+
+    void test_dma_stream() {
+        sim::pw_bit_model      leds;
+        sim::dma_model         dma_engine( leds );
+        std::array<dma_desc,4> descs{};
+        dma_ring               ring( descs, phys( descs.data() ) );
+        dma&                   engine = dma_engine.device();
+
+        fast_config.apply( std::array<pw_bit*,2>{ &leds.output( 0 ), &leds.output( 1 ) } );
+
+        // Frames longer than the FIFO stall the engine until the output has made room, and
+        // frames of any length end in a partial beat and a reset gap.
+        const std::vector<std::byte> first  = make_frame( 3 * fifo_bytes + 2, 1 );
+        const std::vector<std::byte> second = make_frame( 7, 2 );
+        const std::vector<std::byte> third  = make_frame( 13, 3 );
+
+        engine.start( ring );
+        PERIPH_CHECK( ring.submit( phys( first.data() ), first.size(), 0 ) );
+        PERIPH_CHECK( ring.submit( phys( second.data() ), second.size(), 1 ) );
+        PERIPH_CHECK( ring.submit( phys( third.data() ), third.size(), 0 ) );
+        engine.kick( ring );
+
+        std::size_t reclaimed = 0;
+        for ( int i = 0; ( i < 1000 ) && ( reclaimed < 3 ); i++ ) {
+            dma_engine.advance( 1000 );
+            leds.advance( 1000 );
+            reclaimed += ring.reclaim();
+        }
+        PERIPH_CHECK( reclaimed == 3 );
+        PERIPH_CHECK( !ring.failed() );
+        PERIPH_CHECK( dma_engine.bytes_sent() == first.size() + second.size() + third.size() );
+
+        leds.advance( 4 * 8 * 4 * fifo_depth );
+        std::vector<std::byte> frames = first;
+        frames.insert( frames.end(), third.begin(), third.end() );
+        PERIPH_CHECK( transmitted( leds, 0, frames ) );
+        PERIPH_CHECK( transmitted( leds, 1, second ) );
+        PERIPH_CHECK( leds.output( 0 ).underruns() == 0 );
+        PERIPH_CHECK( leds.output( 1 ).underruns() == 0 );
+    }
+
+    void test_queue() {
+        std::vector<std::string> released;
+
+        const auto release = []( void* context, bool sent ) {
+            static_cast<std::vector<std::string>*>( context )->push_back( sent ? "sent" : "drop" );
+        };
+
+        const std::vector<std::byte> frame = make_frame( 4, 0 );
+
+        frame_queue queue( 3 );
+        PERIPH_CHECK( queue.capacity() == 4 );
+
+        std::array<frame_desc,5> descs;
+        for ( std::size_t i = 0; i < descs.size(); i++ ) {
+            descs[i] = { std::span( frame ).first( i ), release, &released };
+        }
+        for ( std::size_t i = 0; i < 4; i++ ) {
+            PERIPH_CHECK( queue.push( descs[i] ) );
+        }
+        PERIPH_CHECK( !queue.push( descs[4] ) );
+
+        frame_desc desc;
+        for ( std::size_t i = 0; i < 4; i++ ) {
+            PERIPH_CHECK( queue.pop( desc ) );
+            PERIPH_CHECK( desc.frame.size() == i );
+        }
+        PERIPH_CHECK( !queue.pop( desc ) );
+
+        const queue_stats stats = queue.stats();
+        PERIPH_CHECK( stats.pushed == 4 );
+        PERIPH_CHECK( stats.rejected == 1 );
+        PERIPH_CHECK( stats.popped == 4 );
+        PERIPH_CHECK( released.empty() );
+
+        // A full dropping queue releases its oldest frame as not sent to make room.
+        frame_queue dropping( 2, queue_policy::drop_oldest );
+        for ( std::size_t i = 0; i < 3; i++ ) {
+            PERIPH_CHECK( dropping.push( descs[i] ) );
+        }
+        PERIPH_CHECK( ( released == std::vector<std::string>{ "drop" } ) );
+        PERIPH_CHECK( dropping.pop( desc ) );
+        PERIPH_CHECK( desc.frame.size() == 1 );
+        PERIPH_CHECK( dropping.stats().dropped == 1 );
+    }
+
+    /**
+     * A frame handed to a dispatcher, which is scribbled over once released.
+     */
+    struct queued_frame {
+        std::vector<std::byte> bytes;             //!< Frame contents.
+        std::atomic<int>*      sent    = nullptr; //!< Count of frames released as sent.
+        std::atomic<int>*      dropped = nullptr; //!< Count of frames released as not sent.
+    };
+
+    /**
+     * Release a queued frame, and overwrite it so that a premature release shows in the output.
+     */
+    void release_frame( void* context, bool sent ) {
+        auto frame = static_cast<queued_frame*>( context );
+
+        std::fill( frame->bytes.begin(), frame->bytes.end(), std::byte{ 0xee } );
+        ( sent ? frame->sent : frame->dropped )->fetch_add( 1 );
+    }
+
+    void test_dispatcher() {
+        sim::pw_bit_model           model;
+        const std::array<pw_bit*,2> channels = { &model.output( 0 ), &model.output( 1 ) };
+        PERIPH_CHECK( fast_config.apply( channels ) > 0 );
+
+        std::atomic<int> sent    = 0;
+        std::atomic<int> dropped = 0;
+
+        // Frames longer than the FIFO are only released once their last word is written.
+        std::array<queued_frame,3> frames;
+        for ( std::size_t i = 0; i < frames.size(); i++ ) {
+            const auto seed = static_cast<std::uint8_t>( i );
+            frames[i] = { make_frame( 2 * fifo_bytes + 8 * i, seed ), &sent, &dropped };
+        }
+        std::vector<std::byte> expected = frames[0].bytes;
+        expected.insert( expected.end(), frames[1].bytes.begin(), frames[1].bytes.end() );
+
+        pw_bit_dispatcher dispatcher( channels, 2 );
+        PERIPH_CHECK( dispatcher.push( 0, { frames[0].bytes, release_frame, &frames[0] } ) );
+        PERIPH_CHECK( dispatcher.push( 0, { frames[1].bytes, release_frame, &frames[1] } ) );
+        PERIPH_CHECK( !dispatcher.push( 0, { frames[2].bytes, release_frame, &frames[2] } ) );
+        PERIPH_CHECK( !dispatcher.push( 2, { frames[2].bytes, release_frame, &frames[2] } ) );
+
+        PERIPH_CHECK( dispatcher.service() == 1 );
+        PERIPH_CHECK( sent == 0 );
+
+        for ( int i = 0; ( i < 1000 ) && ( sent < 2 ); i++ ) {
+            model.advance( 1000 );
+            dispatcher.service();
+        }
+        PERIPH_CHECK( sent == 2 );
+        PERIPH_CHECK( dropped == 0 );
+        PERIPH_CHECK( dispatcher.service() == 0 );
+
+        model.advance( 4 * 8 * 4 * fifo_depth );
+        PERIPH_CHECK( transmitted( model, 0, expected ) );
+        PERIPH_CHECK( model.take_transmitted( 1 ).empty() );
+
+        const queue_stats stats = dispatcher.stats( 0 );
+        PERIPH_CHECK( stats.pushed == 2 );
+        PERIPH_CHECK( stats.rejected == 1 );
+        PERIPH_CHECK( stats.popped == 2 );
+        PERIPH_CHECK( dispatcher.stats( 1 ).pushed == 0 );
+        PERIPH_CHECK( dispatcher.stats( 2 ).pushed == 0 );
+    }
+
+    void test_dispatcher_threads() {
+        constexpr std::size_t num_producers = 4;
+        constexpr std::size_t num_frames    = 16;
+        constexpr std::size_t frame_bytes   = 64;
+
+        sim::pw_bit_model           model( 20'000'000 );
+        const std::array<pw_bit*,2> channels = { &model.output( 0 ), &model.output( 1 ) };
+        PERIPH_CHECK( fast_config.apply( channels ) > 0 );
+
+        std::atomic<int> sent    = 0;
+        std::atomic<int> dropped = 0;
+
+        // Each frame starts with its producer and sequence number, so the output can be split.
+        const auto make_numbered = [&]( std::size_t p, std::size_t n ) {
+            const auto             seed  = static_cast<std::uint8_t>( p + n );
+            std::vector<std::byte> bytes = make_frame( frame_bytes, seed );
+            bytes[0] = static_cast<std::byte>( p );
+            bytes[1] = static_cast<std::byte>( n );
+
+            return bytes;
+        };
+
+        std::vector<std::vector<queued_frame>> frames( num_producers );
+        for ( std::size_t p = 0; p < num_producers; p++ ) {
+            frames[p].resize( num_frames );
+            for ( std::size_t n = 0; n < num_frames; n++ ) {
+                frames[p][n] = { make_numbered( p, n ), &sent, &dropped };
+            }
+        }
+
+        pw_bit_dispatcher dispatcher( channels, 4 );
+        std::jthread      consumer( [&]( std::stop_token stop ) { dispatcher.run( stop ); } );
+
+        // Two producers share each channel, and retry while its queue is full.
+        std::vector<std::thread> producers;
+        for ( std::size_t p = 0; p < num_producers; p++ ) {
+            producers.emplace_back( [&, p] {
+                for ( queued_frame& frame : frames[p] ) {
+                    while ( !dispatcher.push( p % 2, { frame.bytes, release_frame, &frame } ) ) {
+                        std::this_thread::yield();
+                    }
+                }
+            } );
+        }
+        for ( std::thread& producer : producers ) {
+            producer.join();
+        }
+
+        const int total = static_cast<int>( num_producers * num_frames );
+        for ( int i = 0; ( i < 10000 ) && ( sent + dropped < total ); i++ ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+        consumer.request_stop();
+        consumer.join();
+        PERIPH_CHECK( sent == total );
+        PERIPH_CHECK( dropped == 0 );
+
+        for ( int i = 0; i < 1000; i++ ) {
+            model.sync();
+            if ( model.output( 0 ).fifo_empty() && model.output( 1 ).fifo_empty() ) {
+                break;
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+        model.advance( 4 * 8 * 4 );
+
+        // Frames of one producer keep their order, interleaved with those of the other.
+        for ( std::size_t channel = 0; channel < channels.size(); channel++ ) {
+            const std::vector<std::uint8_t> bytes = model.take_transmitted( channel );
+            PERIPH_CHECK( bytes.size() == num_producers / 2 * num_frames * frame_bytes );
+
+            std::array<std::size_t,num_producers> next{};
+            for ( std::size_t pos = 0; pos + frame_bytes <= bytes.size(); pos += frame_bytes ) {
+                const std::size_t p = bytes[pos];
+                PERIPH_CHECK( ( p < num_producers ) && ( p % 2 == channel ) );
+                if ( ( p >= num_producers ) || ( next[p] >= num_frames ) ) {
+                    break;
+                }
+
+                const std::vector<std::byte> frame = make_numbered( p, next[p]++ );
+                PERIPH_CHECK( std::equal(
+                    frame.begin(), frame.end(), bytes.begin() + pos,
+                    []( std::byte a, std::uint8_t b ) {
+                        return static_cast<std::uint8_t>( a ) == b;
+                    }
+                ) );
+            }
+        }
+
+        std::size_t pushed = 0;
+        std::size_t popped = 0;
+        for ( std::size_t channel = 0; channel < channels.size(); channel++ ) {
+            pushed += dispatcher.stats( channel ).pushed;
+            popped += dispatcher.stats( channel ).popped;
+        }
+        PERIPH_CHECK( pushed == num_producers * num_frames );
+        PERIPH_CHECK( popped == num_producers * num_frames );
+    }
+
+    void test_shm() {
+        shared_frame_buffer frames( 64 );
+        PERIPH_CHECK( frames.valid() );
+        PERIPH_CHECK( frames.capacity() >= 64 );
+        PERIPH_CHECK( frames.acquire().empty() );
+
+        frames.back()[0] = std::byte{ 1 };
+        frames.publish( 10 );
+
+        // A second mapping of the same memory, as a feeder process would open it.
+        const std::string   path = "/proc/self/fd/" + std::to_string( frames.fd() );
+        shared_frame_buffer feeder( path.c_str() );
+        PERIPH_CHECK( feeder.valid() );
+
+        std::span<const std::byte> frame = feeder.acquire();
+        PERIPH_CHECK( frame.size() == 10 );
+        PERIPH_CHECK( ( !frame.empty() ) && ( frame[0] == std::byte{ 1 } ) );
+        PERIPH_CHECK( feeder.acquire().empty() );
+
+        // Only the newest of several frames published in between is acquired.
+        frames.back()[0] = std::byte{ 2 };
+        frames.publish( 20 );
+        frames.back()[0] = std::byte{ 3 };
+        frames.publish( 30 );
+        frame = feeder.acquire();
+        PERIPH_CHECK( frame.size() == 30 );
+        PERIPH_CHECK( ( !frame.empty() ) && ( frame[0] == std::byte{ 3 } ) );
+    }
+
+}
+
+int main() {
+    test::run( "cell", test_cell );
+    test::run( "config", test_config );
+    test::run( "reorder", test_reorder );
+    test::run( "quantize", test_quantize );
+    test::run( "cache", test_cache );
+    test::run( "group", test_group );
+    test::run( "group_underrun", test_group_underrun );
+    test::run( "refill", test_refill );
+    test::run( "refill_stream", test_refill_stream );
+    test::run( "refill_paced", test_refill_paced );
+    test::run( "async", test_async );
+    test::run( "stream_port", test_stream_port );
+    test::run( "dma_stream", test_dma_stream );
+    test::run( "queue", test_queue );
+    test::run( "dispatcher", test_dispatcher );
+    test::run( "dispatcher_threads", test_dispatcher_threads );
+    test::run( "shm", test_shm );
+
+    return test::result();
+}
@@ -7,8 +7,19 @@ periph::pw_bit* const pwb_1 = (periph::pw_bit*)(intptr_t)0x43C10020;
 periph::pw_bit* const pwb_2 = (periph::pw_bit*)(intptr_t)0x43C10040;
 periph::pw_bit* const pwb_3 = (periph::pw_bit*)(intptr_t)0x43C10060;
 
+/**
+ * Busy-wait for a number of loop iterations.
+ * 
+ * \param iterations The number of iterations to wait for.
+ */
+static void spin( int iterations ) {
+    for ( int i = 0; i < iterations; i++ ) {
+        asm volatile( "" ::: "memory" ); // Keep the loop from being optimized out.
+    }
+}
+
 int main( int argc, char* argv[] ) {
-    for ( volatile int i = 0; i < 50000000; i++ );
+    spin( 50000000 );
 
     pwb_1->set_active_bytes( 3 );
     pwb_1->set_period( 125 );
@@ -19,10 +30,10 @@ int main( int argc, char* argv[] ) {
 
     while(true) {
         pwb_1->write( 0x000000FF );
-        for ( volatile int i = 0; i < 50000000; i++ );
+        spin( 50000000 );
         pwb_1->write( 0x0000FF00 );
-        for ( volatile int i = 0; i < 50000000; i++ );
+        spin( 50000000 );
         pwb_1->write( 0x00FF0000 );
-        for ( volatile int i = 0; i < 50000000; i++ );
+        spin( 50000000 );
     }
 }
@@ -14,13 +14,28 @@ entity axi_pw_bit is
         AXI_DATA_WIDTH : integer := 32;
         AXI_ADDR_WIDTH : integer := 8;
         
+        AXIS_DEST_WIDTH : integer := 4;
+        
         NUM_OUTPUTS : integer := 4
     );
     port (
         txd : out std_logic_vector(NUM_OUTPUTS-1 downto 0);
+        irq : out std_logic;
+        
+        -- optional stream port feeding the output data FIFOs, with TDEST selecting the output
+        -- and TLAST ending a frame
+        s_axis_tdata  : in  std_logic_vector(AXI_DATA_WIDTH-1 downto 0)   := (others => '0');
+        s_axis_tkeep  : in  std_logic_vector(AXI_DATA_WIDTH/8-1 downto 0) := (others => '1');
+        s_axis_tlast  : in  std_logic := '0';
+        s_axis_tdest  : in  std_logic_vector(AXIS_DEST_WIDTH-1 downto 0)  := (others => '0');
+        s_axis_tvalid : in  std_logic := '0';
+        s_axis_tready : out std_logic;
         
         s_axi_awid    : in  std_logic_vector(AXI_ID_WIDTH-1 downto 0);
         s_axi_awaddr  : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+        s_axi_awlen   : in  std_logic_vector(7 downto 0);
+        s_axi_awsize  : in  std_logic_vector(2 downto 0);
+        s_axi_awburst : in  std_logic_vector(1 downto 0);
         s_axi_awprot  : in  std_logic_vector(2 downto 0);
         s_axi_awvalid : in  std_logic;
         s_axi_awready : out std_logic;
@@ -59,11 +74,17 @@ architecture arch of axi_pw_bit is
     
     signal s_axi_awid_reg    : std_logic_vector(AXI_ID_WIDTH-1 downto 0);
     signal s_axi_awaddr_reg  : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+    signal s_axi_awlen_reg   : std_logic_vector(7 downto 0);
+    signal s_axi_awsize_reg  : std_logic_vector(2 downto 0);
+    signal s_axi_awburst_reg : std_logic_vector(1 downto 0);
     signal s_axi_awprot_reg  : std_logic_vector(2 downto 0);
     signal s_axi_awvalid_reg : std_logic;
     
     signal s_axi_awid_reg_next    : std_logic_vector(AXI_ID_WIDTH-1 downto 0);
     signal s_axi_awaddr_reg_next  : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+    signal s_axi_awlen_reg_next   : std_logic_vector(7 downto 0);
+    signal s_axi_awsize_reg_next  : std_logic_vector(2 downto 0);
+    signal s_axi_awburst_reg_next : std_logic_vector(1 downto 0);
     signal s_axi_awprot_reg_next  : std_logic_vector(2 downto 0);
     signal s_axi_awvalid_reg_next : std_logic;
     
@@ -152,6 +173,56 @@ architecture arch of axi_pw_bit is
     signal regs_next : reg_bank;
     
     constant AXADDR_REG_JUSTFY_BITS : integer := integer(ceil(log2(real(AXI_DATA_WIDTH/8))));
+
+    -- width of the read/write counts of a 36Kb FIFO_SYNC_MACRO of the given data width, i.e. the
+    -- log2 of its depth
+    function fifo_count_width(data_width : integer) return integer is
+    begin
+        if (data_width <= 4) then
+            return 13;
+        elsif (data_width <= 9) then
+            return 12;
+        elsif (data_width <= 18) then
+            return 11;
+        elsif (data_width <= 36) then
+            return 10;
+        else
+            return 9;
+        end if;
+    end function;
+
+    -- each data FIFO entry holds a data word and its byte mask
+    constant FIFO_COUNT_WIDTH : integer := fifo_count_width(AXI_DATA_WIDTH + AXI_DATA_WIDTH/8);
+
+    -- identification word read back from the reserved register of each output: core type,
+    -- version, log2 of the data FIFO depth, index of the output and number of outputs
+    constant ID_REG_ADDR : integer := 3;
+
+    constant CORE_TYPE       : integer := 16#42#;
+    constant CORE_VERSION    : integer := 2;
+    constant FIFO_DEPTH_LOG2 : integer := FIFO_COUNT_WIDTH;
+
+    constant ID_WORD : unsigned(AXI_DATA_WIDTH-1 downto 0) :=
+        shift_left(to_unsigned(CORE_TYPE      , AXI_DATA_WIDTH), 24) or
+        shift_left(to_unsigned(CORE_VERSION   , AXI_DATA_WIDTH), 20) or
+        shift_left(to_unsigned(FIFO_DEPTH_LOG2, AXI_DATA_WIDTH), 16) or
+        to_unsigned(NUM_OUTPUTS, AXI_DATA_WIDTH);
+
+    -- the data FIFO write port of each output reads back as the number of entries in the FIFO
+    constant DATA_REG_ADDR : integer := 0;
+
+    -- saturating error counters read back from the upper half of the configuration register of
+    -- each output, cleared by writing a one to the clear bit, which always reads as zero
+    constant CFG_CLEAR_BIT     : integer := 6;
+    constant CFG_OVERFLOWS_LSB : integer := 16;
+    constant CFG_UNDERRUNS_LSB : integer := 24;
+    constant ERR_COUNT_WIDTH   : integer := 8;
+    constant ERR_COUNT_MAX     : unsigned(ERR_COUNT_WIDTH-1 downto 0) := (others => '1');
+    constant CFG_UPPER_LSB     : integer := CFG_UNDERRUNS_LSB + ERR_COUNT_WIDTH;
+
+    -- fill level of a full data FIFO
+    constant FIFO_FULL_LEVEL : unsigned(FIFO_COUNT_WIDTH downto 0) :=
+        shift_left(to_unsigned(1, FIFO_COUNT_WIDTH+1), FIFO_COUNT_WIDTH);
     
     signal reg_index_from_araddr     : integer;
     signal reg_index_from_awaddr_reg : integer;
@@ -160,8 +231,39 @@ architecture arch of axi_pw_bit is
     -- Register Access --
     ---------------------
 
-    signal fifos_full  : std_logic_vector(NUM_OUTPUTS-1 downto 0);
-    signal fifos_empty : std_logic_vector(NUM_OUTPUTS-1 downto 0);
+    signal fifos_full        : std_logic_vector(NUM_OUTPUTS-1 downto 0);
+    signal fifos_empty       : std_logic_vector(NUM_OUTPUTS-1 downto 0);
+    signal fifos_almostfull  : std_logic_vector(NUM_OUTPUTS-1 downto 0);
+    signal fifos_almostempty : std_logic_vector(NUM_OUTPUTS-1 downto 0);
+
+    type fifo_level_array is array (
+        NUM_OUTPUTS-1 downto 0
+    ) of unsigned(
+        FIFO_COUNT_WIDTH downto 0
+    );
+
+    type err_count_array is array (
+        NUM_OUTPUTS-1 downto 0
+    ) of unsigned(
+        ERR_COUNT_WIDTH-1 downto 0
+    );
+
+    signal fifos_level     : fifo_level_array;
+    signal fifos_overflows : err_count_array;
+    signal fifos_underruns : err_count_array;
+
+    -----------------------
+    -- Stream Data Input --
+    -----------------------
+
+    signal axis_dest    : integer;
+    signal axis_treadys : std_logic_vector(NUM_OUTPUTS-1 downto 0);
+
+    ----------------------
+    -- Refill Interrupt --
+    ----------------------
+
+    signal refill_reqs : std_logic_vector(NUM_OUTPUTS-1 downto 0);
 begin
     --------------------------
     -- AXI-4 Lite Registers --
@@ -179,6 +281,9 @@ begin
     process (
         s_axi_awid   ,
         s_axi_awaddr ,
+        s_axi_awlen  ,
+        s_axi_awsize ,
+        s_axi_awburst,
         s_axi_awprot ,
         s_axi_awvalid,
         s_axi_wdata ,
@@ -190,6 +295,9 @@ begin
         s_axi_arprot ,
         s_axi_awid_reg   ,
         s_axi_awaddr_reg ,
+        s_axi_awlen_reg  ,
+        s_axi_awsize_reg ,
+        s_axi_awburst_reg,
         s_axi_awprot_reg ,
         s_axi_awvalid_reg,
         s_axi_awready    ,
@@ -207,10 +315,14 @@ begin
         rd_state         ,
         regs             ,
         reg_index_from_awaddr_reg,
-        reg_index_from_araddr
+        reg_index_from_araddr,
+        fifos_level
     ) begin
         s_axi_awid_reg_next    <= s_axi_awid_reg   ;
         s_axi_awaddr_reg_next  <= s_axi_awaddr_reg ;
+        s_axi_awlen_reg_next   <= s_axi_awlen_reg  ;
+        s_axi_awsize_reg_next  <= s_axi_awsize_reg ;
+        s_axi_awburst_reg_next <= s_axi_awburst_reg;
         s_axi_awprot_reg_next  <= s_axi_awprot_reg ;
         s_axi_awvalid_reg_next <= s_axi_awvalid_reg;
         s_axi_awready_next     <= s_axi_awready    ;
@@ -234,35 +346,55 @@ begin
                     
                     s_axi_awid_reg_next    <= s_axi_awid   ;
                     s_axi_awaddr_reg_next  <= s_axi_awaddr ;
+                    s_axi_awlen_reg_next   <= s_axi_awlen  ;
+                    s_axi_awsize_reg_next  <= s_axi_awsize ;
+                    s_axi_awburst_reg_next <= s_axi_awburst;
                     s_axi_awprot_reg_next  <= s_axi_awprot ;
                     s_axi_awvalid_reg_next <= s_axi_awvalid;
                     
                     s_axi_awready_next     <= '0';
                     
                     s_axi_wready_next      <= '1';
+                    
+                    s_axi_bresp_next       <= AXI4_RESP_NMOKAY;
                 end if;
                 
             when writing =>
                 if (s_axi_wvalid = '1') then
-                    wr_state_next <= responding;
-                    
-                    for i in 0 to AXI_DATA_WIDTH/8-1 loop
-                        if (s_axi_wstrb(i) = '1') then
-                            regs_next
-                                (reg_index_from_awaddr_reg)
-                                (8*(i+1)-1 downto 8*i) <= s_axi_wdata(8*(i+1)-1 downto 8*i);
-                        end if;
-                    end loop;
-                    
-                    s_axi_wready_next <= '0';
-                    
-                    s_axi_bid_next    <= s_axi_awid_reg;
                     if (reg_index_from_awaddr_reg < NUM_REGS) then
-                        s_axi_rresp_next <= AXI4_RESP_NMOKAY;
+                        for i in 0 to AXI_DATA_WIDTH/8-1 loop
+                            if (s_axi_wstrb(i) = '1') then
+                                regs_next
+                                    (reg_index_from_awaddr_reg)
+                                    (8*(i+1)-1 downto 8*i) <= s_axi_wdata(8*(i+1)-1 downto 8*i);
+                            end if;
+                        end loop;
                     else
-                        s_axi_rresp_next <= AXI4_RESP_SLVERR;
+                        s_axi_bresp_next <= AXI4_RESP_SLVERR;
+                    end if;
+                    
+                    -- Accept one beat per cycle until the burst is exhausted, advancing the
+                    -- register address after each beat of an incrementing burst.
+                    if (unsigned(s_axi_awlen_reg) = 0) then
+                        wr_state_next <= responding;
+                        
+                        s_axi_wready_next <= '0';
+                        
+                        s_axi_bid_next    <= s_axi_awid_reg;
+                        s_axi_bvalid_next <= '1';
+                    else
+                        s_axi_awlen_reg_next <= std_logic_vector(unsigned(s_axi_awlen_reg) - 1);
+                        
+                        if (s_axi_awburst_reg = AXI4_BURST_INCRE) then
+                            s_axi_awaddr_reg_next <= std_logic_vector(
+                                unsigned(s_axi_awaddr_reg) +
+                                shift_left(
+                                    to_unsigned(1, AXI_ADDR_WIDTH),
+                                    to_integer(unsigned(s_axi_awsize_reg))
+                                )
+                            );
+                        end if;
                     end if;
-                    s_axi_bvalid_next <= '1';
                 end if;
                 
             when responding =>
@@ -283,7 +415,18 @@ begin
                     s_axi_arready_next <= '0';
                     
                     s_axi_rid_next     <= s_axi_arid;
-                    s_axi_rdata_next   <= regs(reg_index_from_araddr);
+                    if (reg_index_from_araddr mod 8 = ID_REG_ADDR) then
+                        s_axi_rdata_next <= std_logic_vector(
+                            ID_WORD or
+                            shift_left(to_unsigned(reg_index_from_araddr/8, AXI_DATA_WIDTH), 8)
+                        );
+                    elsif (reg_index_from_araddr mod 8 = DATA_REG_ADDR) then
+                        s_axi_rdata_next <= std_logic_vector(
+                            resize(fifos_level(reg_index_from_araddr/8), AXI_DATA_WIDTH)
+                        );
+                    else
+                        s_axi_rdata_next <= regs(reg_index_from_araddr);
+                    end if;
                     if (reg_index_from_araddr < NUM_REGS) then
                         s_axi_rresp_next <= AXI4_RESP_NMOKAY;
                     else
@@ -308,6 +451,9 @@ begin
             if (aresetn = '0') then
                 s_axi_awid_reg    <= (others => '0');
                 s_axi_awaddr_reg  <= (others => '0');
+                s_axi_awlen_reg   <= (others => '0');
+                s_axi_awsize_reg  <= (others => '0');
+                s_axi_awburst_reg <= (others => '0');
                 s_axi_awprot_reg  <= (others => '0');
                 s_axi_awvalid_reg <= '0';
                 s_axi_awready     <= '1';
@@ -325,6 +471,9 @@ begin
             else
                 s_axi_awid_reg    <= s_axi_awid_reg_next   ;
                 s_axi_awaddr_reg  <= s_axi_awaddr_reg_next ;
+                s_axi_awlen_reg   <= s_axi_awlen_reg_next  ;
+                s_axi_awsize_reg  <= s_axi_awsize_reg_next ;
+                s_axi_awburst_reg <= s_axi_awburst_reg_next;
                 s_axi_awprot_reg  <= s_axi_awprot_reg_next ;
                 s_axi_awvalid_reg <= s_axi_awvalid_reg_next;
                 s_axi_awready     <= s_axi_awready_next    ;
@@ -345,18 +494,37 @@ begin
 
     GEN_REG_STORE : for i in 0 to NUM_OUTPUTS-1 generate
     begin
-        regs(8*i+7)(2) <= fifos_full(i) ;
-        regs(8*i+7)(1) <= fifos_empty(i);
+        regs(8*i+7)(4) <= fifos_almostfull(i) ;
+        regs(8*i+7)(3) <= fifos_almostempty(i);
+        regs(8*i+7)(2) <= fifos_full(i)       ;
+        regs(8*i+7)(1) <= fifos_empty(i)      ;
+
+        regs(8*i+7)(CFG_CLEAR_BIT) <= '0';
+
+        -- cores with a 16-bit bus have no room for the error counters
+        GEN_ERR_COUNTS : if (AXI_DATA_WIDTH >= CFG_UPPER_LSB) generate
+            regs(8*i+7)(CFG_OVERFLOWS_LSB+ERR_COUNT_WIDTH-1 downto CFG_OVERFLOWS_LSB)
+                <= std_logic_vector(fifos_overflows(i));
+            regs(8*i+7)(CFG_UNDERRUNS_LSB+ERR_COUNT_WIDTH-1 downto CFG_UNDERRUNS_LSB)
+                <= std_logic_vector(fifos_underruns(i));
+        end generate GEN_ERR_COUNTS;
 
         process (aclk) begin
             if (rising_edge(aclk)) then
                 if (aresetn = '0') then
-                    regs(8*i+7)(AXI_DATA_WIDTH-1 downto 3) <= (others => '0');
-                    regs(8*i+7)(0)                         <= '0';
-                    regs(8*i+6 downto 8*i)                 <= (others => (others => '0'));
+                    regs(8*i+7)(AXI_DATA_WIDTH-1 downto CFG_UPPER_LSB)
+                                                         <= (others => '0');
+                    regs(8*i+7)(CFG_OVERFLOWS_LSB-1 downto CFG_CLEAR_BIT+1)
+                                                         <= (others => '0');
+                    regs(8*i+7)(5)                       <= '0';
+                    regs(8*i+7)(0)                       <= '0';
+                    regs(8*i+6 downto 8*i)               <= (others => (others => '0'));
                 else
-                    regs(8*i+7)(AXI_DATA_WIDTH-1 downto 3)
-                                           <= regs_next(8*i+7)(AXI_DATA_WIDTH-1 downto 3);
+                    regs(8*i+7)(AXI_DATA_WIDTH-1 downto CFG_UPPER_LSB)
+                        <= regs_next(8*i+7)(AXI_DATA_WIDTH-1 downto CFG_UPPER_LSB);
+                    regs(8*i+7)(CFG_OVERFLOWS_LSB-1 downto CFG_CLEAR_BIT+1)
+                        <= regs_next(8*i+7)(CFG_OVERFLOWS_LSB-1 downto CFG_CLEAR_BIT+1);
+                    regs(8*i+7)(5)         <= regs_next(8*i+7)(5);
                     regs(8*i+7)(0)         <= regs_next(8*i+7)(0);
                     regs(8*i+6 downto 8*i) <= regs_next(8*i+6 downto 8*i);
                 end if;
@@ -364,6 +532,42 @@ begin
         end process;
     end generate GEN_REG_STORE;
 
+    -----------------------
+    -- Stream Data Input --
+    -----------------------
+
+    -- Each beat is written to the data FIFO of the output selected by TDEST, with TKEEP as its
+    -- byte mask. Beats addressed to a nonexistent output are accepted and dropped, and so is the
+    -- data of beats without any TKEEP bit set, although their TLAST still ends the frame.
+    axis_dest <= to_integer(unsigned(s_axis_tdest));
+
+    s_axis_tready <=
+        axis_treadys(axis_dest) when (axis_dest < NUM_OUTPUTS) else
+        '1';
+
+    ----------------------
+    -- Refill Interrupt --
+    ----------------------
+
+    -- Level-sensitive request from every enabled output whose FIFO dropped below the watermark
+    -- with its refill interrupt enable bit set.
+    GEN_REFILL_REQS : for i in 0 to NUM_OUTPUTS-1 generate
+    begin
+        refill_reqs(i) <= regs(8*i+7)(5) and regs(8*i+7)(0) and fifos_almostempty(i);
+    end generate GEN_REFILL_REQS;
+
+    process (aclk) begin
+        if (rising_edge(aclk)) then
+            if (aresetn = '0') then
+                irq <= '0';
+            elsif (unsigned(refill_reqs) /= 0) then
+                irq <= '1';
+            else
+                irq <= '0';
+            end if;
+        end if;
+    end process;
+
     ------------------------
     -- PWM Cell Instances --
     ------------------------
@@ -371,6 +575,7 @@ begin
     GEN_CELLS : for i in 0 to NUM_OUTPUTS-1 generate
         constant data_reg_addr       : integer := 8*i;
         constant data_bmask_reg_addr : integer := 8*i+1;
+        constant reset_gap_reg_addr  : integer := 8*i+2;
         constant period_reg_addr     : integer := 8*i+4;
         constant duty_hi_reg_addr    : integer := 8*i+5;
         constant duty_lo_reg_addr    : integer := 8*i+6;
@@ -380,6 +585,10 @@ begin
 
         constant FIFO_DATA_WIDTH : integer := AXI_DATA_WIDTH + BMASK_NUM_BITS;
 
+        -- An entry with no active bytes and its lowest data bit set marks the end of a frame.
+        constant EOF_MARKER : std_logic_vector(FIFO_DATA_WIDTH-1 downto 0) :=
+            (0 => '1', others => '0');
+
         signal cell_aresetn : std_logic;
 
         component xfifo_axis_rd is
@@ -431,9 +640,15 @@ begin
             );
         end component;
 
-        signal fifo_wren : std_logic;
-        signal fifo_di   : std_logic_vector(FIFO_DATA_WIDTH-1 downto 0);
-        signal fifo_full : std_logic;
+        signal axi_wren        : std_logic;
+        signal axi_wbmask      : std_logic_vector(BMASK_NUM_BITS-1 downto 0);
+        signal axi_wkeep       : std_logic;
+        signal axis_wren       : std_logic;
+        signal axis_wkeep      : std_logic;
+        signal fifo_wren       : std_logic;
+        signal fifo_di         : std_logic_vector(FIFO_DATA_WIDTH-1 downto 0);
+        signal fifo_full       : std_logic;
+        signal fifo_almostfull : std_logic;
 
         signal cell_s_axis_tdata  : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
         signal cell_s_axis_tstrb  : std_logic_vector(AXI_DATA_WIDTH/8-1 downto 0);
@@ -441,19 +656,84 @@ begin
         signal cell_s_axis_tvalid : std_logic;
         signal cell_s_axis_tready : std_logic;
 
-        signal fifo_rden  : std_logic;
-        signal fifo_do    : std_logic_vector(FIFO_DATA_WIDTH-1 downto 0);
-        signal fifo_empty : std_logic;
+        signal fifo_rden        : std_logic;
+        signal fifo_do          : std_logic_vector(FIFO_DATA_WIDTH-1 downto 0);
+        signal fifo_empty       : std_logic;
+        signal fifo_almostempty : std_logic;
+
+        signal fifo_wrcount   : std_logic_vector(FIFO_COUNT_WIDTH-1 downto 0);
+        signal fifo_wrerr     : std_logic;
+        signal in_frame       : std_logic;
+        signal starved        : std_logic;
+        signal underrun       : std_logic;
+        signal counters_clear : std_logic;
+        signal overflows      : unsigned(ERR_COUNT_WIDTH-1 downto 0);
+        signal underruns      : unsigned(ERR_COUNT_WIDTH-1 downto 0);
+
+        signal eof_pending      : std_logic;
+        signal eof_wren         : std_logic;
+        signal converter_tlast  : std_logic;
+
+        signal gap_pending      : std_logic;
+        signal gap_pending_next : std_logic;
+        signal gap_count        : unsigned(AXI_DATA_WIDTH-1 downto 0);
+        signal gap_count_next   : unsigned(AXI_DATA_WIDTH-1 downto 0);
     begin
         cell_aresetn <= regs(cfg_reg_addr)(0) and aresetn;
 
-        fifos_full(i)  <= fifo_full;
-        fifos_empty(i) <= fifo_empty;
+        fifos_full(i)        <= fifo_full;
+        fifos_empty(i)       <= fifo_empty;
+        fifos_almostfull(i)  <= fifo_almostfull;
+        fifos_almostempty(i) <= fifo_almostempty;
+
+        -- The write count wraps to zero when the FIFO is full.
+        fifos_level(i) <=
+            FIFO_FULL_LEVEL when (fifo_full = '1') else
+            resize(unsigned(fifo_wrcount), FIFO_COUNT_WIDTH+1);
+
+        fifos_overflows(i) <= overflows;
+        fifos_underruns(i) <= underruns;
 
-        fifo_wren <=
+        axi_wren <=
             s_axi_wvalid and s_axi_wready when (reg_index_from_awaddr_reg = data_reg_addr) else
             '0';
-        fifo_di <= regs(data_bmask_reg_addr)(BMASK_NUM_BITS-1 downto 0) & s_axi_wdata;
+
+        -- The stream yields to register writes of the same FIFO, and is not throttled by a
+        -- disabled output, whose FIFO is held in reset and drops all writes. A beat with TLAST
+        -- set is followed by an end-of-frame marker, written before the next beat is accepted.
+        axis_treadys(i) <= not (fifo_full or axi_wren or eof_pending) or not cell_aresetn;
+        axis_wren <=
+            s_axis_tvalid and axis_treadys(i) when (axis_dest = i) else
+            '0';
+        eof_wren  <= eof_pending and not (fifo_full or axi_wren);
+
+        process (aclk) begin
+            if (rising_edge(aclk)) then
+                if (cell_aresetn = '0' or eof_wren = '1') then
+                    eof_pending <= '0';
+                elsif (axis_wren = '1' and s_axis_tlast = '1') then
+                    eof_pending <= '1';
+                end if;
+            end if;
+        end process;
+
+        -- Words without active bytes would hold the line for a cycle each, and an empty beat
+        -- carrying the marker's data would end the frame early, so both are dropped. The only
+        -- register write queued without active bytes is the end-of-frame marker itself.
+        axi_wbmask <= regs(data_bmask_reg_addr)(BMASK_NUM_BITS-1 downto 0);
+        axi_wkeep  <=
+            '1' when (unsigned(axi_wbmask) /= 0) else
+            '1' when (axi_wbmask & s_axi_wdata = EOF_MARKER) else
+            '0';
+        axis_wkeep <=
+            '1' when (unsigned(s_axis_tkeep) /= 0) else
+            '0';
+
+        fifo_wren <= (axi_wren and axi_wkeep) or (axis_wren and axis_wkeep) or eof_wren;
+        fifo_di   <=
+            s_axis_tkeep & s_axis_tdata when (axis_wren = '1') else
+            EOF_MARKER                  when (eof_wren  = '1') else
+            axi_wbmask & s_axi_wdata;
 
         data_fifo : fifo_sync_macro
         generic map (
@@ -463,22 +743,22 @@ begin
             DATA_WIDTH          => FIFO_DATA_WIDTH, -- Valid values are 1-72 (37-72 only valid when FIFO_SIZE="36Kb")
             FIFO_SIZE           => "36Kb"           -- Target BRAM, "18Kb" or "36Kb"
         ) port map (
-            wren        => fifo_wren,       -- 1-bit input write enable
-            di          => fifo_di,         -- Input data, width defined by DATA_WIDTH parameter
-            almostfull  => open,            -- 1-bit output almost full
-            full        => fifo_full,       -- 1-bit output full
-            wrcount     => open,            -- Output write count, width determined by FIFO depth
-            wrerr       => open,            -- 1-bit output write error
-
-            rden        => fifo_rden,       -- 1-bit input read enable
-            do          => fifo_do,         -- Output data, width defined by DATA_WIDTH parameter
-            almostempty => open,            -- 1-bit output almost empty
-            empty       => fifo_empty,      -- 1-bit output empty
-            rdcount     => open,            -- Output read count, width determined by FIFO depth
-            rderr       => open,            -- 1-bit output read error
-
-            clk         => aclk,            -- 1-bit input clock
-            rst         => not cell_aresetn -- 1-bit input reset
+            wren        => fifo_wren,        -- 1-bit input write enable
+            di          => fifo_di,          -- Input data, width defined by DATA_WIDTH parameter
+            almostfull  => fifo_almostfull,  -- 1-bit output almost full
+            full        => fifo_full,        -- 1-bit output full
+            wrcount     => fifo_wrcount,     -- Output write count, width determined by FIFO depth
+            wrerr       => fifo_wrerr,       -- 1-bit output write error
+
+            rden        => fifo_rden,        -- 1-bit input read enable
+            do          => fifo_do,          -- Output data, width defined by DATA_WIDTH parameter
+            almostempty => fifo_almostempty, -- 1-bit output almost empty
+            empty       => fifo_empty,       -- 1-bit output empty
+            rdcount     => open,             -- Output read count, width determined by FIFO depth
+            rderr       => open,             -- 1-bit output read error
+
+            clk         => aclk,             -- 1-bit input clock
+            rst         => not cell_aresetn  -- 1-bit input reset
         );
 
         fifo_rden            <= converter_fifo_rden;
@@ -501,12 +781,111 @@ begin
             aresetn       => cell_aresetn
         );
 
+        converter_tlast <=
+            '1' when (converter_m_axis_tdata = EOF_MARKER) else
+            '0';
+
         cell_s_axis_tdata <= converter_m_axis_tdata(AXI_DATA_WIDTH-1 downto 0);
         cell_s_axis_tstrb <=
             converter_m_axis_tdata(FIFO_DATA_WIDTH-1 downto FIFO_DATA_WIDTH-BMASK_NUM_BITS);
-        cell_s_axis_tlast       <= '0';
-        cell_s_axis_tvalid      <= converter_m_axis_tvalid;
-        converter_m_axis_tready <= cell_s_axis_tready;
+        cell_s_axis_tlast       <= converter_tlast;
+        cell_s_axis_tvalid      <= converter_m_axis_tvalid and not gap_pending;
+        converter_m_axis_tready <= cell_s_axis_tready and not gap_pending;
+
+        --------------------
+        -- Error Counters --
+        --------------------
+
+        -- An output is mid-frame from the first data word it takes until the next end-of-frame
+        -- marker. The cell asking for a word while mid-frame and none being there stretches the
+        -- line and corrupts the frame, and is counted once per starvation.
+        underrun <= in_frame and cell_s_axis_tready and not (converter_m_axis_tvalid or starved);
+
+        process (aclk) begin
+            if (rising_edge(aclk)) then
+                if (cell_aresetn = '0') then
+                    in_frame <= '0';
+                    starved  <= '0';
+                elsif (converter_m_axis_tvalid = '1' and converter_m_axis_tready = '1') then
+                    in_frame <= not converter_tlast;
+                    starved  <= '0';
+                elsif (underrun = '1') then
+                    starved <= '1';
+                end if;
+            end if;
+        end process;
+
+        counters_clear <=
+            s_axi_wvalid and s_axi_wready and s_axi_wstrb(0) and s_axi_wdata(CFG_CLEAR_BIT)
+                when (reg_index_from_awaddr_reg = cfg_reg_addr) else
+            '0';
+
+        -- Writes refused by a full FIFO are counted, but not those dropped by a disabled output.
+        process (aclk) begin
+            if (rising_edge(aclk)) then
+                if (aresetn = '0' or counters_clear = '1') then
+                    overflows <= (others => '0');
+                    underruns <= (others => '0');
+                else
+                    if (fifo_wrerr = '1' and cell_aresetn = '1' and overflows /= ERR_COUNT_MAX) then
+                        overflows <= overflows + 1;
+                    end if;
+                    if (underrun = '1' and underruns /= ERR_COUNT_MAX) then
+                        underruns <= underruns + 1;
+                    end if;
+                end if;
+            end if;
+        end process;
+
+        ---------------
+        -- Reset Gap --
+        ---------------
+
+        -- Once an end-of-frame marker is handed to the cell, the following words are held back
+        -- until the line has stayed low for the number of cycles in the reset gap register. The
+        -- count restarts whenever the line is high, so it only completes after the last bit of
+        -- the frame, as long as the gap is longer than the low time of any bit. A gap of zero
+        -- disables the hold-off.
+        process (
+            converter_m_axis_tvalid,
+            cell_s_axis_tready     ,
+            converter_tlast        ,
+            gap_pending            ,
+            gap_count              ,
+            txd                    ,
+            regs
+        ) begin
+            gap_pending_next <= gap_pending;
+            gap_count_next   <= gap_count;
+
+            if (gap_pending = '1') then
+                if (txd(i) = '1') then
+                    gap_count_next <= (others => '0');
+                elsif (gap_count + 1 >= unsigned(regs(reset_gap_reg_addr))) then
+                    gap_pending_next <= '0';
+                else
+                    gap_count_next <= gap_count + 1;
+                end if;
+            elsif (
+                converter_m_axis_tvalid = '1' and cell_s_axis_tready = '1' and
+                converter_tlast = '1' and unsigned(regs(reset_gap_reg_addr)) /= 0
+            ) then
+                gap_pending_next <= '1';
+                gap_count_next   <= (others => '0');
+            end if;
+        end process;
+
+        process (aclk) begin
+            if (rising_edge(aclk)) then
+                if (cell_aresetn = '0') then
+                    gap_pending <= '0';
+                    gap_count   <= (others => '0');
+                else
+                    gap_pending <= gap_pending_next;
+                    gap_count   <= gap_count_next;
+                end if;
+            end if;
+        end process;
 
         cell : pw_bit_cell
         generic map (
@@ -7,13 +7,26 @@ entity periph_pw_bit is
         AXI_DATA_WIDTH : integer := 32;
         AXI_ADDR_WIDTH : integer := 8;
 
+        AXIS_DEST_WIDTH : integer := 4;
+
         NUM_OUTPUTS : integer := 4
     );
     port (
         txd : out std_logic_vector(NUM_OUTPUTS-1 downto 0);
+        irq : out std_logic;
+
+        s_axis_tdata  : in  std_logic_vector(AXI_DATA_WIDTH-1 downto 0)   := (others => '0');
+        s_axis_tkeep  : in  std_logic_vector(AXI_DATA_WIDTH/8-1 downto 0) := (others => '1');
+        s_axis_tlast  : in  std_logic := '0';
+        s_axis_tdest  : in  std_logic_vector(AXIS_DEST_WIDTH-1 downto 0)  := (others => '0');
+        s_axis_tvalid : in  std_logic := '0';
+        s_axis_tready : out std_logic;
 
         s_axi_awid    : in  std_logic_vector(AXI_ID_WIDTH-1 downto 0);
         s_axi_awaddr  : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+        s_axi_awlen   : in  std_logic_vector(7 downto 0);
+        s_axi_awsize  : in  std_logic_vector(2 downto 0);
+        s_axi_awburst : in  std_logic_vector(1 downto 0);
         s_axi_awprot  : in  std_logic_vector(2 downto 0);
         s_axi_awvalid : in  std_logic;
         s_axi_awready : out std_logic;
@@ -52,13 +65,26 @@ architecture arch of periph_pw_bit is
             AXI_DATA_WIDTH : integer := 32;
             AXI_ADDR_WIDTH : integer := 8;
 
+            AXIS_DEST_WIDTH : integer := 4;
+
             NUM_OUTPUTS : integer := 4
         );
         port (
             txd : out std_logic_vector(NUM_OUTPUTS-1 downto 0);
+            irq : out std_logic;
+
+            s_axis_tdata  : in  std_logic_vector(AXI_DATA_WIDTH-1 downto 0)   := (others => '0');
+            s_axis_tkeep  : in  std_logic_vector(AXI_DATA_WIDTH/8-1 downto 0) := (others => '1');
+            s_axis_tlast  : in  std_logic := '0';
+            s_axis_tdest  : in  std_logic_vector(AXIS_DEST_WIDTH-1 downto 0)  := (others => '0');
+            s_axis_tvalid : in  std_logic := '0';
+            s_axis_tready : out std_logic;
 
             s_axi_awid    : in  std_logic_vector(AXI_ID_WIDTH-1 downto 0);
             s_axi_awaddr  : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+            s_axi_awlen   : in  std_logic_vector(7 downto 0);
+            s_axi_awsize  : in  std_logic_vector(2 downto 0);
+            s_axi_awburst : in  std_logic_vector(1 downto 0);
             s_axi_awprot  : in  std_logic_vector(2 downto 0);
             s_axi_awvalid : in  std_logic;
             s_axi_awready : out std_logic;
@@ -96,12 +122,25 @@ begin
         AXI_DATA_WIDTH => AXI_DATA_WIDTH,
         AXI_ADDR_WIDTH => AXI_ADDR_WIDTH,
 
+        AXIS_DEST_WIDTH => AXIS_DEST_WIDTH,
+
         NUM_OUTPUTS => NUM_OUTPUTS
     ) port map (
         txd => txd,
+        irq => irq,
+
+        s_axis_tdata  => s_axis_tdata ,
+        s_axis_tkeep  => s_axis_tkeep ,
+        s_axis_tlast  => s_axis_tlast ,
+        s_axis_tdest  => s_axis_tdest ,
+        s_axis_tvalid => s_axis_tvalid,
+        s_axis_tready => s_axis_tready,
 
         s_axi_awid    => s_axi_awid   ,
         s_axi_awaddr  => s_axi_awaddr ,
+        s_axi_awlen   => s_axi_awlen  ,
+        s_axi_awsize  => s_axi_awsize ,
+        s_axi_awburst => s_axi_awburst,
         s_axi_awprot  => s_axi_awprot ,
         s_axi_awvalid => s_axi_awvalid,
         s_axi_awready => s_axi_awready,
@@ -5,8 +5,14 @@ module axi_pw_bit_tb();
     localparam AXI_DATA_WIDTH = 32;
     localparam AXI_ADDR_WIDTH = 8;
     
+    localparam AXIS_DEST_WIDTH = 4;
+    
     localparam NUM_OUTPUTS    = 4;
     
+    localparam STREAM_DEST    = 1;
+    localparam STREAM_BEATS   = 6;
+    localparam STREAM_PAUSE   = 20000;
+    
     localparam [31:0][AXI_DATA_WIDTH-1:0] regs_values = {
         32'd1  ,
         32'd40 ,
@@ -50,10 +56,24 @@ module axi_pw_bit_tb();
 
     integer reg_number;
     
+    integer stream_beat;
+    integer stream_cntdwn;
+    
     wire [NUM_OUTPUTS-1:0]      txd          ;
+    wire                        irq          ;
+    
+    reg  [AXI_DATA_WIDTH-1:0]   s_axis_tdata ;
+    reg  [AXI_DATA_WIDTH/8-1:0] s_axis_tkeep ;
+    reg                         s_axis_tlast ;
+    reg  [AXIS_DEST_WIDTH-1:0]  s_axis_tdest ;
+    reg                         s_axis_tvalid;
+    wire                        s_axis_tready;
     
     reg  [AXI_ID_WIDTH-1:0]     s_axi_awid   ;
     reg  [AXI_ADDR_WIDTH-1:0]   s_axi_awaddr ;
+    reg  [7:0]                  s_axi_awlen  ;
+    reg  [2:0]                  s_axi_awsize ;
+    reg  [1:0]                  s_axi_awburst;
     reg  [2:0]                  s_axi_awprot ;
     reg                         s_axi_awvalid;
     wire                        s_axi_awready;
@@ -88,12 +108,25 @@ module axi_pw_bit_tb();
         .AXI_DATA_WIDTH(AXI_DATA_WIDTH), // : integer := 32;
         .AXI_ADDR_WIDTH(AXI_ADDR_WIDTH), // : integer := 8;
                         
+        .AXIS_DEST_WIDTH(AXIS_DEST_WIDTH), // : integer := 4;
+                        
         .NUM_OUTPUTS   (NUM_OUTPUTS   )  // : integer := 4
     ) dut (
         .txd          (txd          ), // : out std_logic_vector(NUM_OUTPUTS-1 downto 0);
+        .irq          (irq          ), // : out std_logic;
+                       
+        .s_axis_tdata (s_axis_tdata ), // : in  std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+        .s_axis_tkeep (s_axis_tkeep ), // : in  std_logic_vector(AXI_DATA_WIDTH/8-1 downto 0);
+        .s_axis_tlast (s_axis_tlast ), // : in  std_logic;
+        .s_axis_tdest (s_axis_tdest ), // : in  std_logic_vector(AXIS_DEST_WIDTH-1 downto 0);
+        .s_axis_tvalid(s_axis_tvalid), // : in  std_logic;
+        .s_axis_tready(s_axis_tready), // : out std_logic;
                        
         .s_axi_awid   (s_axi_awid   ), // : in  std_logic_vector(AXI_ID_WIDTH-1 downto 0);
         .s_axi_awaddr (s_axi_awaddr ), // : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+        .s_axi_awlen  (s_axi_awlen  ), // : in  std_logic_vector(7 downto 0);
+        .s_axi_awsize (s_axi_awsize ), // : in  std_logic_vector(2 downto 0);
+        .s_axi_awburst(s_axi_awburst), // : in  std_logic_vector(1 downto 0);
         .s_axi_awprot (s_axi_awprot ), // : in  std_logic_vector(2 downto 0);
         .s_axi_awvalid(s_axi_awvalid), // : in  std_logic;
         .s_axi_awready(s_axi_awready), // : out std_logic;
@@ -133,9 +166,18 @@ module axi_pw_bit_tb();
 
         s_axi_awid    <= 0;
         s_axi_awaddr  <= 0;
+        s_axi_awlen   <= 0;
+        s_axi_awsize  <= 2;
+        s_axi_awburst <= 1;
         s_axi_awprot  <= 0;
         s_axi_awvalid <= 0;
         
+        s_axis_tdata  <= 0;
+        s_axis_tkeep  <= -1;
+        s_axis_tlast  <= 0;
+        s_axis_tdest  <= 0;
+        s_axis_tvalid <= 0;
+        
         s_axi_wdata   <= 0;
         s_axi_wstrb   <= -1;
         s_axi_wvalid  <= 0;
@@ -151,6 +193,9 @@ module axi_pw_bit_tb();
         
         reg_number    <= -1;
         
+        stream_beat   <= 0;
+        stream_cntdwn <= STREAM_PAUSE;
+        
         aclk          <= 1;
         aresetn       <= 0;
         
@@ -205,4 +250,32 @@ module axi_pw_bit_tb();
             init_done <= 0;
         end
     end
+    
+    // Stream frames to one output once it is configured: full beats, then a last beat with only
+    // its two low bytes kept, which must be followed by the end-of-frame reset gap.
+    always @(posedge(aclk)) begin
+        if (aresetn == 0 || init_done == 0) begin
+            stream_beat   <= 0;
+            stream_cntdwn <= STREAM_PAUSE;
+            s_axis_tvalid <= 0;
+        end else if (s_axis_tvalid == 1) begin
+            if (s_axis_tready == 1) begin
+                s_axis_tvalid <= 0;
+                stream_beat   <= stream_beat + 1;
+            end
+        end else if (stream_beat == STREAM_BEATS) begin
+            if (stream_cntdwn == 0) begin
+                stream_beat   <= 0;
+                stream_cntdwn <= STREAM_PAUSE;
+            end else begin
+                stream_cntdwn <= stream_cntdwn - 1;
+            end
+        end else begin
+            s_axis_tdata  <= 32'hA5000000 | (stream_beat << 16) | (stream_beat << 8) | stream_beat;
+            s_axis_tkeep  <= (stream_beat == STREAM_BEATS-1) ? 4'b0011 : 4'b1111;
+            s_axis_tlast  <= (stream_beat == STREAM_BEATS-1);
+            s_axis_tdest  <= STREAM_DEST;
+            s_axis_tvalid <= 1;
+        end
+    end
 endmodule
@@ -0,0 +1,151 @@
+#include <cstdint>
+
+#include <array>
+#include <bitset>
+
+#include <benchmark/benchmark.h>
+
+#include "periph_backend.hpp"
+#include "periph_pwm.hpp"
+#include "periph_pwm_plan.hpp"
+
+namespace {
+
+    /**
+     * A PWM peripheral backed by a page of shared RAM instead of device registers.
+     */
+    struct ram_pwm {
+        periph::device_map window{ "/dev/zero", 0, 4096 }; //!< The RAM-backed register window.
+        periph::pwm&       dev = window.at<periph::pwm>();  //!< The peripheral in the window.
+
+        /**
+         * Check that the register window was mapped, and fail the benchmark if not.
+         * 
+         * \param[in,out] state The benchmark state to report a failure to.
+         * 
+         * \retval true  The register window is mapped.
+         * \retval false Mapping the register window failed.
+         */
+        bool mapped( benchmark::State& state ) const {
+            if ( !window.valid() ) {
+                state.SkipWithError( "Mapping the RAM-backed register window failed" );
+            }
+
+            return window.valid();
+        }
+
+        /**
+         * Clear a pending update request, as the peripheral would at the end of a period.
+         */
+        void latch() {
+            window.at<volatile std::uint32_t>() = 0;
+        }
+    };
+
+    void bm_pwm_set_duty( benchmark::State& state ) {
+        ram_pwm      ram;
+        std::int32_t duty = 0;
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            ram.dev.set_duty<5>( duty++ );
+        }
+    }
+    BENCHMARK( bm_pwm_set_duty );
+
+    void bm_pwm_set_duty_all( benchmark::State& state ) {
+        ram_pwm      ram;
+        std::int32_t duty = 0;
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            ram.dev.set_duty_all( duty++ );
+            ram.latch();
+        }
+    }
+    BENCHMARK( bm_pwm_set_duty_all );
+
+    void bm_pwm_set_duty_scatter( benchmark::State& state ) {
+        ram_pwm                    ram;
+        std::array<std::int32_t,8> duties{};
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            duties[0]++;
+            ram.dev.set_duty( std::bitset<periph::num_outputs>( 0x81422418 ), duties );
+        }
+    }
+    BENCHMARK( bm_pwm_set_duty_scatter );
+
+    void bm_pwm_set_duty_masked( benchmark::State& state ) {
+        ram_pwm                    ram;
+        std::array<std::int32_t,8> duties{};
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            duties[0]++;
+            ram.dev.set_duty_masked<0x81422418>( duties );
+        }
+    }
+    BENCHMARK( bm_pwm_set_duty_masked );
+
+    void bm_pwm_set_polarity( benchmark::State& state ) {
+        ram_pwm ram;
+        bool    polarity = false;
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        for ( auto _ : state ) {
+            ram.dev.set_polarity<5>( polarity = !polarity );
+        }
+    }
+    BENCHMARK( bm_pwm_set_polarity );
+
+    void bm_pwm_plan( benchmark::State& state ) {
+        periph::pwm_plan                             plan;
+        std::array<std::int32_t,periph::num_outputs> duties{};
+
+        for ( auto _ : state ) {
+            duties[0]++;
+            benchmark::DoNotOptimize(
+                plan.plan( 100000, duties.size(), periph::pwm_align::midpulse, duties, duties[0] )
+            );
+            benchmark::DoNotOptimize( plan.image() );
+        }
+    }
+    BENCHMARK( bm_pwm_plan );
+
+    void bm_pwm_plan_apply( benchmark::State& state ) {
+        ram_pwm                                      ram;
+        periph::pwm_plan                             plan;
+        std::array<std::int32_t,periph::num_outputs> duties{};
+
+        if ( !ram.mapped( state ) ) {
+            return;
+        }
+
+        plan.plan( 100000, duties.size(), periph::pwm_align::midpulse, duties );
+        for ( auto _ : state ) {
+            duties[0]++;
+            plan.set_duties( duties );
+            ram.latch();
+            plan.apply( ram.dev );
+        }
+    }
+    BENCHMARK( bm_pwm_plan_apply );
+
+}
@@ -1,9 +1,621 @@
+#include <algorithm>
+
+#include "periph_trace.hpp"
+#ifdef PERIPH_SIM
+#include "periph_sim.hpp"
+#endif
 
 namespace periph {
 
+    namespace detail {
+
+        /**
+         * Find the index of the n-th set bit of a bitfield.
+         * 
+         * \param mask The bitfield to search.
+         * \param n    The zero-based rank of the set bit to find.
+         * 
+         * \return Returns the index of the n-th set bit, counting from the LSB.
+         */
+        constexpr std::size_t nth_set_bit( std::uint64_t mask, std::size_t n ) {
+            for ( ; n > 0; n-- ) {
+                mask &= mask - 1;
+            }
+
+            return std::countr_zero( mask );
+        }
+
+        namespace pwm_impl {
+
+            /**
+             * Bitwise access struct for PWM peripheral configuration register.
+             * 
+             * \tparam Word The type of a register.
+             */
+            template<typename Word>
+            struct cfg_reg {
+                volatile Word      load             : 1; //!< The output update request bit.
+                volatile pwm_align alignment        : 1; //!< The phase alignment mode bit.
+                volatile Word      seq_enable       : 1; //!< The waveform sequencer enable bit.
+                volatile Word      seq_empty        : 1; //!< The sequencer FIFO empty flag.
+                volatile Word      seq_full         : 1; //!< The sequencer FIFO full flag.
+                volatile Word      seq_almost_empty : 1; //!< The sequencer FIFO almost empty flag.
+                volatile Word      seq_almost_full  : 1; //!< The sequencer FIFO almost full flag.
+                volatile Word      RESERVED_0       : 8 * sizeof( Word ) - 7; //!< Reserved bits.
+            };
+
+            /**
+             * Register-wise access struct for individual PWM output configuration registers.
+             * 
+             * \tparam Word The type of a register.
+             */
+            template<typename Word>
+            struct output_cfg {
+                volatile std::make_signed_t<Word> duty;  //!< The duty time register.
+                volatile std::make_signed_t<Word> phase; //!< The phase offset register.
+            };
+
+            /**
+             * Register-wise access struct for memory-mapped PWM peripheral.
+             * 
+             * \tparam NumOutputs The number of PWM outputs.
+             * \tparam Word       The type of a register.
+             */
+            template<std::size_t NumOutputs, typename Word>
+            struct memory_map {
+                volatile cfg_reg<Word>                  config;   //!< Device-wide configuration.
+                volatile Word                           period;   //!< Device-wide pulse period.
+                volatile Word                           pol_map;  //!< Per-output polarities.
+                volatile Word                           seq_fifo; //!< Sequencer FIFO, ID on read.
+                volatile Word                           seq_mask; //!< Sequencer output mask.
+                volatile Word                           reserved; //!< Reserved, pads the outputs.
+                std::array<output_cfg<Word>,NumOutputs> outputs;  //!< Per-output registers.
+            };
+
+            constexpr std::size_t   reg_config        = 0;          //!< Index of the cfg register.
+            constexpr std::size_t   reg_period        = 1;          //!< Index of the period register.
+            constexpr std::size_t   reg_pol_map       = 2;          //!< Index of the polarity register.
+            constexpr std::size_t   reg_seq_fifo      = 3;          //!< Index of the sequencer FIFO.
+            constexpr std::size_t   reg_seq_mask      = 4;          //!< Index of the sequencer mask.
+            constexpr std::size_t   reg_outputs       = 6;          //!< Index of the first output.
+            constexpr std::uint32_t cfg_load_bit      = 0x00000001; //!< Update request bit.
+            constexpr std::uint32_t cfg_alignment_bit = 0x00000002; //!< Alignment bit.
+            constexpr std::uint32_t cfg_seq_empty_bit = 0x00000008; //!< Sequencer FIFO empty flag.
+            constexpr std::uint32_t cfg_seq_full_bit  = 0x00000010; //!< Sequencer FIFO full flag.
+            constexpr std::uint32_t cfg_seq_aempt_bit = 0x00000020; //!< Sequencer almost empty flag.
+            constexpr std::uint32_t cfg_seq_afull_bit = 0x00000040; //!< Sequencer almost full flag.
+            constexpr std::uint32_t cfg_status_bits   = 0x00000078; //!< Read-only status bits.
+
+            static_assert(
+                reg_seq_fifo * sizeof( std::uint32_t ) == sequencer_fifo_offset,
+                "Sequencer FIFO register offset mismatch"
+            );
+            static_assert(
+                reg_seq_fifo * sizeof( std::uint32_t ) == id_offset,
+                "Identification register offset mismatch"
+            );
+            static_assert( reg_outputs == header_regs, "Output register offset mismatch" );
+
+            /**
+             * Cast a memory-mapped register type to a normal data type.
+             * 
+             * \tparam T The normal type to cast to.
+             * 
+             * \param[in] val The value to cast.
+             * 
+             * \return Returns the original value cast to a normal type.
+             */
+            template<typename T>
+            T& normal_type( volatile T& val ) {
+                return const_cast<T&>( val );
+            }
+
+            /**
+             * Cast a PWM user class to a register memory map.
+             * 
+             * \param[in] dev The opaque user PWM class to cast.
+             * 
+             * \return Returns the memory-mapped registers corresponding to the opaque user class.
+             */
+            template<std::size_t N, std::size_t W>
+            memory_map<N,register_word<W>>& to_map( basic_pwm<N,W>& dev ) {
+                static_assert(
+                    sizeof( basic_pwm<N,W> ) == sizeof( memory_map<N,register_word<W>> ),
+                    "User handle and register memory map size mismatch"
+                );
+#ifdef PERIPH_SIM
+                sim::on_access( &dev );
+#endif
+                return *reinterpret_cast<memory_map<N,register_word<W>>*>( &dev );
+            }
+
+            /**
+             * Cast a read-only PWM user class to a register memory map.
+             * 
+             * \param[in] dev The read-only opaque user PWM class to cast.
+             * 
+             * \return Returns the read-only memory-mapped registers corresponding to the opaque
+             *         user class.
+             */
+            template<std::size_t N, std::size_t W>
+            const memory_map<N,register_word<W>>& to_map( const basic_pwm<N,W>& dev ) {
+#ifdef PERIPH_SIM
+                sim::on_access( &dev );
+#endif
+                return *reinterpret_cast<const memory_map<N,register_word<W>>*>( &dev );
+            }
+
+            /**
+             * Word-wise access array for memory-mapped PWM peripheral.
+             */
+            template<std::size_t N, std::size_t W>
+            using register_file = std::array<volatile register_word<W>,basic_pwm<N,W>::num_regs>;
+
+            /**
+             * Cast a PWM user class to an array of registers.
+             * 
+             * \param[in] dev The opaque user PWM class to cast.
+             * 
+             * \return Returns the memory-mapped registers corresponding to the opaque user class.
+             */
+            template<std::size_t N, std::size_t W>
+            register_file<N,W>& to_regs( basic_pwm<N,W>& dev ) {
+                static_assert(
+                    sizeof( basic_pwm<N,W> ) == sizeof( register_file<N,W> ),
+                    "User handle and register file size mismatch"
+                );
+#ifdef PERIPH_SIM
+                sim::on_access( &dev );
+#endif
+                return *reinterpret_cast<register_file<N,W>*>( &dev );
+            }
+
+            /**
+             * Cast a read-only PWM user class to an array of registers.
+             * 
+             * \param[in] dev The read-only opaque user PWM class to cast.
+             * 
+             * \return Returns the read-only memory-mapped registers corresponding to the opaque
+             *         user class.
+             */
+            template<std::size_t N, std::size_t W>
+            const register_file<N,W>& to_regs( const basic_pwm<N,W>& dev ) {
+#ifdef PERIPH_SIM
+                sim::on_access( &dev );
+#endif
+                return *reinterpret_cast<const register_file<N,W>*>( &dev );
+            }
+
+            /**
+             * Determine how many words can be queued to the sequencer FIFO without overflowing
+             * it.
+             * 
+             * \param status The value read from the configuration register.
+             * 
+             * \return Returns a lower bound on the free space in the sequencer FIFO, in words.
+             */
+            inline std::size_t sequencer_space( std::uint64_t status ) {
+                if ( status & cfg_seq_empty_bit ) {
+                    return sequencer_depth;
+                }
+                if ( status & cfg_seq_aempt_bit ) {
+                    return sequencer_depth - sequencer_watermark;
+                }
+                if ( !( status & cfg_seq_afull_bit ) ) {
+                    return sequencer_watermark;
+                }
+
+                return ( status & cfg_seq_full_bit ) ? 0 : 1;
+            }
+
+        }
+
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    basic_pwm<NumOutputs,DataWidth>& basic_pwm<NumOutputs,DataWidth>::operator=(
+        const basic_pwm& rhs
+    ) {
+        using namespace detail::pwm_impl;
+
+        auto&       dst = to_regs( *this );
+        const auto& src = to_regs( rhs );
+
+        // Every register but the sequencer FIFO write port, which would queue a stray duty time.
+        for ( std::size_t i = 0; i < num_regs; i++ ) {
+            if ( i != reg_seq_fifo ) {
+                dst[i] = src[i];
+            }
+        }
+        request_update();
+
+        return *this;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    basic_pwm<NumOutputs,DataWidth>& basic_pwm<NumOutputs,DataWidth>::operator=(
+        basic_pwm&& rhs
+    ) {
+        *this = rhs;
+        rhs.reset();
+
+        return *this;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::reset( void ) {
+        using namespace detail::pwm_impl;
+
+        auto& regs = to_regs( *this );
+
+        for ( std::size_t i = 0; i < num_regs; i++ ) {
+            if ( i != reg_seq_fifo ) {
+                regs[i] = 0;
+            }
+        }
+        request_update();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_period( value_type period ) {
+        detail::pwm_impl::to_map( *this ).period = period;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    template<std::size_t N>
+    void basic_pwm<NumOutputs,DataWidth>::set_polarity( bool polarity ) {
+        static_assert( ( N >= 0 ) && ( N < NumOutputs ), "Invalid PWM output index" );
+
+        auto pols = read_polarity_all();
+        pols.set( N, polarity );
+
+        set_polarity_all( pols );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    template<std::size_t N>
+    bool basic_pwm<NumOutputs,DataWidth>::read_polarity( void ) const {
+        static_assert( ( N >= 0 ) && ( N < NumOutputs ), "Invalid PWM output index" );
+
+        return read_polarity_all()[N];
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_polarity_all( mask_type polarity_map ) {
+        detail::pwm_impl::to_map( *this ).pol_map = polarity_map.to_ullong();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    typename basic_pwm<NumOutputs,DataWidth>::mask_type
+    basic_pwm<NumOutputs,DataWidth>::read_polarity_all( void ) const {
+        return detail::pwm_impl::normal_type( detail::pwm_impl::to_map( *this ).pol_map );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_polarity( std::size_t index, bool polarity ) {
+        if ( index >= NumOutputs ) {
+            return;
+        }
+
+        auto pols = read_polarity_all();
+        pols.set( index, polarity );
+
+        set_polarity_all( pols );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_polarity( mask_type mask, mask_type polarity_map ) {
+        set_polarity_all( ( read_polarity_all() & ~mask ) | ( polarity_map & mask ) );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_alignment( align mode ) {
+        detail::pwm_impl::to_map( *this ).config.alignment = mode;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    template<std::size_t N>
+    void basic_pwm<NumOutputs,DataWidth>::set_duty( value_type duty ) {
+        static_assert( ( N >= 0 ) && ( N < NumOutputs ), "Invalid PWM output index" );
+
+        set_duty_priv( N, duty );
+        request_update();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_duty( std::size_t index, value_type duty ) {
+        if ( index >= NumOutputs ) {
+            return;
+        }
+
+        set_duty_priv( index, duty );
+        request_update();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    std::size_t basic_pwm<NumOutputs,DataWidth>::set_duty(
+        mask_type                   mask,
+        std::span<const value_type> duties
+    ) {
+        auto&       outputs     = detail::pwm_impl::to_map( *this ).outputs;
+        std::size_t num_written = 0;
+        auto        bits        = mask.to_ullong();
+
+        // Visit only the set bits, clearing the lowest one on each step.
+        for ( ; ( bits != 0 ) && ( num_written < duties.size() ); bits &= bits - 1 ) {
+            outputs[std::countr_zero( bits )].duty = duties[num_written++];
+        }
+        trace::on_mmio_write( num_written );
+        request_update();
+
+        return num_written;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    template<std::uint64_t Mask>
+    void basic_pwm<NumOutputs,DataWidth>::set_duty_masked(
+        std::span<const value_type,std::popcount( Mask )> duties
+    ) {
+        static_assert( ( Mask >> ( NumOutputs - 1 ) >> 1 ) == 0, "Invalid PWM output mask" );
+
+        [&]<std::size_t... I>( std::index_sequence<I...> ) {
+            ( set_duty_priv( detail::nth_set_bit( Mask, I ), duties[I] ), ... );
+        }( std::make_index_sequence<std::popcount( Mask )>{} );
+        request_update();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_duty_all( value_type duty ) {
+        auto& outputs = detail::pwm_impl::to_map( *this ).outputs;
+
+        wait_update();
+        for ( auto& output : outputs ) {
+            output.duty = duty;
+        }
+        trace::on_mmio_write( NumOutputs );
+        request_update();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    template<std::size_t N>
+    void basic_pwm<NumOutputs,DataWidth>::set_phase( value_type phase ) {
+        static_assert( ( N >= 0 ) && ( N < NumOutputs ), "Invalid PWM output index" );
+
+        set_phase_priv( N, phase );
+        request_update();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_phase( std::size_t index, value_type phase ) {
+        if ( index >= NumOutputs ) {
+            return;
+        }
+
+        set_phase_priv( index, phase );
+        request_update();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    std::size_t basic_pwm<NumOutputs,DataWidth>::set_phase(
+        mask_type                   mask,
+        std::span<const value_type> phases
+    ) {
+        auto&       outputs     = detail::pwm_impl::to_map( *this ).outputs;
+        std::size_t num_written = 0;
+        auto        bits        = mask.to_ullong();
+        for ( ; ( bits != 0 ) && ( num_written < phases.size() ); bits &= bits - 1 ) {
+            outputs[std::countr_zero( bits )].phase = phases[num_written++];
+        }
+        trace::on_mmio_write( num_written );
+        request_update();
+
+        return num_written;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    template<std::uint64_t Mask>
+    void basic_pwm<NumOutputs,DataWidth>::set_phase_masked(
+        std::span<const value_type,std::popcount( Mask )> phases
+    ) {
+        static_assert( ( Mask >> ( NumOutputs - 1 ) >> 1 ) == 0, "Invalid PWM output mask" );
+
+        [&]<std::size_t... I>( std::index_sequence<I...> ) {
+            ( set_phase_priv( detail::nth_set_bit( Mask, I ), phases[I] ), ... );
+        }( std::make_index_sequence<std::popcount( Mask )>{} );
+        request_update();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_phase_all( value_type phase ) {
+        auto& outputs = detail::pwm_impl::to_map( *this ).outputs;
+
+        wait_update();
+        for ( auto& output : outputs ) {
+            output.phase = phase;
+        }
+        trace::on_mmio_write( NumOutputs );
+        request_update();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_outputs(
+        const std::array<std::pair<value_type,value_type>,NumOutputs>& outputs
+    ) {
+        wait_update();
+        write_outputs( 0, outputs );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    std::size_t basic_pwm<NumOutputs,DataWidth>::write_outputs(
+        std::size_t                                       first,
+        std::span<const std::pair<value_type,value_type>> outputs
+    ) {
+        if ( first >= NumOutputs ) {
+            return 0;
+        }
+
+        const std::size_t num_written = std::min( outputs.size(), NumOutputs - first );
+        auto              dst         = detail::pwm_impl::to_map( *this ).outputs.begin() + first;
+
+        for ( std::size_t i = 0; i < num_written; i++, dst++ ) {
+            dst->duty  = outputs[i].first;
+            dst->phase = outputs[i].second;
+        }
+        trace::on_mmio_write( output_regs * num_written );
+        request_update();
+
+        return num_written;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    bool basic_pwm<NumOutputs,DataWidth>::update_pending( void ) const {
+        return detail::pwm_impl::to_map( *this ).config.load;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_sequencer_mask( mask_type mask ) {
+        detail::pwm_impl::to_map( *this ).seq_mask = mask.to_ullong();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_sequencer_enabled( bool enable ) {
+        detail::pwm_impl::to_map( *this ).config.seq_enable = enable;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    std::size_t basic_pwm<NumOutputs,DataWidth>::enqueue_waveform(
+        std::span<const value_type> duties
+    ) {
+        using namespace detail::pwm_impl;
+
+        auto& map = to_map( *this );
+
+        const std::size_t num_queued =
+            std::min( duties.size(), sequencer_space( to_regs( *this )[reg_config] ) );
+
+        for ( std::size_t i = 0; i < num_queued; i++ ) {
+            const word value = duties[i];
+
+            map.seq_fifo = value;
+#ifdef PERIPH_SIM
+            sim::on_fifo_write( &map.seq_fifo, static_cast<std::uint32_t>( value ) );
+#endif
+        }
+        trace::on_mmio_write( num_queued );
+        if ( num_queued < duties.size() ) {
+            trace::on_full_stall( this );
+        }
+
+        return num_queued;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    bool basic_pwm<NumOutputs,DataWidth>::sequencer_empty( void ) const {
+        return detail::pwm_impl::to_map( *this ).config.seq_empty;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    bool basic_pwm<NumOutputs,DataWidth>::sequencer_almost_empty( void ) const {
+        return detail::pwm_impl::to_map( *this ).config.seq_almost_empty;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_duty_priv( std::size_t index, value_type duty ) {
+        detail::pwm_impl::to_map( *this ).outputs[index].duty = duty;
+        trace::on_mmio_write();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::set_phase_priv( std::size_t index, value_type phase ) {
+        detail::pwm_impl::to_map( *this ).outputs[index].phase = phase;
+        trace::on_mmio_write();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::request_update( void ) {
+        detail::pwm_impl::to_map( *this ).config.load = 1;
+        trace::on_mmio_write();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm<NumOutputs,DataWidth>::wait_update( void ) {
+        // Staging registers must not be latched half-written by an update that is still pending.
+        while ( update_pending() ) {
+            trace::on_full_stall( this );
+        }
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    basic_pwm_shadow<NumOutputs,DataWidth>::basic_pwm_shadow( device& dev ) :
+        dev( dev ),
+        regs{},
+        committed{}
+    {
+        sync();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::sync( void ) {
+        using namespace detail::pwm_impl;
+
+        const auto& hw = to_regs( dev );
+
+        for ( std::size_t i = 0; i < num_regs; i++ ) {
+            committed[i] = hw[i];
+        }
+        committed[reg_config] &= ~word{ cfg_load_bit | cfg_status_bits };
+        regs = committed;
+        dirty_map.reset();
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::commit( void ) {
+        using namespace detail::pwm_impl;
+
+        auto& hw = to_regs( dev );
+
+        bool outputs_dirty = false;
+        for ( std::size_t i = reg_outputs; i < num_regs; i++ ) {
+            outputs_dirty = outputs_dirty || dirty_map[i];
+        }
+        if ( outputs_dirty ) {
+            while ( dev.update_pending() ) {
+                trace::on_full_stall( &dev );
+            }
+        }
+
+        trace::on_mmio_write( dirty_map.count() + ( outputs_dirty ? 1 : 0 ) );
+        for ( std::size_t i = 0; dirty_map.any() && ( i < num_regs ); i++ ) {
+            if ( !dirty_map[i] ) {
+                continue;
+            }
+
+            // The configuration register also holds the update request and the sequencer enable,
+            // which the copy does not own, so only the alignment bit is merged into the live
+            // value, and a pending update stays pending.
+            if ( i == reg_config ) {
+                hw[i] = ( hw[i] & ~word{ cfg_alignment_bit } ) | ( regs[i] & cfg_alignment_bit );
+            } else {
+                hw[i] = regs[i];
+            }
+            committed[i] = regs[i];
+            dirty_map.reset( i );
+        }
+
+        if ( outputs_dirty ) {
+            hw[reg_config] = hw[reg_config] | cfg_load_bit;
+        }
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_period( value_type period ) {
+        store( detail::pwm_impl::reg_period, period );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
     template<std::size_t N>
-    void pwm::set_polarity( bool polarity ) {
-        static_assert( ( N >= 0 ) && ( N < num_outputs ), "Invalid PWM output index" );
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_polarity( bool polarity ) {
+        static_assert( ( N >= 0 ) && ( N < NumOutputs ), "Invalid PWM output index" );
 
         auto pols = read_polarity_all();
         pols.set( N, polarity );
@@ -11,25 +623,87 @@ namespace periph {
         set_polarity_all( pols );
     }
 
+    template<std::size_t NumOutputs, std::size_t DataWidth>
     template<std::size_t N>
-    bool pwm::read_polarity( void ) const {
-        static_assert( ( N >= 0 ) && ( N < num_outputs ), "Invalid PWM output index" );
+    bool basic_pwm_shadow<NumOutputs,DataWidth>::read_polarity( void ) const {
+        static_assert( ( N >= 0 ) && ( N < NumOutputs ), "Invalid PWM output index" );
 
         return read_polarity_all()[N];
     }
 
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_polarity_all( mask_type polarity_map ) {
+        store( detail::pwm_impl::reg_pol_map, polarity_map.to_ullong() );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    typename basic_pwm_shadow<NumOutputs,DataWidth>::mask_type
+    basic_pwm_shadow<NumOutputs,DataWidth>::read_polarity_all( void ) const {
+        return regs[detail::pwm_impl::reg_pol_map];
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_alignment( pwm_align mode ) {
+        using namespace detail::pwm_impl;
+
+        const word config = regs[reg_config] & ~word{ cfg_alignment_bit };
+
+        store(
+            reg_config,
+            ( mode == pwm_align::midpulse ) ? word( config | cfg_alignment_bit ) : config
+        );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
     template<std::size_t N>
-    void pwm::set_duty( std::int32_t duty ) {
-        static_assert( ( N >= 0 ) && ( N < num_outputs ), "Invalid PWM output index" );
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_duty( value_type duty ) {
+        static_assert( ( N >= 0 ) && ( N < NumOutputs ), "Invalid PWM output index" );
 
-        set_duty_priv( memory.outputs[N], duty );
+        set_duty_priv( N, duty );
     }
 
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_duty_all( value_type duty ) {
+        for ( std::size_t i = 0; i < NumOutputs; i++ ) {
+            set_duty_priv( i, duty );
+        }
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
     template<std::size_t N>
-    void pwm::set_phase( std::int32_t phase ) {
-        static_assert( ( N >= 0 ) && ( N < num_outputs ), "Invalid PWM output index" );
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_phase( value_type phase ) {
+        static_assert( ( N >= 0 ) && ( N < NumOutputs ), "Invalid PWM output index" );
+
+        set_phase_priv( N, phase );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_phase_all( value_type phase ) {
+        for ( std::size_t i = 0; i < NumOutputs; i++ ) {
+            set_phase_priv( i, phase );
+        }
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::store( std::size_t index, word value ) {
+        regs[index] = value;
+        dirty_map.set( index, value != committed[index] );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_duty_priv(
+        std::size_t index,
+        value_type  duty
+    ) {
+        store( detail::pwm_impl::reg_outputs + output_regs * index, duty );
+    }
 
-        set_phase_priv( memory.outputs[N], phase );
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_shadow<NumOutputs,DataWidth>::set_phase_priv(
+        std::size_t index,
+        value_type  phase
+    ) {
+        store( detail::pwm_impl::reg_outputs + output_regs * index + 1, phase );
     }
 
 }
@@ -0,0 +1,112 @@
+#include <algorithm>
+
+namespace periph {
+
+    namespace detail {
+
+        namespace pwm_impl {
+
+            /**
+             * The fraction bits of the fixed-point reciprocal phase offsets are divided with.
+             * 
+             * The dividends are below 64 * 64 and the rounded-up reciprocal of a phase count M errs
+             * by less than M / 2^20, so the quotients are exact and the products fit in 32 bits.
+             * This holds for up to 64 outputs, which basic_pwm_plan checks.
+             */
+            constexpr unsigned reciprocal_bits = 20;
+
+        }
+
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    basic_pwm_plan<NumOutputs,DataWidth>::basic_pwm_plan( void ) :
+        outputs{},
+        plan_period( 0 ),
+        num_phases( 0 ),
+        plan_mode( pwm_align::edge ),
+        stale( true )
+    {}
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    bool basic_pwm_plan<NumOutputs,DataWidth>::plan(
+        value_type                  period,
+        std::size_t                 phases,
+        pwm_align                   mode,
+        std::span<const value_type> duties,
+        value_type                  offset
+    ) {
+        using namespace detail::pwm_impl;
+
+        static_assert( NumOutputs <= 64, "Phase division by reciprocal is exact up to 64 outputs" );
+
+        if ( ( period <= 0 ) || ( phases == 0 ) || ( phases > NumOutputs ) ||
+             ( duties.size() != phases ) ) {
+            return false;
+        }
+
+        stale       = stale || ( period != plan_period ) || ( mode != plan_mode );
+        plan_period = period;
+        num_phases  = phases;
+        plan_mode   = mode;
+
+        // Output k is offset by k * ( period / phases ) + k * ( period % phases ) / phases, which
+        // cannot overflow. The second division is a multiplication with the reciprocal of the
+        // phase count, so that no output needs a division of its own.
+        const value_type    wrapped    = offset % period;
+        const word          base       = word( ( wrapped < 0 ) ? wrapped + period : wrapped );
+        const word          quotient   = word( period ) / phases;
+        const std::uint32_t remainder  = word( period ) % phases;
+        const std::uint32_t count      = phases;
+        const std::uint32_t reciprocal =
+            ( ( std::uint32_t{ 1 } << reciprocal_bits ) + phases - 1 ) / phases;
+
+        // Lanes are indexed with 32-bit integers, like the arithmetic on them, to vectorize.
+        for ( std::uint32_t k = 0; k < NumOutputs; k++ ) {
+            const std::uint32_t fraction = ( k * remainder * reciprocal ) >> reciprocal_bits;
+
+            // The base and the spread are each below the period, so one wrap always suffices.
+            const word spread = word( base + word( k ) * quotient + fraction );
+            const word phase  = ( spread >= word( period ) ) ? word( spread - period ) : spread;
+
+            outputs[k].second = ( k < count ) ? value_type( phase ) : value_type{ 0 };
+        }
+
+        plan_duties( duties );
+
+        return true;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    bool basic_pwm_plan<NumOutputs,DataWidth>::set_duties( std::span<const value_type> duties ) {
+        if ( ( num_phases == 0 ) || ( duties.size() != num_phases ) ) {
+            return false;
+        }
+
+        plan_duties( duties );
+
+        return true;
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_plan<NumOutputs,DataWidth>::apply( device& dev ) {
+        if ( stale ) {
+            dev.set_period( plan_period );
+            dev.set_alignment( plan_mode );
+            stale = false;
+        }
+
+        dev.set_outputs( outputs );
+    }
+
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    void basic_pwm_plan<NumOutputs,DataWidth>::plan_duties( std::span<const value_type> duties ) {
+        for ( std::size_t k = 0; k < num_phases; k++ ) {
+            outputs[k].first = std::clamp( duties[k], value_type{ 0 }, plan_period );
+        }
+        for ( std::size_t k = num_phases; k < NumOutputs; k++ ) {
+            outputs[k].first = 0;
+        }
+    }
+
+}
@@ -4,32 +4,83 @@
 #include <cstdint>
 #include <cstddef>
 
+#include <bit>
 #include <bitset>
 #include <array>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "periph_register.hpp"
+#include "periph_registry.hpp"
 
 namespace periph {
 
-    constexpr std::size_t header_size = 16; //!< The size of the PWM peripheral configuration block.
+    constexpr std::size_t header_regs = 6; //!< The registers of the PWM configuration block.
+    constexpr std::size_t output_regs = 2; //!< The registers controlling one PWM output.
+
+    constexpr std::size_t header_size = 24; //!< The size of the PWM peripheral configuration block.
     constexpr std::size_t output_size = 8;  //!< The size of a register block controlling one PWM.
-    constexpr std::size_t num_outputs = 32; //!< The number of hardware PWM outputs.
+    constexpr std::size_t num_outputs = 32; //!< The PWM outputs of the pwm alias.
+
+    /**
+     * The number of 32-bit registers in the PWM peripheral driven by the pwm alias.
+     */
+    constexpr std::size_t num_regs =
+        ( header_size + num_outputs * output_size ) / sizeof( std::uint32_t );
+
+    constexpr std::size_t sequencer_depth     = 1024; //!< Waveform sequencer FIFO depth, in words.
+    constexpr std::size_t sequencer_watermark = 128;  //!< Sequencer FIFO almost empty/full level.
+
+    /**
+     * The offset of the waveform sequencer FIFO register from the base of the PWM peripheral.
+     * 
+     * A DMA engine can stream a waveform table into the sequencer by writing to this register with
+     * fixed-address bursts.
+     */
+    constexpr std::size_t sequencer_fifo_offset = 0x0C;
+
+    /**
+     * The point to align the PWM phases at.
+     */
+    enum class pwm_align : bool {
+        edge     = 0, //!< Align all PWM outputs at a rising or falling edge.
+        midpulse = 1  //!< Align all PWM outputs at the midpoint between edges.
+    };
 
     /**
      * A block of multiple phase-aligned PWM outputs.
+     * 
+     * The register layout follows the NUM_OUTPUTS and AXI_DATA_WIDTH generics of axi_pwm, so that
+     * loops over all outputs are bounded at compile time and only registers that exist are
+     * touched. Polarities and sequencer selections are single registers, so a peripheral has at
+     * most as many outputs as its registers have bits.
+     * 
+     * \tparam NumOutputs The number of PWM outputs the peripheral was built with.
+     * \tparam DataWidth  The AXI data width the peripheral was built with: 16, 32 or 64 bits.
      */
-    class pwm {
+    template<std::size_t NumOutputs = num_outputs, std::size_t DataWidth = 32>
+    class basic_pwm {
+        static_assert(
+            ( NumOutputs > 0 ) && ( NumOutputs <= DataWidth ),
+            "Invalid number of PWM outputs"
+        );
+
         public:
+            using word       = register_word<DataWidth>;  //!< The type of a register.
+            using value_type = std::make_signed_t<word>;  //!< The type of periods, duties, phases.
+            using mask_type  = std::bitset<NumOutputs>;   //!< A bitfield with one bit per output.
+            using align      = pwm_align;                 //!< The point to align PWM phases at.
+
             /**
-             * The point to align the PWM phases at.
+             * The number of registers of the peripheral.
              */
-            enum class align : bool {
-                edge     = 0, //!< Align all PWM outputs at a rising or falling edge.
-                midpulse = 1  //!< Align all PWM outputs at the midpoint between edges.
-            };
+            static constexpr std::size_t num_regs = header_regs + NumOutputs * output_regs;
 
-            pwm() = delete;             //!< Disallow default construction.
-            ~pwm() = delete;            //!< Disallow destruction.
-            pwm( const pwm& ) = delete; //!< Disallow copy construction.
-            pwm( pwm&& ) = delete;      //!< Disallow move construction.
+            basic_pwm() = delete;                   //!< Disallow default construction.
+            ~basic_pwm() = delete;                  //!< Disallow destruction.
+            basic_pwm( const basic_pwm& ) = delete; //!< Disallow copy construction.
+            basic_pwm( basic_pwm&& ) = delete;      //!< Disallow move construction.
 
             /**
              * Copy the configuration of the given PWM peripheral to this PWM peripheral.
@@ -38,7 +89,7 @@ namespace periph {
              * 
              * \return Returns self-reference.
              */
-            pwm& operator=( const pwm& rhs ) = default;
+            basic_pwm& operator=( const basic_pwm& rhs );
 
             /**
              * Move the configuration of the given PWM peripheral to this PWM peripheral.
@@ -49,20 +100,27 @@ namespace periph {
              * 
              * \return Returns self-reference.
              */
-            pwm& operator=( pwm&& rhs );
+            basic_pwm& operator=( basic_pwm&& rhs );
 
             /**
              * Reset all PWM outputs, setting their frequencies to zero and pulling the outputs low.
              */
             void reset( void );
 
+            /**
+             * Read the number of PWM outputs the peripheral was built with.
+             * 
+             * \return Returns the number of PWM outputs.
+             */
+            static constexpr std::size_t size( void ) { return NumOutputs; }
+
             /**
              * Set the period of all PWM outputs.
              * 
              * \param period The period to configure the PWMs with, in number of PWM peripheral
              *               clock cycles.
              */
-            void set_period( std::int32_t period );
+            void set_period( value_type period );
 
             /**
              * Set the polarity of a single PWM output.
@@ -88,20 +146,39 @@ namespace periph {
             template<std::size_t N>
             bool read_polarity( void ) const;
 
+            /**
+             * Set the polarity of a single PWM output selected at runtime.
+             * 
+             * \param index    The index of the PWM output to set the polarity of. Out-of-range
+             *                 indices are ignored.
+             * \param polarity The polarity to set the given PWM output to.
+             */
+            void set_polarity( std::size_t index, bool polarity );
+
+            /**
+             * Set the polarities of a selection of PWM outputs.
+             * 
+             * The polarity register is read and written once, however many outputs are selected.
+             * 
+             * \param mask         Bitfield selecting the PWM outputs to set the polarity of.
+             * \param polarity_map Bitfield specifying the polarity of each selected output.
+             */
+            void set_polarity( mask_type mask, mask_type polarity_map );
+
             /**
              * Set the polarities of all PWM outputs.
              * 
              * \param polarity_map Bitfield specifying the polarity of each output. The LSB
              *                     corresponds to the output with index zero.
              */
-            void set_polarity_all( std::bitset<num_outputs> polarity_map );
+            void set_polarity_all( mask_type polarity_map );
 
             /**
              * Read the polarities of all PWM outputs.
              * 
              * \return Returns the polarities of all PWM outputs.
              */
-            std::bitset<num_outputs> read_polarity_all( void ) const;
+            mask_type read_polarity_all( void ) const;
 
             /**
              * Set the phase alignment mode applying to all PWM outputs.
@@ -113,85 +190,470 @@ namespace periph {
             /**
              * Set the duty time of a single PWM output.
              * 
+             * The new duty time takes effect at the end of the current PWM period.
+             * 
              * \tparam N The index of the PWM output to set the duty time of.
              * 
              * \param duty Duty time to configure the specified PWM output with, in number of PWM
              *             peripheral clock cycles.
              */
             template<std::size_t N>
-            void set_duty( std::int32_t duty );
+            void set_duty( value_type duty );
+
+            /**
+             * Set the duty time of a single PWM output selected at runtime.
+             * 
+             * \param index The index of the PWM output to set the duty time of. Out-of-range
+             *              indices are ignored.
+             * \param duty  Duty time to configure the specified PWM output with, in number of PWM
+             *              peripheral clock cycles.
+             */
+            void set_duty( std::size_t index, value_type duty );
+
+            /**
+             * Set the duty times of a selection of PWM outputs in one pass.
+             * 
+             * Only the selected outputs are written, in ascending index order, and they switch to
+             * their new duty times together at the end of the current PWM period.
+             * 
+             * \param mask   Bitfield selecting the PWM outputs to set the duty time of.
+             * \param duties The duty times of the selected outputs, in ascending output order.
+             * 
+             * \return Returns the number of PWM outputs written. This is less than the number of
+             *         selected outputs if \a duties is too short.
+             */
+            std::size_t set_duty(
+                mask_type                   mask,
+                std::span<const value_type> duties
+            );
+
+            /**
+             * Set the duty times of a selection of PWM outputs known at compile time.
+             * 
+             * Behaves like set_duty( mask_type, std::span<const value_type> ),
+             * but the selection is resolved at compile time and the number of duty times is
+             * checked against it.
+             * 
+             * \tparam Mask Bitfield selecting the PWM outputs to set the duty time of.
+             * 
+             * \param duties The duty times of the selected outputs, in ascending output order.
+             */
+            template<std::uint64_t Mask>
+            void set_duty_masked( std::span<const value_type,std::popcount( Mask )> duties );
 
             /**
              * Set the duty time of all PWM outputs.
              * 
+             * Waits for any previously requested update to be applied first, so that all outputs
+             * switch to the new duty time together at the end of the current PWM period.
+             * 
              * \param duty Duty time to configure all PWM outputs with, in number of PWM peripheral
              *             clock cycles.
              */
-            void set_duty_all( std::int32_t duty );
+            void set_duty_all( value_type duty );
 
             /**
              * Set the phase offset the specified PWM output.
              * 
              * Phase offsets are set relative to the global pulse period, set using
-             * set_period( std::int32_t ). When the global pulse alignment mode is set to
+             * set_period( value_type ). When the global pulse alignment mode is set to
              * align::edge, a zero phase offset sets the signal's leading edge to coincide with the
              * beginning of each period. When the global pulse alignment mode is set to
              * align::midpulse, a zero phase offset sets the midpoint between the signal's edges at
-             * the middle of each period.
+             * the middle of each period. A basic_pwm_plan computes the phase offsets of evenly
+             * interleaved multiphase outputs in either mode.
+             * 
+             * The new phase offset takes effect at the end of the current PWM period.
              * 
              * \tparam N The index of the PWM output to set the phase offset of.
              * 
              * \param phase The phase offset to apply to the given PWM output.
              */
             template<std::size_t N>
-            void set_phase( std::int32_t phase );
+            void set_phase( value_type phase );
+
+            /**
+             * Set the phase offset of a single PWM output selected at runtime.
+             * 
+             * \param index The index of the PWM output to set the phase offset of. Out-of-range
+             *              indices are ignored.
+             * \param phase The phase offset to apply to the given PWM output.
+             */
+            void set_phase( std::size_t index, value_type phase );
+
+            /**
+             * Set the phase offsets of a selection of PWM outputs in one pass.
+             * 
+             * Only the selected outputs are written, in ascending index order, and they switch to
+             * their new phase offsets together at the end of the current PWM period.
+             * 
+             * \param mask   Bitfield selecting the PWM outputs to set the phase offset of.
+             * \param phases The phase offsets of the selected outputs, in ascending output order.
+             * 
+             * \return Returns the number of PWM outputs written. This is less than the number of
+             *         selected outputs if \a phases is too short.
+             */
+            std::size_t set_phase(
+                mask_type                   mask,
+                std::span<const value_type> phases
+            );
+
+            /**
+             * Set the phase offsets of a selection of PWM outputs known at compile time.
+             * 
+             * \tparam Mask Bitfield selecting the PWM outputs to set the phase offset of.
+             * 
+             * \param phases The phase offsets of the selected outputs, in ascending output order.
+             */
+            template<std::uint64_t Mask>
+            void set_phase_masked( std::span<const value_type,std::popcount( Mask )> phases );
 
             /**
              * Set the phase offset of all PWM outputs.
              * 
              * Applies the same phase offset, relative to the global pulse period set using
-             * set_period( std::int32_t ), to all PWM outputs. This effectively phase-aligns all PWM
+             * set_period( value_type ), to all PWM outputs. This effectively phase-aligns all PWM
              * outputs with each other regardless of the value passed in.
              * 
+             * Waits for any previously requested update to be applied first, so that all outputs
+             * switch to the new phase offset together at the end of the current PWM period.
+             * 
              * \param phase The phase offset to apply to all PWM outputs.
              */
-            void set_phase_all( std::int32_t phase );
+            void set_phase_all( value_type phase );
+
+            /**
+             * Set the duty time and phase offset of a range of consecutive PWM outputs.
+             * 
+             * The duty and phase registers of the range are written as one contiguous run of
+             * stores in ascending address order, with no reads in between, so that a
+             * write-combining mapping of the peripheral can merge them into a single AXI burst.
+             * A single latched update is requested afterwards.
+             * 
+             * \param first   The index of the first PWM output to write.
+             * \param outputs The duty time and phase offset of each PWM output, in that order.
+             * 
+             * \return Returns the number of PWM outputs written. Outputs beyond the last PWM
+             *         output are not written.
+             */
+            std::size_t write_outputs(
+                std::size_t                                            first,
+                std::span<const std::pair<value_type,value_type>> outputs
+            );
+
+            /**
+             * Set the duty time and phase offset of every PWM output in one latched update.
+             * 
+             * Waits for any previously requested update to be applied, stages all duty and phase
+             * registers, then requests a single update. All outputs switch to the new values
+             * together at the end of the current PWM period, so no period is ever generated from
+             * a mix of old and new values.
+             * 
+             * \param outputs The duty time and phase offset of each PWM output, in that order.
+             */
+            void set_outputs(
+                const std::array<std::pair<value_type,value_type>,NumOutputs>& outputs
+            );
+
+            /**
+             * Check whether or not staged duty and phase values are still waiting to take effect.
+             * 
+             * \retval true  An update is pending until the end of the current PWM period.
+             * \retval false All staged values are in effect.
+             */
+            bool update_pending( void ) const;
+
+            /**
+             * Request the staged duty and phase registers to take effect at the end of the
+             * current PWM period.
+             * 
+             * All setters request an update themselves. Requesting one with nothing newly staged
+             * changes no output, and marks the end of the current period: update_pending() reads
+             * false from then on.
+             */
+            void request_update( void );
+
+            /**
+             * Select the PWM outputs whose duty times are driven by the waveform sequencer.
+             * 
+             * \param mask Bitfield selecting the PWM outputs fed from the sequencer FIFO.
+             */
+            void set_sequencer_mask( mask_type mask );
 
-        private:
             /**
-             * Size-equivalent stand-in for registers controlling a single PWM output.
+             * Enable or disable the waveform sequencer.
+             * 
+             * While enabled, the sequencer collects one frame of duty times from its FIFO, one per
+             * output selected with set_sequencer_mask( mask_type ), and applies the frame to those
+             * outputs at the end of the current PWM period. A frame is thus applied every period
+             * without software involvement for as long as the FIFO holds data. When the FIFO runs
+             * dry, the outputs keep their last duty times. Disabling the sequencer discards the
+             * contents of its FIFO.
+             * 
+             * \param enable Whether to enable or disable the sequencer.
              */
-            using output = std::array<volatile std::byte,output_size>;
+            void set_sequencer_enabled( bool enable );
 
+            /**
+             * Queue a precomputed waveform table to the waveform sequencer.
+             * 
+             * The table consists of consecutive frames, each holding the duty times of the outputs
+             * selected with set_sequencer_mask( mask_type ), in ascending output order. Queueing
+             * stops once the sequencer FIFO may be full; the remainder of the table can be queued
+             * once the FIFO has drained. The sequencer must be enabled, or the values written are
+             * discarded.
+             * 
+             * \param duties The duty times to queue, in number of PWM peripheral clock cycles.
+             * 
+             * \return Returns the number of duty times queued.
+             */
+            std::size_t enqueue_waveform( std::span<const value_type> duties );
+
+            /**
+             * Check whether or not the waveform sequencer FIFO is empty.
+             * 
+             * \retval true  The sequencer FIFO holds no more duty times.
+             * \retval false The sequencer FIFO holds duty times to apply.
+             */
+            bool sequencer_empty( void ) const;
+
+            /**
+             * Check whether or not the waveform sequencer FIFO is due for a refill.
+             * 
+             * \retval true  The sequencer FIFO holds no more than sequencer_watermark duty times.
+             * \retval false The sequencer FIFO holds more than sequencer_watermark duty times.
+             */
+            bool sequencer_almost_empty( void ) const;
+
+        private:
             /**
              * Size-equivalent stand-in for all memory-mapped registers in this peripheral device.
              */
-            struct {
-                std::array<volatile std::byte,header_size> header;  //!< Global configuration registers.
-                std::array<output,num_outputs>             outputs; //!< Individual output registers.
-            } memory;
+            std::array<volatile std::byte,num_regs*sizeof( word )> memory;
+
+            /**
+             * Set the duty time of the given PWM output, without requesting an update.
+             * 
+             * \param index The index of the PWM output to set the duty time of.
+             * \param duty  The duty time to configure the PWM output with.
+             */
+            void set_duty_priv( std::size_t index, value_type duty );
+
+            /**
+             * Set the phase offset of the given PWM output, without requesting an update.
+             * 
+             * \param index The index of the PWM output to set the phase offset of.
+             * \param phase The phase offset to configure the PWM output with.
+             */
+            void set_phase_priv( std::size_t index, value_type phase );
+
+            /**
+             * Wait until any previously requested update was applied.
+             */
+            void wait_update( void );
+    };
+
+    /**
+     * A RAM copy of the registers of a PWM peripheral, buffering configuration changes.
+     * 
+     * Setters only update the copy and mark registers whose value differs from the hardware as
+     * dirty. Nothing is written to the peripheral until commit() is called, which writes each
+     * dirty register exactly once. Per-output polarity changes are thus coalesced into a single
+     * polarity register write, and setting a register to the value it already holds costs no bus
+     * transaction at all.
+     * 
+     * The copy assumes it is the only writer of the peripheral. After the peripheral is written
+     * through any other path, sync() must be called to reload the copy.
+     * 
+     * \tparam NumOutputs The number of PWM outputs the peripheral was built with.
+     * \tparam DataWidth  The AXI data width the peripheral was built with: 16, 32 or 64 bits.
+     */
+    template<std::size_t NumOutputs = num_outputs, std::size_t DataWidth = 32>
+    class basic_pwm_shadow {
+        public:
+            using device     = basic_pwm<NumOutputs,DataWidth>; //!< The shadowed peripheral type.
+            using word       = typename device::word;           //!< The type of a register.
+            using value_type = typename device::value_type;     //!< The type of register values.
+            using mask_type  = typename device::mask_type;      //!< A bitfield of all outputs.
+
+            /**
+             * Create a shadow copy of the given PWM peripheral, loaded with its current registers.
+             * 
+             * \param[in] dev The PWM peripheral to shadow. The peripheral must outlive the copy.
+             */
+            explicit basic_pwm_shadow( device& dev );
+
+            /**
+             * Reload all registers from the peripheral, discarding any uncommitted changes.
+             */
+            void sync( void );
+
+            /**
+             * Write all dirty registers to the peripheral, in ascending address order.
+             * 
+             * If any duty or phase register is dirty, waits for any previously requested update to
+             * be applied first, and requests a single latched update of all outputs afterwards.
+             * Of the configuration register, only the alignment is written, so that the sequencer
+             * enable and any pending update request set on the peripheral are kept.
+             */
+            void commit( void );
 
             /**
-             * Set the duty time of the given PWM output.
+             * Check whether or not there are uncommitted changes.
              * 
-             * \param[out] signal The memory-mapped register block corresponding to the PWM output
-             *                    to set the duty time of.
-             * \param      duty   The duty time to configure the PWM output with.
+             * \retval true  At least one register differs from the peripheral.
+             * \retval false The copy matches the peripheral.
              */
-            void set_duty_priv( output& signal, std::int32_t duty );
+            bool dirty( void ) const { return dirty_map.any(); }
 
             /**
-             * Set the phase offset of the given PWM output.
+             * Set the period of all PWM outputs.
              * 
-             * \param[out] signal The memory-mapped register block corresponding to the PWM output
-             *                    to set the phase offset of.
-             * \param      phase  The phase offset to configure the PWM output with.
+             * \param period The period to configure the PWMs with, in number of PWM peripheral
+             *               clock cycles.
              */
-            void set_phase_priv( output& signal, std::int32_t phase );
+            void set_period( value_type period );
+
+            /**
+             * Set the polarity of a single PWM output.
+             * 
+             * \tparam N The index of the PWM output to set the polarity of.
+             * 
+             * \param polarity The polarity to set the given PWM output to.
+             */
+            template<std::size_t N>
+            void set_polarity( bool polarity );
+
+            /**
+             * Read the polarity of a single PWM output from the copy.
+             * 
+             * \tparam N The index of the PWM output to read the polarity of.
+             * 
+             * \retval true  The polarity of the PWM signal is high.
+             * \retval false The polarity of the PWM signal is low.
+             */
+            template<std::size_t N>
+            bool read_polarity( void ) const;
+
+            /**
+             * Set the polarities of all PWM outputs.
+             * 
+             * \param polarity_map Bitfield specifying the polarity of each output. The LSB
+             *                     corresponds to the output with index zero.
+             */
+            void set_polarity_all( mask_type polarity_map );
+
+            /**
+             * Read the polarities of all PWM outputs from the copy.
+             * 
+             * \return Returns the polarities of all PWM outputs.
+             */
+            mask_type read_polarity_all( void ) const;
+
+            /**
+             * Set the phase alignment mode applying to all PWM outputs.
+             * 
+             * \param mode The phase alignment mode to use to align all PWM outputs.
+             */
+            void set_alignment( pwm_align mode );
+
+            /**
+             * Set the duty time of a single PWM output.
+             * 
+             * \tparam N The index of the PWM output to set the duty time of.
+             * 
+             * \param duty Duty time to configure the specified PWM output with, in number of PWM
+             *             peripheral clock cycles.
+             */
+            template<std::size_t N>
+            void set_duty( value_type duty );
+
+            /**
+             * Set the duty time of all PWM outputs.
+             * 
+             * \param duty Duty time to configure all PWM outputs with, in number of PWM peripheral
+             *             clock cycles.
+             */
+            void set_duty_all( value_type duty );
+
+            /**
+             * Set the phase offset of a single PWM output.
+             * 
+             * \tparam N The index of the PWM output to set the phase offset of.
+             * 
+             * \param phase The phase offset to apply to the given PWM output.
+             */
+            template<std::size_t N>
+            void set_phase( value_type phase );
+
+            /**
+             * Set the phase offset of all PWM outputs.
+             * 
+             * \param phase The phase offset to apply to all PWM outputs.
+             */
+            void set_phase_all( value_type phase );
+
+        private:
+            static constexpr std::size_t num_regs = device::num_regs; //!< Registers of the device.
+
+            device&                   dev;       //!< The shadowed peripheral.
+            std::array<word,num_regs> regs;      //!< The pending register values.
+            std::array<word,num_regs> committed; //!< The register values in the peripheral.
+            std::bitset<num_regs>     dirty_map; //!< Registers differing from the peripheral.
+
+            /**
+             * Update a register in the copy, marking it dirty if it differs from the peripheral.
+             * 
+             * \param index The index of the register to update.
+             * \param value The new value of the register.
+             */
+            void store( std::size_t index, word value );
+
+            /**
+             * Set the duty time of the PWM output with the given index.
+             * 
+             * \param index The index of the PWM output.
+             * \param duty  The duty time to configure the PWM output with.
+             */
+            void set_duty_priv( std::size_t index, value_type duty );
+
+            /**
+             * Set the phase offset of the PWM output with the given index.
+             * 
+             * \param index The index of the PWM output.
+             * \param phase The phase offset to configure the PWM output with.
+             */
+            void set_phase_priv( std::size_t index, value_type phase );
     };
 
 }
 
+namespace periph {
+
+    /**
+     * Registry properties of the PWM driver, one handle driving a whole core.
+     */
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    struct device_traits<basic_pwm<NumOutputs,DataWidth>> {
+        static constexpr device_type   type          = device_type::pwm; //!< The driven core type.
+        static constexpr std::uint32_t version       = 2;                //!< Register map version.
+        static constexpr std::size_t   output_stride = 0;                //!< One handle per core.
+        static constexpr std::size_t   num_outputs   = NumOutputs;       //!< Outputs of the core.
+        static constexpr std::size_t   data_width    = DataWidth;        //!< Register width.
+    };
+
+    using pwm        = basic_pwm<>;        //!< A 32-bit PWM peripheral with num_outputs outputs.
+    using pwm_shadow = basic_pwm_shadow<>; //!< A shadow copy of a pwm.
+
+}
+
 #include "periph_pwm.ipp"
 
+namespace periph {
+
+    extern template class basic_pwm<>;
+    extern template class basic_pwm_shadow<>;
+
+}
+
 #endif // #ifndef PHERIH_PWM_HPP
@@ -0,0 +1,86 @@
+#ifndef PERIPH_PWM_ASYNC_HPP
+#define PERIPH_PWM_ASYNC_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include "periph_pwm.hpp"
+#include "periph_reactor.hpp"
+
+namespace periph {
+
+    /**
+     * An awaitable end of the current period of a PWM peripheral.
+     * 
+     * The end of a period is only visible as a latched update being applied, so an update is
+     * requested if none is pending. As all setters request updates themselves, this latches no
+     * value that was not already meant to take effect. The PWM peripheral raises no interrupt, so
+     * the reactor polls the operation on every pass while it is suspended.
+     * 
+     * \tparam NumOutputs The number of PWM outputs the peripheral was built with.
+     * \tparam DataWidth  The AXI data width the peripheral was built with: 16, 32 or 64 bits.
+     */
+    template<std::size_t NumOutputs = num_outputs, std::size_t DataWidth = 32>
+    class period_end : public reactor::operation {
+        public:
+            using device = basic_pwm<NumOutputs,DataWidth>; //!< The awaited peripheral.
+
+            /**
+             * Create a wait for the end of the current period.
+             * 
+             * \param[in,out] io  The reactor to suspend on.
+             * \param[in,out] dev The peripheral to wait for.
+             */
+            period_end( reactor& io, device& dev ) :
+                operation( io, false ),
+                dev( dev ),
+                requested( false )
+            {}
+
+        private:
+            device& dev;       //!< The peripheral waited for.
+            bool    requested; //!< Whether an update is known to be pending.
+
+            /**
+             * Check whether or not the update pending at the first call was applied.
+             * 
+             * \retval true  The period ended.
+             * \retval false The period continues.
+             */
+            bool poll( void ) override {
+                if ( !requested ) {
+                    if ( !dev.update_pending() ) {
+                        dev.request_update();
+                    }
+                    requested = true;
+
+                    return false;
+                }
+
+                return !dev.update_pending();
+            }
+    };
+
+    /**
+     * Wait from a coroutine until the current period of a PWM peripheral ends, as in
+     * co_await next_period( io, dev ).
+     * 
+     * Values staged before are in effect once resumed, so staging the next values right after
+     * leaves a whole period to do so.
+     * 
+     * \param[in,out] io  The reactor to suspend on.
+     * \param[in,out] dev The peripheral to wait for.
+     * 
+     * \return Returns the awaitable end of period.
+     */
+    template<std::size_t NumOutputs, std::size_t DataWidth>
+    period_end<NumOutputs,DataWidth> next_period(
+        reactor&                         io,
+        basic_pwm<NumOutputs,DataWidth>& dev
+    ) {
+        return period_end<NumOutputs,DataWidth>( io, dev );
+    }
+
+}
+
+#endif // #ifndef PERIPH_PWM_ASYNC_HPP
@@ -0,0 +1,122 @@
+#ifndef PERIPH_PWM_CELL_HPP
+#define PERIPH_PWM_CELL_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+namespace periph::sim {
+
+    /**
+     * Cycle-accurate model of the period counter of axi_pwm.
+     * 
+     * In edge-aligned mode the counter counts up from zero to the period minus one. In midpulse
+     * mode it counts up to half the period and back down, with the direction register lagging
+     * one cycle behind as in the HDL, so that the counter overshoots both turning points by one.
+     */
+    class pwm_counter {
+        public:
+            /**
+             * Check whether or not the current cycle ends a period.
+             * 
+             * \param period   The period register.
+             * \param midpulse Whether the counter runs in midpulse-aligned mode.
+             * 
+             * \retval true  The staged registers are latched at the end of this cycle.
+             * \retval false The period continues.
+             */
+            bool period_end( std::int64_t period, bool midpulse ) const {
+                return midpulse ? ( ( count <= 0 ) && !up ) : ( count >= period - 1 );
+            }
+
+            /**
+             * Simulate a single clock cycle.
+             * 
+             * \param period   The period register.
+             * \param midpulse Whether the counter runs in midpulse-aligned mode.
+             */
+            void step( std::int64_t period, bool midpulse ) {
+                if ( midpulse ) {
+                    bool up_next = up;
+                    if ( count <= 0 ) {
+                        up_next = true;
+                    } else if ( count >= period / 2 ) {
+                        up_next = false;
+                    }
+
+                    count = up ? ( count + 1 ) : ( count - 1 );
+                    up    = up_next;
+                } else {
+                    count = ( count >= period - 1 ) ? 0 : ( count + 1 );
+                }
+            }
+
+            /**
+             * Read the counter.
+             * 
+             * \return Returns the value of the counter.
+             */
+            std::int32_t value() const { return count; }
+
+            /**
+             * Read the count direction.
+             * 
+             * \retval true  The counter counts up, or runs in edge-aligned mode.
+             * \retval false The counter counts down.
+             */
+            bool counting_up() const { return up; }
+
+        private:
+            std::int32_t count = 0;    //!< The counter register.
+            bool         up    = true; //!< The count direction register.
+    };
+
+    /**
+     * Cycle-accurate model of a single PWM output of axi_pwm.
+     * 
+     * The pwm_cell source is not part of this tree, so the model implements the waveform the
+     * driver documents on basic_pwm::set_phase(). In edge-aligned mode the output is active for
+     * duty cycles from the counter reaching the phase offset. In midpulse mode the triangle of the
+     * counter is unfolded into a sawtooth, and the output is active for duty cycles centred on
+     * half the period plus the phase offset. The counter plus or minus the period, both inputs of
+     * the cell, wrap pulses around the end of the period. A high polarity makes the active level
+     * high.
+     */
+    struct pwm_cell {
+        /**
+         * Compute the level of the output in the current cycle.
+         * 
+         * \param counter  The period counter.
+         * \param period   The period register.
+         * \param midpulse Whether the counter runs in midpulse-aligned mode.
+         * \param polarity The polarity of the output.
+         * \param duty     The active duty time of the output.
+         * \param phase    The active phase offset of the output.
+         * 
+         * \return Returns the level of the output.
+         */
+        static bool output(
+            const pwm_counter& counter,
+            std::int64_t       period,
+            bool               midpulse,
+            bool               polarity,
+            std::int64_t       duty,
+            std::int64_t       phase
+        ) {
+            const std::int64_t count = counter.value();
+            const std::int64_t time  =
+                ( midpulse && !counter.counting_up() ) ? ( period - count ) : count;
+            const std::int64_t start = midpulse ? ( period / 2 + phase - duty / 2 ) : phase;
+
+            const auto in_pulse = [&]( std::int64_t t ) {
+                return ( t >= start ) && ( t < start + duty );
+            };
+            const bool active = in_pulse( time ) || in_pulse( time + period ) ||
+                                in_pulse( time - period );
+
+            return active == polarity;
+        }
+    };
+
+}
+
+#endif // #ifndef PERIPH_PWM_CELL_HPP
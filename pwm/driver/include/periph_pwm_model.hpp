@@ -0,0 +1,160 @@
+#ifndef PERIPH_PWM_MODEL_HPP
+#define PERIPH_PWM_MODEL_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <deque>
+
+#include "periph_pwm.hpp"
+#include "periph_pwm_cell.hpp"
+#include "periph_sim.hpp"
+#include "periph_vcd.hpp"
+
+namespace periph::sim {
+
+    /**
+     * Behavioral model of an axi_pwm peripheral.
+     * 
+     * The period counter is modelled cycle for cycle as in axi_pwm, in both the edge-aligned
+     * up-counting and the midpulse-aligned up/down-counting mode. Staged duty and phase registers
+     * are copied into the active bank at the end of a period while the load bit is set, which
+     * then clears the load bit. Each output is modelled by a pwm_cell, and its level can be read
+     * back along with its active duty and phase. With a VCD writer attached, the model steps one
+     * cycle at a time and records the counter and the level of every output.
+     * 
+     * The waveform sequencer collects its frames one output per cycle as in axi_pwm, but its FIFO
+     * has no read latency.
+     */
+    class pwm_model : public model {
+        public:
+            /**
+             * Create a model with all registers reset.
+             * 
+             * \param clock_hz The clock frequency to run the model at in real time, or zero to
+             *                 only advance the model explicitly.
+             */
+            explicit pwm_model( std::uint64_t clock_hz = 0 );
+
+            /**
+             * Access the driver of the peripheral.
+             * 
+             * \return Returns the peripheral driver.
+             */
+            pwm& device();
+
+            /**
+             * Read the period counter.
+             * 
+             * \return Returns the value of the period counter.
+             */
+            std::int32_t counter() const { return period_counter.value(); }
+
+            /**
+             * Read the number of period ends simulated.
+             * 
+             * \return Returns the number of period ends since construction.
+             */
+            std::uint64_t periods() const { return num_periods; }
+
+            /**
+             * Read the duty time in effect on an output.
+             * 
+             * \param index The index of the output.
+             * 
+             * \return Returns the active duty time of the output.
+             */
+            std::int32_t active_duty( std::size_t index ) const { return active[2 * index]; }
+
+            /**
+             * Read the phase offset in effect on an output.
+             * 
+             * \param index The index of the output.
+             * 
+             * \return Returns the active phase offset of the output.
+             */
+            std::int32_t active_phase( std::size_t index ) const { return active[2 * index + 1]; }
+
+            /**
+             * Read the level of an output in the next cycle to simulate.
+             * 
+             * \param index The index of the output.
+             * 
+             * \return Returns the level of the output.
+             */
+            bool output( std::size_t index ) const;
+
+            /**
+             * Record the counter and every output in a value change dump, at the model's cycle
+             * count.
+             * 
+             * The signals are declared on the writer right away, so this must be called before the
+             * first change is recorded.
+             * 
+             * \param[in,out] writer The writer to record to, or null to stop recording.
+             */
+            void set_vcd( vcd_writer* writer );
+
+        protected:
+            void run( std::uint64_t num_cycles ) override;
+            void write_fifo( std::size_t offset, std::uint32_t data ) override;
+
+        private:
+            /**
+             * The register window, laid out as in axi_pwm.
+             */
+            std::array<volatile std::uint32_t,num_regs> regs;
+
+            std::array<std::int32_t,2*num_outputs> active;         //!< The active duty/phase bank.
+            pwm_counter                            period_counter; //!< The period counter.
+            std::uint64_t                          num_periods;    //!< The number of period ends.
+
+            std::deque<std::uint32_t>              seq_fifo;  //!< The sequencer FIFO contents.
+            std::array<std::uint32_t,num_outputs>  seq_frame; //!< The frame being collected.
+            std::size_t                            seq_index; //!< The next output to collect.
+            bool                                   seq_ready; //!< Whether the frame is complete.
+
+            std::uint64_t orbit_key;    //!< The mode and period the period length was measured at.
+            std::uint64_t orbit_start;  //!< The cycle of the last period end.
+            std::uint64_t orbit_length; //!< The number of cycles per period, or zero if unknown.
+            std::uint64_t elapsed;      //!< The number of cycles simulated.
+
+            vcd_writer*                         vcd;           //!< The recorder, or null.
+            std::size_t                         counter_trace; //!< The counter signal.
+            std::array<std::size_t,num_outputs> traces;        //!< The signal of each output.
+
+            /**
+             * Read the counter mode and period the counter currently runs with.
+             * 
+             * \return Returns the alignment bit and period register, combined into one value.
+             */
+            std::uint64_t key() const;
+
+            /**
+             * Check whether or not the waveform sequencer can change state.
+             * 
+             * \retval true  The sequencer is disabled or stalled on an empty FIFO.
+             * \retval false The sequencer may still collect or apply a frame.
+             */
+            bool seq_idle() const;
+
+            /**
+             * Record the counter and the level of every output in the current cycle.
+             */
+            void record();
+
+            /**
+             * Refresh the sequencer FIFO status bits of the configuration register.
+             */
+            void refresh_status();
+
+            /**
+             * Simulate a single clock cycle.
+             */
+            void step();
+    };
+
+}
+
+#endif // #ifndef PERIPH_PWM_MODEL_HPP
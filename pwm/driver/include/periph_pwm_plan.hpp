@@ -0,0 +1,155 @@
+#ifndef PERIPH_PWM_PLAN_HPP
+#define PERIPH_PWM_PLAN_HPP
+
+#include <cstdint>
+#include <cstddef>
+
+#include <array>
+#include <span>
+#include <utility>
+
+#include "periph_pwm.hpp"
+
+namespace periph {
+
+    /**
+     * A register image of a phase-interleaved multiphase PWM, computed in closed form.
+     * 
+     * A plan of M phases drives PWM outputs 0 to M-1, spreading their phase offsets evenly over
+     * the period: output k is offset by floor( k * period / M ) clock cycles, plus a common
+     * offset, wrapped into [0, period). In align::edge mode this spaces the leading edges of the
+     * phases evenly, in align::midpulse mode the midpoints between their edges. Duty times are
+     * clamped to [0, period]. Outputs beyond the phase count are planned off, with zero duty and
+     * phase.
+     * 
+     * Planning touches no registers and is branch-free over the outputs, so that the compiler can
+     * vectorize it over all lanes. The image is written to the peripheral with apply( device& ),
+     * as a single latched update of all outputs.
+     * 
+     * \tparam NumOutputs The number of PWM outputs the peripheral was built with.
+     * \tparam DataWidth  The AXI data width the peripheral was built with: 16, 32 or 64 bits.
+     */
+    template<std::size_t NumOutputs = num_outputs, std::size_t DataWidth = 32>
+    class basic_pwm_plan {
+        public:
+            using device      = basic_pwm<NumOutputs,DataWidth>;    //!< The planned peripheral.
+            using word        = typename device::word;              //!< The type of a register.
+            using value_type  = typename device::value_type;        //!< The type of values.
+            using output_type = std::pair<value_type,value_type>;   //!< A duty time and phase.
+            using image_type  = std::array<output_type,NumOutputs>; //!< The image of all outputs.
+
+            /**
+             * Create an empty plan, with a zero period and all outputs off.
+             */
+            basic_pwm_plan( void );
+
+            /**
+             * Plan a phase-interleaved PWM.
+             * 
+             * The plan is left unchanged if any argument is invalid.
+             * 
+             * \param period The period of all PWM outputs, in number of PWM peripheral clock
+             *               cycles. Must be positive.
+             * \param phases The number of phases, driven by outputs 0 to phases-1. Must be at least
+             *               one and at most the number of PWM outputs.
+             * \param mode   The point of each phase to interleave at.
+             * \param duties The duty time of each phase, in number of PWM peripheral clock cycles.
+             *               Must hold exactly one duty time per phase.
+             * \param offset The phase offset of the first phase. May be negative or exceed the
+             *               period, and is wrapped into it.
+             * 
+             * \retval true  The plan was computed.
+             * \retval false An argument is invalid.
+             */
+            bool plan(
+                value_type                  period,
+                std::size_t                 phases,
+                pwm_align                   mode,
+                std::span<const value_type> duties,
+                value_type                  offset = 0
+            );
+
+            /**
+             * Replan the duty times of all phases, keeping the period and phase offsets.
+             * 
+             * This is all that changes from one control tick to the next in most drives.
+             * 
+             * \param duties The duty time of each phase, in number of PWM peripheral clock cycles.
+             *               Must hold exactly one duty time per phase.
+             * 
+             * \retval true  The duty times were planned.
+             * \retval false The number of duty times does not match the number of phases.
+             */
+            bool set_duties( std::span<const value_type> duties );
+
+            /**
+             * Write the plan to a PWM peripheral.
+             * 
+             * The period and alignment mode are written first, if they changed since the last time
+             * the plan was applied. They take effect immediately. All duty and phase registers are
+             * then written as one latched update with device::set_outputs(), so all outputs switch
+             * to the plan together at the end of the current PWM period.
+             * 
+             * The plan assumes it is the only writer of the period and alignment mode of the
+             * peripheral, like a basic_pwm_shadow.
+             * 
+             * \param[in,out] dev The PWM peripheral to write the plan to.
+             */
+            void apply( device& dev );
+
+            /**
+             * Read the planned period.
+             * 
+             * \return Returns the period, in number of PWM peripheral clock cycles.
+             */
+            value_type period( void ) const { return plan_period; }
+
+            /**
+             * Read the planned number of phases.
+             * 
+             * \return Returns the number of phases, or zero for an empty plan.
+             */
+            std::size_t phases( void ) const { return num_phases; }
+
+            /**
+             * Read the planned alignment mode.
+             * 
+             * \return Returns the point each phase is interleaved at.
+             */
+            pwm_align alignment( void ) const { return plan_mode; }
+
+            /**
+             * Read the planned register image.
+             * 
+             * \return Returns the duty time and phase offset of each PWM output, in that order.
+             */
+            const image_type& image( void ) const { return outputs; }
+
+        private:
+            image_type  outputs;     //!< The duty time and phase offset of each output.
+            value_type  plan_period; //!< The period of all outputs.
+            std::size_t num_phases;  //!< The number of phases, driven by the lowest outputs.
+            pwm_align   plan_mode;   //!< The point each phase is interleaved at.
+            bool        stale;       //!< Whether the period and mode are yet to be applied.
+
+            /**
+             * Clamp and store the duty time of each phase.
+             * 
+             * \param duties The duty time of each phase, one per phase.
+             */
+            void plan_duties( std::span<const value_type> duties );
+    };
+
+    using pwm_plan = basic_pwm_plan<>; //!< A plan for a pwm.
+
+}
+
+#include "periph_pwm_plan.ipp"
+
+namespace periph {
+
+    extern template class basic_pwm_plan<>;
+
+}
+
+#endif // #ifndef PERIPH_PWM_PLAN_HPP
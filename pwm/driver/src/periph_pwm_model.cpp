@@ -0,0 +1,247 @@
+#include <string>
+
+#include "periph_pwm_model.hpp"
+
+using namespace periph;
+using namespace periph::sim;
+
+namespace {
+
+    constexpr std::size_t reg_config   = 0; //!< Index of the configuration register.
+    constexpr std::size_t reg_period   = 1; //!< Index of the period register.
+    constexpr std::size_t reg_pol_map  = 2; //!< Index of the polarity register.
+    constexpr std::size_t reg_seq_fifo = 3; //!< Index of the sequencer FIFO register.
+    constexpr std::size_t reg_seq_mask = 4; //!< Index of the sequencer mask register.
+    constexpr std::size_t reg_outputs  = 6; //!< Index of the first output register.
+
+    /**
+     * The value of the identification register, which shares the sequencer FIFO address.
+     */
+    const std::uint32_t id_word = encode_id( {
+        device_type::pwm, device_traits<pwm>::version, sequencer_depth, 0, num_outputs, 0
+    } );
+
+    constexpr std::uint32_t cfg_load_bit       = 0x00000001; //!< Update request bit of the cfg register.
+    constexpr std::uint32_t cfg_alignment_bit  = 0x00000002; //!< Alignment bit of the cfg register.
+    constexpr std::uint32_t cfg_seq_enable_bit = 0x00000004; //!< Sequencer enable bit.
+    constexpr std::uint32_t cfg_seq_empty_bit  = 0x00000008; //!< Sequencer FIFO empty flag.
+    constexpr std::uint32_t cfg_seq_full_bit   = 0x00000010; //!< Sequencer FIFO full flag.
+    constexpr std::uint32_t cfg_seq_aempt_bit  = 0x00000020; //!< Sequencer FIFO almost empty flag.
+    constexpr std::uint32_t cfg_seq_afull_bit  = 0x00000040; //!< Sequencer FIFO almost full flag.
+    constexpr std::uint32_t cfg_status_bits    = 0x00000078; //!< Read-only sequencer FIFO status bits.
+
+    constexpr std::uint64_t no_orbit = ~std::uint64_t{ 0 }; //!< Orbit key matching no configuration.
+
+}
+
+pwm_model::pwm_model( std::uint64_t clock_hz ) :
+    model( &regs, sizeof( regs ), clock_hz ),
+    regs{},
+    active{},
+    period_counter(),
+    num_periods( 0 ),
+    seq_fifo(),
+    seq_frame{},
+    seq_index( 0 ),
+    seq_ready( false ),
+    orbit_key( no_orbit ),
+    orbit_start( 0 ),
+    orbit_length( 0 ),
+    elapsed( 0 ),
+    vcd( nullptr ),
+    counter_trace( 0 ),
+    traces{}
+{
+    regs[reg_seq_fifo] = id_word;
+}
+
+pwm& pwm_model::device() {
+    return *reinterpret_cast<pwm*>( const_cast<std::uint32_t*>( regs.data() ) );
+}
+
+bool pwm_model::output( std::size_t index ) const {
+    return pwm_cell::output(
+        period_counter,
+        static_cast<std::int32_t>( regs[reg_period] ),
+        regs[reg_config] & cfg_alignment_bit,
+        regs[reg_pol_map] & ( 1u << index ),
+        active[2 * index],
+        active[2 * index + 1]
+    );
+}
+
+void pwm_model::set_vcd( vcd_writer* writer ) {
+    vcd = writer;
+    if ( vcd == nullptr ) {
+        return;
+    }
+
+    counter_trace = vcd->add( "counter", 32 );
+    for ( std::size_t i = 0; i < num_outputs; i++ ) {
+        traces[i] = vcd->add( "pwm" + std::to_string( i ) );
+    }
+}
+
+void pwm_model::run( std::uint64_t num_cycles ) {
+    if ( !( regs[reg_config] & cfg_seq_enable_bit ) ) {
+        seq_fifo.clear();
+    }
+
+    while ( num_cycles > 0 ) {
+        // Once a whole period has been stepped through with nothing pending, the counter repeats
+        // itself every period, and whole periods can be skipped, unless every cycle is recorded.
+        if ( vcd != nullptr ) {
+            record();
+        } else if ( key() != orbit_key ) {
+            orbit_key    = no_orbit;
+            orbit_length = 0;
+        } else if (
+            ( orbit_length > 0 ) && !( regs[reg_config] & cfg_load_bit ) && seq_idle()
+        ) {
+            const std::uint64_t skipped = num_cycles - num_cycles % orbit_length;
+
+            num_periods += num_cycles / orbit_length;
+            elapsed     += skipped;
+            orbit_start += skipped;
+            num_cycles  -= skipped;
+            if ( num_cycles == 0 ) {
+                break;
+            }
+        }
+
+        step();
+        num_cycles--;
+    }
+
+    refresh_status();
+}
+
+void pwm_model::write_fifo( std::size_t offset, std::uint32_t data ) {
+    if ( offset != reg_seq_fifo * sizeof( std::uint32_t ) ) {
+        return;
+    }
+
+    // The write port reads back as the identification register.
+    regs[reg_seq_fifo] = id_word;
+
+    if ( !( regs[reg_config] & cfg_seq_enable_bit )
+      || ( seq_fifo.size() >= sequencer_depth ) ) {
+        return;
+    }
+
+    seq_fifo.push_back( data );
+    refresh_status();
+}
+
+void pwm_model::step() {
+    const bool         midpulse = regs[reg_config] & cfg_alignment_bit;
+    const std::int64_t period   = static_cast<std::int32_t>( regs[reg_period] );
+
+    const bool period_end = period_counter.period_end( period, midpulse );
+
+    if ( period_end && ( regs[reg_config] & cfg_load_bit ) ) {
+        for ( std::size_t i = 0; i < active.size(); i++ ) {
+            active[i] = regs[reg_outputs + i];
+        }
+        regs[reg_config] = regs[reg_config] & ~cfg_load_bit;
+    }
+
+    const std::uint32_t mask = regs[reg_seq_mask];
+
+    if ( seq_ready && period_end ) {
+        for ( std::size_t i = 0; i < num_outputs; i++ ) {
+            if ( mask & ( 1u << i ) ) {
+                active[2 * i] = seq_frame[i];
+            }
+        }
+    }
+
+    // The sequencer collects one output per cycle and restarts after its frame was applied.
+    if ( !( regs[reg_config] & cfg_seq_enable_bit ) ) {
+        seq_fifo.clear();
+        seq_frame = {};
+        seq_index = 0;
+        seq_ready = false;
+    } else if ( seq_ready ) {
+        if ( period_end ) {
+            seq_index = 0;
+            seq_ready = false;
+        }
+    } else if ( seq_index == num_outputs ) {
+        seq_ready = true;
+    } else if ( !( mask & ( 1u << seq_index ) ) ) {
+        seq_index++;
+    } else if ( !seq_fifo.empty() ) {
+        seq_frame[seq_index++] = seq_fifo.front();
+        seq_fifo.pop_front();
+    }
+
+    period_counter.step( period, midpulse );
+    elapsed++;
+
+    if ( period_end ) {
+        num_periods++;
+
+        if ( key() == orbit_key ) {
+            orbit_length = elapsed - orbit_start;
+        } else {
+            orbit_key    = key();
+            orbit_length = 0;
+        }
+        orbit_start = elapsed;
+    }
+}
+
+void pwm_model::record() {
+    const std::int64_t  period   = static_cast<std::int32_t>( regs[reg_period] );
+    const bool          midpulse = regs[reg_config] & cfg_alignment_bit;
+    const std::uint32_t pol_map  = regs[reg_pol_map];
+
+    vcd->change( elapsed, counter_trace, static_cast<std::uint32_t>( counter() ) );
+    for ( std::size_t i = 0; i < num_outputs; i++ ) {
+        const bool level = pwm_cell::output(
+            period_counter,
+            period,
+            midpulse,
+            pol_map & ( 1u << i ),
+            active[2 * i],
+            active[2 * i + 1]
+        );
+
+        vcd->change( elapsed, traces[i], level );
+    }
+}
+
+std::uint64_t pwm_model::key() const {
+    return ( std::uint64_t{ regs[reg_config] & cfg_alignment_bit } << 32 ) | regs[reg_period];
+}
+
+bool pwm_model::seq_idle() const {
+    if ( !( regs[reg_config] & cfg_seq_enable_bit ) ) {
+        return seq_index == 0;
+    }
+
+    return !seq_ready
+        && seq_fifo.empty()
+        && ( seq_index < num_outputs )
+        && ( regs[reg_seq_mask] & ( 1u << seq_index ) );
+}
+
+void pwm_model::refresh_status() {
+    const std::size_t level = seq_fifo.size();
+
+    std::uint32_t status = 0;
+    if ( level == 0 ) {
+        status |= cfg_seq_empty_bit;
+    }
+    if ( level == sequencer_depth ) {
+        status |= cfg_seq_full_bit;
+    }
+    if ( level <= sequencer_watermark ) {
+        status |= cfg_seq_aempt_bit;
+    }
+    if ( level >= sequencer_depth - sequencer_watermark ) {
+        status |= cfg_seq_afull_bit;
+    }
+    regs[reg_config] = ( regs[reg_config] & ~cfg_status_bits ) | status;
+}
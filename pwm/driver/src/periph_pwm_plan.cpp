@@ -0,0 +1,8 @@
+#include "periph_pwm_plan.hpp"
+
+namespace periph {
+
+    // The plan for the 32-bit peripheral behind the pwm alias is compiled once, here.
+    template class basic_pwm_plan<>;
+
+}
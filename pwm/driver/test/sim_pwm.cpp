@@ -0,0 +1,308 @@
+#include <cstdint>
+#include <cstddef>
+
+#include <algorithm>
+#include <array>
+
+#include "periph_check.hpp"
+#include "periph_pwm.hpp"
+#include "periph_pwm_cell.hpp"
+#include "periph_pwm_model.hpp"
+#include "periph_pwm_plan.hpp"
+#include "periph_trace.hpp"
+
+using namespace periph;
+
+namespace {
+
+    /**
+     * Count the cycles of one period a PWM cell drives its output active.
+     */
+    std::int64_t active_cycles(
+        std::int64_t period,
+        bool         midpulse,
+        std::int64_t duty,
+        std::int64_t phase
+    ) {
+        sim::pwm_counter counter;
+        std::int64_t     active = 0;
+
+        for ( std::int64_t cycle = 0; cycle < period; cycle++ ) {
+            active += sim::pwm_cell::output( counter, period, midpulse, true, duty, phase ) ? 1 : 0;
+            counter.step( period, midpulse );
+        }
+
+        return active;
+    }
+
+    void test_cell_edge() {
+        sim::pwm_counter counter;
+
+        // The counter wraps at the period, where the period ends.
+        for ( int i = 0; i < 9; i++ ) {
+            PERIPH_CHECK( !counter.period_end( 10, false ) );
+            counter.step( 10, false );
+        }
+        PERIPH_CHECK( counter.period_end( 10, false ) );
+        counter.step( 10, false );
+        PERIPH_CHECK( counter.value() == 0 );
+
+        // An edge-aligned pulse starts at its phase, and wraps around the end of the period.
+        PERIPH_CHECK( sim::pwm_cell::output( counter, 10, false, true, 3, 0 ) );
+        PERIPH_CHECK( !sim::pwm_cell::output( counter, 10, false, false, 3, 0 ) );
+        PERIPH_CHECK( !sim::pwm_cell::output( counter, 10, false, true, 3, 1 ) );
+        PERIPH_CHECK( sim::pwm_cell::output( counter, 10, false, true, 3, 8 ) );
+        PERIPH_CHECK( !sim::pwm_cell::output( counter, 10, false, true, 0, 0 ) );
+
+        PERIPH_CHECK( active_cycles( 10, false, 3, 0 ) == 3 );
+        PERIPH_CHECK( active_cycles( 10, false, 3, 9 ) == 3 );
+        PERIPH_CHECK( active_cycles( 10, false, 10, 0 ) == 10 );
+    }
+
+    void test_cell_center() {
+        sim::pwm_counter counter;
+
+        // A midpulse counter overshoots both turning points by one, so that a period of ten
+        // takes fourteen cycles, with the counter peaking at six and bottoming out at minus one.
+        std::int32_t peak       = 0;
+        std::int64_t peak_cycle = 0;
+        std::int64_t first      = -1;
+        std::int64_t last       = -1;
+        std::int64_t cycle      = 0;
+        for ( ; !counter.period_end( 10, true ); cycle++ ) {
+            if ( counter.value() > peak ) {
+                peak       = counter.value();
+                peak_cycle = cycle;
+            }
+            if ( sim::pwm_cell::output( counter, 10, true, true, 4, 0 ) ) {
+                first = ( first < 0 ) ? cycle : first;
+                last  = cycle;
+            }
+            counter.step( 10, true );
+        }
+        PERIPH_CHECK( cycle == 12 );
+        PERIPH_CHECK( peak == 6 );
+        PERIPH_CHECK( counter.value() == 0 );
+
+        // A midpulse pulse spans the turning point of the counter.
+        PERIPH_CHECK( ( first > 0 ) && ( first < peak_cycle ) );
+        PERIPH_CHECK( ( last > peak_cycle ) && ( last < cycle ) );
+
+        counter.step( 10, true );
+        PERIPH_CHECK( counter.value() == -1 );
+        counter.step( 10, true );
+        PERIPH_CHECK( counter.value() == 0 );
+        PERIPH_CHECK( counter.counting_up() );
+        PERIPH_CHECK( !sim::pwm_cell::output( counter, 10, true, true, 0, 0 ) );
+        PERIPH_CHECK( sim::pwm_cell::output( counter, 10, true, true, 10, 0 ) );
+    }
+
+    void test_model_update() {
+        sim::pwm_model model;
+        pwm&           dev = model.device();
+
+        dev.set_period( 10 );
+        dev.set_polarity( 0, true );
+        dev.set_duty( 0, 4 );
+        dev.set_phase( 0, 2 );
+        PERIPH_CHECK( model.active_duty( 0 ) == 0 );
+
+        // New values take effect together at the end of the period after the update request.
+        dev.request_update();
+        PERIPH_CHECK( dev.update_pending() );
+        model.advance( 10 );
+        PERIPH_CHECK( !dev.update_pending() );
+        PERIPH_CHECK( model.active_duty( 0 ) == 4 );
+        PERIPH_CHECK( model.active_phase( 0 ) == 2 );
+
+        const std::uint64_t periods = model.periods();
+        std::size_t         active  = 0;
+        for ( int i = 0; i < 10; i++ ) {
+            model.advance( 1 );
+            active += model.output( 0 ) ? 1 : 0;
+        }
+        PERIPH_CHECK( model.periods() == periods + 1 );
+        PERIPH_CHECK( active == 4 );
+    }
+
+    void test_sequencer() {
+        sim::pwm_model model;
+        pwm&           dev = model.device();
+
+        dev.set_period( 50 );
+        dev.set_duty( 0, 1 );
+        dev.set_duty( 2, 2 );
+        dev.request_update();
+        model.advance( 50 );
+
+        // Each frame holds one duty time per selected output, in ascending output order, and
+        // only replaces the duty times of those outputs. The sequencer collects a frame at one
+        // output per cycle, well within a period, and applies it at the end of the period.
+        const std::array<pwm::value_type,4> frames = { 5, 6, 7, 8 };
+        dev.set_sequencer_mask( pwm::mask_type( 0b1010 ) );
+        dev.set_sequencer_enabled( true );
+        PERIPH_CHECK( dev.enqueue_waveform( frames ) == frames.size() );
+
+        model.advance( 50 );
+        PERIPH_CHECK( model.active_duty( 1 ) == 5 );
+        PERIPH_CHECK( model.active_duty( 3 ) == 6 );
+        PERIPH_CHECK( model.active_duty( 0 ) == 1 );
+        PERIPH_CHECK( model.active_duty( 2 ) == 2 );
+
+        model.advance( 50 );
+        PERIPH_CHECK( model.active_duty( 1 ) == 7 );
+        PERIPH_CHECK( model.active_duty( 3 ) == 8 );
+        PERIPH_CHECK( dev.sequencer_empty() );
+    }
+
+    void test_shadow() {
+        sim::pwm_model model;
+        pwm&           dev = model.device();
+
+        dev.set_period( 10 );
+        dev.request_update();
+        model.advance( 20 );
+
+        pwm_shadow shadow( dev );
+        PERIPH_CHECK( !shadow.dirty() );
+
+        // Storing the value a register already has leaves the copy clean.
+        shadow.set_period( 10 );
+        shadow.set_duty<0>( 0 );
+        PERIPH_CHECK( !shadow.dirty() );
+
+        // Only dirty registers are written, so a polarity set on the peripheral behind the
+        // copy's back survives committing the period, which needs no update request.
+        dev.set_polarity_all( pwm::mask_type( 0b1 ) );
+        shadow.set_period( 20 );
+        PERIPH_CHECK( shadow.dirty() );
+
+        const std::uint64_t writes = trace::local().mmio_writes;
+        shadow.commit();
+        PERIPH_CHECK( !shadow.dirty() );
+        PERIPH_CHECK( !dev.update_pending() );
+        PERIPH_CHECK( dev.read_polarity_all() == pwm::mask_type( 0b1 ) );
+        if constexpr ( trace::enabled ) {
+            PERIPH_CHECK( trace::local().mmio_writes == writes + 1 );
+        }
+
+        // Duty and phase changes are latched together by a single update request.
+        shadow.set_duty<1>( 3 );
+        shadow.set_phase<1>( 1 );
+        shadow.commit();
+        PERIPH_CHECK( dev.update_pending() );
+        PERIPH_CHECK( model.active_duty( 1 ) == 0 );
+        model.advance( 40 );
+        PERIPH_CHECK( !dev.update_pending() );
+        PERIPH_CHECK( model.active_duty( 1 ) == 3 );
+        PERIPH_CHECK( model.active_phase( 1 ) == 1 );
+
+        // Committing only the alignment keeps an update requested on the peripheral pending,
+        // and keeps the sequencer running.
+        dev.set_sequencer_mask( pwm::mask_type( 0b100 ) );
+        dev.set_sequencer_enabled( true );
+        dev.set_duty( 0, 4 );
+        PERIPH_CHECK( dev.update_pending() );
+
+        shadow.set_alignment( pwm_align::midpulse );
+        shadow.commit();
+        PERIPH_CHECK( dev.update_pending() );
+
+        const std::array<pwm::value_type,1> frame = { 6 };
+        PERIPH_CHECK( dev.enqueue_waveform( frame ) == frame.size() );
+        model.advance( 100 );
+        PERIPH_CHECK( !dev.update_pending() );
+        PERIPH_CHECK( model.active_duty( 0 ) == 4 );
+        PERIPH_CHECK( model.active_duty( 2 ) == 6 );
+        PERIPH_CHECK( dev.sequencer_empty() );
+    }
+
+    void test_plan() {
+        using value_type = pwm_plan::value_type;
+
+        pwm_plan plan;
+
+        // Phases are spaced by floor( k * period / M ), also where M does not divide the period.
+        std::array<value_type,num_outputs> duties{};
+        for ( value_type period = 1; period <= 100; period++ ) {
+            for ( std::size_t phases = 1; phases <= num_outputs; phases++ ) {
+                PERIPH_CHECK( plan.plan(
+                    period, phases, pwm_align::edge, std::span( duties ).first( phases )
+                ) );
+
+                bool spaced = true;
+                for ( std::size_t k = 0; k < phases; k++ ) {
+                    const auto expected = value_type( k * std::size_t( period ) / phases );
+                    spaced = spaced && ( plan.image()[k].second == expected );
+                }
+                PERIPH_CHECK( spaced );
+            }
+        }
+
+        PERIPH_CHECK( !plan.plan( 10, 0, pwm_align::edge, {} ) );
+        PERIPH_CHECK( !plan.plan( 0, 1, pwm_align::edge, std::span( duties ).first( 1 ) ) );
+        PERIPH_CHECK( !plan.plan( 10, 2, pwm_align::edge, std::span( duties ).first( 1 ) ) );
+
+        // Offsets below zero or beyond the period wrap into it, and so does each phase.
+        const std::array<value_type,3> three = { -5, 4, 15 };
+        PERIPH_CHECK( plan.plan( 10, 3, pwm_align::edge, three, -3 ) );
+        PERIPH_CHECK( plan.image()[0].second == 7 );
+        PERIPH_CHECK( plan.image()[1].second == 0 );
+        PERIPH_CHECK( plan.image()[2].second == 3 );
+        PERIPH_CHECK( plan.plan( 10, 3, pwm_align::edge, three, 25 ) );
+        PERIPH_CHECK( plan.image()[0].second == 5 );
+        PERIPH_CHECK( plan.image()[2].second == 1 );
+
+        // Duty times are clamped to the period, and outputs beyond the phases are off.
+        PERIPH_CHECK( plan.image()[0].first == 0 );
+        PERIPH_CHECK( plan.image()[1].first == 4 );
+        PERIPH_CHECK( plan.image()[2].first == 10 );
+        PERIPH_CHECK( ( plan.image()[3] == pwm_plan::output_type{ 0, 0 } ) );
+
+        PERIPH_CHECK( plan.set_duties( std::array<value_type,3>{ 11, -1, 2 } ) );
+        PERIPH_CHECK( plan.image()[0].first == 10 );
+        PERIPH_CHECK( plan.image()[1].first == 0 );
+        PERIPH_CHECK( plan.image()[2].second == 1 );
+        PERIPH_CHECK( !plan.set_duties( std::array<value_type,2>{ 1, 2 } ) );
+    }
+
+    void test_plan_apply() {
+        sim::pwm_model model;
+        pwm&           dev = model.device();
+        pwm_plan       plan;
+
+        dev.set_period( 10 );
+        dev.request_update();
+        model.advance( 20 );
+
+        // The period takes effect at once, while all duties and phases wait for one update.
+        const std::array<pwm::value_type,4> duties = { 1, 2, 3, 4 };
+        PERIPH_CHECK( plan.plan( 20, duties.size(), pwm_align::edge, duties ) );
+        plan.apply( dev );
+        PERIPH_CHECK( dev.update_pending() );
+        for ( std::size_t k = 0; k < duties.size(); k++ ) {
+            PERIPH_CHECK( model.active_duty( k ) == 0 );
+            PERIPH_CHECK( model.active_phase( k ) == 0 );
+        }
+
+        model.advance( 40 );
+        PERIPH_CHECK( !dev.update_pending() );
+        for ( std::size_t k = 0; k < num_outputs; k++ ) {
+            PERIPH_CHECK( model.active_duty( k ) == plan.image()[k].first );
+            PERIPH_CHECK( model.active_phase( k ) == plan.image()[k].second );
+        }
+        PERIPH_CHECK( model.active_phase( 3 ) == 15 );
+    }
+}
+
+int main() {
+    test::run( "cell_edge", test_cell_edge );
+    test::run( "cell_center", test_cell_center );
+    test::run( "model_update", test_model_update );
+    test::run( "sequencer", test_sequencer );
+    test::run( "shadow", test_shadow );
+    test::run( "plan", test_plan );
+    test::run( "plan_apply", test_plan_apply );
+
+    return test::result();
+}
@@ -4,14 +4,25 @@
 
 periph::pwm* const pwm_0 = (periph::pwm*)(intptr_t)0x43C00000;
 
+/**
+ * Busy-wait for a number of loop iterations.
+ * 
+ * \param iterations The number of iterations to wait for.
+ */
+static void spin( int iterations ) {
+    for ( int i = 0; i < iterations; i++ ) {
+        asm volatile( "" ::: "memory" ); // Keep the loop from being optimized out.
+    }
+}
+
 int main( int argc, char* argv[] ) {
     pwm_0->reset();
     pwm_0->set_period( 100000 ); // 1ms at 100MHz
 
     while(true) {
         pwm_0->set_duty<0>( 20000 );
-        for ( volatile int i = 0; i < 100000000; i++ );
+        spin( 100000000 );
         pwm_0->set_duty<0>( 50000 );
-        for ( volatile int i = 0; i < 100000000; i++ );
+        spin( 100000000 );
     }
 }
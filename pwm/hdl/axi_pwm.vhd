@@ -3,6 +3,11 @@ use ieee.std_logic_1164.all;
 use ieee.numeric_std.all;
 use ieee.math_real.all;
 
+library unisim;
+use unisim.vcomponents.all;
+library unimacro;
+use unimacro.vcomponents.all;
+
 entity axi_pwm is
 	generic (
 		AXI_ID_WIDTH   : integer := 1;
@@ -16,6 +21,9 @@ entity axi_pwm is
 		
 		s_axi_awid    : in  std_logic_vector(AXI_ID_WIDTH-1 downto 0);
 		s_axi_awaddr  : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+		s_axi_awlen   : in  std_logic_vector(7 downto 0);
+		s_axi_awsize  : in  std_logic_vector(2 downto 0);
+		s_axi_awburst : in  std_logic_vector(1 downto 0);
 		s_axi_awprot  : in  std_logic_vector(2 downto 0);
 		s_axi_awvalid : in  std_logic;
 		s_axi_awready : out std_logic;
@@ -54,11 +62,17 @@ architecture arch of axi_pwm is
 	
 	signal s_axi_awid_reg    : std_logic_vector(AXI_ID_WIDTH-1 downto 0);
 	signal s_axi_awaddr_reg  : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+	signal s_axi_awlen_reg   : std_logic_vector(7 downto 0);
+	signal s_axi_awsize_reg  : std_logic_vector(2 downto 0);
+	signal s_axi_awburst_reg : std_logic_vector(1 downto 0);
 	signal s_axi_awprot_reg  : std_logic_vector(2 downto 0);
 	signal s_axi_awvalid_reg : std_logic;
 	
 	signal s_axi_awid_reg_next    : std_logic_vector(AXI_ID_WIDTH-1 downto 0);
 	signal s_axi_awaddr_reg_next  : std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+	signal s_axi_awlen_reg_next   : std_logic_vector(7 downto 0);
+	signal s_axi_awsize_reg_next  : std_logic_vector(2 downto 0);
+	signal s_axi_awburst_reg_next : std_logic_vector(1 downto 0);
 	signal s_axi_awprot_reg_next  : std_logic_vector(2 downto 0);
 	signal s_axi_awvalid_reg_next : std_logic;
 	
@@ -135,8 +149,27 @@ architecture arch of axi_pwm is
 	-- Register Banks --
 	--------------------
 	
+	-- config, period, polarity, sequencer FIFO, sequencer mask, reserved, duty/phase per output
+	constant NUM_REGS     : integer := 2*(NUM_OUTPUTS+3);
+	constant SEQ_FIFO_REG : integer := 3;
+	constant SEQ_MASK_REG : integer := 4;
+	constant OUTPUTS_REG  : integer := 6;
+	
+	-- identification word read back from the write-only sequencer FIFO register: core type,
+	-- version, log2 of the sequencer FIFO depth and number of outputs
+	constant CORE_TYPE       : integer := 16#50#;
+	constant CORE_VERSION    : integer := 2;
+	constant FIFO_DEPTH_LOG2 : integer := 10;
+	
+	constant ID_WORD : std_logic_vector(AXI_DATA_WIDTH-1 downto 0) := std_logic_vector(
+		shift_left(to_unsigned(CORE_TYPE      , AXI_DATA_WIDTH), 24) or
+		shift_left(to_unsigned(CORE_VERSION   , AXI_DATA_WIDTH), 20) or
+		shift_left(to_unsigned(FIFO_DEPTH_LOG2, AXI_DATA_WIDTH), 16) or
+		to_unsigned(NUM_OUTPUTS, AXI_DATA_WIDTH)
+	);
+	
 	type reg_bank is array (
-		2*(NUM_OUTPUTS+2)-1 downto 0
+		NUM_REGS-1 downto 0
 	) of std_logic_vector(
 		AXI_DATA_WIDTH-1 downto 0
 	);
@@ -144,14 +177,21 @@ architecture arch of axi_pwm is
 	signal regs      : reg_bank;
 	signal regs_next : reg_bank;
 	
+	-- duty and phase values in effect, loaded from regs at the end of a PWM period
+	signal active      : reg_bank;
+	signal active_next : reg_bank;
+	
 	constant AXADDR_REG_JUSTFY_BITS : integer := integer(ceil(log2(real(AXI_DATA_WIDTH/8))));
 	
 	signal reg_index_from_araddr     : integer;
 	signal reg_index_from_awaddr_reg : integer;
 	
+	signal cfg_load          : std_logic;
 	signal cfg_count_up_down : std_logic;
 	signal cfg_polarity      : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
 	signal cfg_period        : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+	signal cfg_seq_enable    : std_logic;
+	signal cfg_seq_mask      : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
 	
 	------------------------
 	-- PWM Period Counter --
@@ -165,6 +205,60 @@ architecture arch of axi_pwm is
 	
 	signal counter_plus_period  : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
 	signal counter_minus_period : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+	
+	signal period_end : boolean;
+	
+	------------------------
+	-- Waveform Sequencer --
+	------------------------
+	
+	component xfifo_axis_rd is
+		generic (
+			AXIS_DATA_WIDTH : integer := 32
+		);
+		port (
+			fifo_rden  : out std_logic;
+			fifo_do    : in  std_logic_vector(AXIS_DATA_WIDTH-1 downto 0);
+			fifo_empty : in  std_logic;
+			
+			m_axis_tdata  : out std_logic_vector(AXIS_DATA_WIDTH-1 downto 0);
+			m_axis_tvalid : out std_logic;
+			m_axis_tready : in  std_logic;
+			
+			aclk    : in std_logic;
+			aresetn : in std_logic
+		);
+	end component;
+	
+	signal seq_aresetn : std_logic;
+	
+	signal seq_fifo_wren        : std_logic;
+	signal seq_fifo_full        : std_logic;
+	signal seq_fifo_almostfull  : std_logic;
+	signal seq_fifo_rden        : std_logic;
+	signal seq_fifo_do          : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+	signal seq_fifo_empty       : std_logic;
+	signal seq_fifo_almostempty : std_logic;
+	
+	signal seq_m_axis_tdata  : std_logic_vector(AXI_DATA_WIDTH-1 downto 0);
+	signal seq_m_axis_tvalid : std_logic;
+	signal seq_m_axis_tready : std_logic;
+	
+	type seq_bank is array (
+		NUM_OUTPUTS-1 downto 0
+	) of std_logic_vector(
+		AXI_DATA_WIDTH-1 downto 0
+	);
+	
+	-- duty values of the next frame, one per output selected by the sequencer mask
+	signal seq_frame      : seq_bank;
+	signal seq_frame_next : seq_bank;
+	
+	signal seq_index      : integer range 0 to NUM_OUTPUTS;
+	signal seq_index_next : integer range 0 to NUM_OUTPUTS;
+	
+	signal seq_ready      : boolean;
+	signal seq_ready_next : boolean;
 begin
 	--------------------------
 	-- AXI-4 Lite Registers --
@@ -182,6 +276,9 @@ begin
 	process (
 		s_axi_awid   ,
 		s_axi_awaddr ,
+		s_axi_awlen  ,
+		s_axi_awsize ,
+		s_axi_awburst,
 		s_axi_awprot ,
 		s_axi_awvalid,
 		s_axi_wdata ,
@@ -193,6 +290,9 @@ begin
 		s_axi_arprot ,
 		s_axi_awid_reg   ,
 		s_axi_awaddr_reg ,
+		s_axi_awlen_reg  ,
+		s_axi_awsize_reg ,
+		s_axi_awburst_reg,
 		s_axi_awprot_reg ,
 		s_axi_awvalid_reg,
 		s_axi_awready    ,
@@ -209,11 +309,24 @@ begin
 		wr_state         ,
 		rd_state         ,
 		regs             ,
+		active           ,
+		cfg_load         ,
+		cfg_seq_mask     ,
+		period_end       ,
+		seq_frame        ,
+		seq_ready        ,
+		seq_fifo_full       ,
+		seq_fifo_almostfull ,
+		seq_fifo_empty      ,
+		seq_fifo_almostempty,
 		reg_index_from_awaddr_reg,
 		reg_index_from_araddr
 	) begin
 		s_axi_awid_reg_next    <= s_axi_awid_reg   ;
 		s_axi_awaddr_reg_next  <= s_axi_awaddr_reg ;
+		s_axi_awlen_reg_next   <= s_axi_awlen_reg  ;
+		s_axi_awsize_reg_next  <= s_axi_awsize_reg ;
+		s_axi_awburst_reg_next <= s_axi_awburst_reg;
 		s_axi_awprot_reg_next  <= s_axi_awprot_reg ;
 		s_axi_awvalid_reg_next <= s_axi_awvalid_reg;
 		s_axi_awready_next     <= s_axi_awready    ;
@@ -229,6 +342,27 @@ begin
 		wr_state_next          <= wr_state         ;
 		rd_state_next          <= rd_state         ;
 		regs_next              <= regs             ;
+		active_next            <= active           ;
+		
+		-- Swap in the staged duty and phase registers all at once at the end of a period, then
+		-- acknowledge the load request. A load request written in the same cycle takes priority.
+		if (cfg_load = '1' and period_end) then
+			for i in OUTPUTS_REG to NUM_REGS-1 loop
+				active_next(i) <= regs(i);
+			end loop;
+			
+			regs_next(0)(0) <= '0';
+		end if;
+		
+		-- A complete sequencer frame replaces the duty of every selected output at the same
+		-- period boundary, overriding a software load of those outputs.
+		if (seq_ready and period_end) then
+			for i in 0 to NUM_OUTPUTS-1 loop
+				if (cfg_seq_mask(i) = '1') then
+					active_next(OUTPUTS_REG+2*i) <= seq_frame(i);
+				end if;
+			end loop;
+		end if;
 		
 		case (wr_state) is
 			when idle =>
@@ -237,35 +371,55 @@ begin
 					
 					s_axi_awid_reg_next    <= s_axi_awid   ;
 					s_axi_awaddr_reg_next  <= s_axi_awaddr ;
+					s_axi_awlen_reg_next   <= s_axi_awlen  ;
+					s_axi_awsize_reg_next  <= s_axi_awsize ;
+					s_axi_awburst_reg_next <= s_axi_awburst;
 					s_axi_awprot_reg_next  <= s_axi_awprot ;
 					s_axi_awvalid_reg_next <= s_axi_awvalid;
 					
 					s_axi_awready_next     <= '0';
 					
 					s_axi_wready_next      <= '1';
+					
+					s_axi_bresp_next       <= AXI4_RESP_NMOKAY;
 				end if;
 				
 			when writing =>
 				if (s_axi_wvalid = '1') then
-					wr_state_next <= responding;
-					
-					for i in 0 to AXI_DATA_WIDTH/8-1 loop
-						if (s_axi_wstrb(i) = '1') then
-							regs_next
-								(reg_index_from_awaddr_reg)
-								(8*(i+1)-1 downto 8*i)      <= s_axi_wdata(8*(i+1)-1 downto 8*i);
-						end if;
-					end loop;
-					
-					s_axi_wready_next <= '0';
+					if (reg_index_from_awaddr_reg < NUM_REGS) then
+						for i in 0 to AXI_DATA_WIDTH/8-1 loop
+							if (s_axi_wstrb(i) = '1') then
+								regs_next
+									(reg_index_from_awaddr_reg)
+									(8*(i+1)-1 downto 8*i) <= s_axi_wdata(8*(i+1)-1 downto 8*i);
+							end if;
+						end loop;
+					else
+						s_axi_bresp_next <= AXI4_RESP_SLVERR;
+					end if;
 					
-					s_axi_bid_next    <= s_axi_awid_reg;
-					if (reg_index_from_awaddr_reg < 2*(NUM_OUTPUTS+2)) then
-						s_axi_rresp_next <= AXI4_RESP_NMOKAY;
+					-- Accept one beat per cycle until the burst is exhausted, advancing the
+					-- register address after each beat of an incrementing burst.
+					if (unsigned(s_axi_awlen_reg) = 0) then
+						wr_state_next <= responding;
+						
+						s_axi_wready_next <= '0';
+						
+						s_axi_bid_next    <= s_axi_awid_reg;
+						s_axi_bvalid_next <= '1';
 					else
-						s_axi_rresp_next <= AXI4_RESP_SLVERR;
+						s_axi_awlen_reg_next <= std_logic_vector(unsigned(s_axi_awlen_reg) - 1);
+						
+						if (s_axi_awburst_reg = AXI4_BURST_INCRE) then
+							s_axi_awaddr_reg_next <= std_logic_vector(
+								unsigned(s_axi_awaddr_reg) +
+								shift_left(
+									to_unsigned(1, AXI_ADDR_WIDTH),
+									to_integer(unsigned(s_axi_awsize_reg))
+								)
+							);
+						end if;
 					end if;
-					s_axi_bvalid_next <= '1';
 				end if;
 				
 			when responding =>
@@ -286,8 +440,12 @@ begin
 					s_axi_arready_next <= '0';
 					
 					s_axi_rid_next     <= s_axi_arid;
-					s_axi_rdata_next   <= regs(reg_index_from_araddr);
-					if (reg_index_from_araddr < 2*(NUM_OUTPUTS+2)) then
+					if (reg_index_from_araddr = SEQ_FIFO_REG) then
+						s_axi_rdata_next <= ID_WORD;
+					else
+						s_axi_rdata_next <= regs(reg_index_from_araddr);
+					end if;
+					if (reg_index_from_araddr < NUM_REGS) then
 						s_axi_rresp_next <= AXI4_RESP_NMOKAY;
 					else
 						s_axi_rresp_next <= AXI4_RESP_SLVERR;
@@ -304,6 +462,12 @@ begin
 				end if;
 				
 		end case;
+		
+		-- read-only sequencer FIFO status
+		regs_next(0)(6) <= seq_fifo_almostfull ;
+		regs_next(0)(5) <= seq_fifo_almostempty;
+		regs_next(0)(4) <= seq_fifo_full       ;
+		regs_next(0)(3) <= seq_fifo_empty      ;
 	end process;
 	
 	process (aclk) begin
@@ -311,6 +475,9 @@ begin
 			if (aresetn = '0') then
 				s_axi_awid_reg    <= (others => '0');
 				s_axi_awaddr_reg  <= (others => '0');
+				s_axi_awlen_reg   <= (others => '0');
+				s_axi_awsize_reg  <= (others => '0');
+				s_axi_awburst_reg <= (others => '0');
 				s_axi_awprot_reg  <= (others => '0');
 				s_axi_awvalid_reg <= '0';
 				s_axi_awready     <= '1';
@@ -326,9 +493,13 @@ begin
 				wr_state          <= idle;
 				rd_state          <= idle;
 				regs              <= (others => (others => '0'));
+				active            <= (others => (others => '0'));
 			else
 				s_axi_awid_reg    <= s_axi_awid_reg_next   ;
 				s_axi_awaddr_reg  <= s_axi_awaddr_reg_next ;
+				s_axi_awlen_reg   <= s_axi_awlen_reg_next  ;
+				s_axi_awsize_reg  <= s_axi_awsize_reg_next ;
+				s_axi_awburst_reg <= s_axi_awburst_reg_next;
 				s_axi_awprot_reg  <= s_axi_awprot_reg_next ;
 				s_axi_awvalid_reg <= s_axi_awvalid_reg_next;
 				s_axi_awready     <= s_axi_awready_next    ;
@@ -344,6 +515,7 @@ begin
 				wr_state          <= wr_state_next         ;
 				rd_state          <= rd_state_next         ;
 				regs              <= regs_next             ;
+				active            <= active_next           ;
 			end if;
 		end if;
 	end process;
@@ -352,13 +524,20 @@ begin
 	-- PWM Period Counter --
 	------------------------
 	
+	cfg_load          <= regs(0)(0);
 	cfg_count_up_down <= regs(0)(1);
 	cfg_period        <= regs(1);
 	cfg_polarity      <= regs(2);
+	cfg_seq_enable    <= regs(0)(2);
+	cfg_seq_mask      <= regs(SEQ_MASK_REG);
 	
 	counter_plus_period  <= std_logic_vector(signed(counter) + signed(cfg_period));
 	counter_minus_period <= std_logic_vector(signed(counter) - signed(cfg_period));
 	
+	period_end <=
+		(signed(counter) <= 0 and not up_ndown) when (cfg_count_up_down = '1') else
+		(signed(counter) >= signed(cfg_period)-1);
+	
 	process (
 		up_ndown,
 		cfg_count_up_down,
@@ -399,13 +578,119 @@ begin
 		end if;
 	end process;
 	
+	------------------------
+	-- Waveform Sequencer --
+	------------------------
+	
+	-- Duty values written to the sequencer FIFO register are queued in a FIFO and collected into
+	-- a frame, one value per selected output in ascending output order. The frame is latched into
+	-- the active bank at the next period end, after which collection of the next frame starts.
+	-- Collecting a frame takes at least NUM_OUTPUTS cycles; if the FIFO runs dry the outputs keep
+	-- their previous duty until a complete frame is available.
+	
+	seq_aresetn <= cfg_seq_enable and aresetn;
+	
+	seq_fifo_wren <=
+		s_axi_wvalid and s_axi_wready when (reg_index_from_awaddr_reg = SEQ_FIFO_REG) else
+		'0';
+	
+	seq_fifo : fifo_sync_macro
+	generic map (
+		DEVICE              => "7SERIES",      -- Target Device: "VIRTEX5, "VIRTEX6", "7SERIES"
+		ALMOST_FULL_OFFSET  => X"0080",        -- Sets almost full threshold
+		ALMOST_EMPTY_OFFSET => X"0080",        -- Sets the almost empty threshold
+		DATA_WIDTH          => AXI_DATA_WIDTH, -- Valid values are 1-72 (37-72 only valid when FIFO_SIZE="36Kb")
+		FIFO_SIZE           => "36Kb"          -- Target BRAM, "18Kb" or "36Kb"
+	) port map (
+		wren        => seq_fifo_wren,        -- 1-bit input write enable
+		di          => s_axi_wdata,          -- Input data, width defined by DATA_WIDTH parameter
+		almostfull  => seq_fifo_almostfull,  -- 1-bit output almost full
+		full        => seq_fifo_full,        -- 1-bit output full
+		wrcount     => open,                 -- Output write count, width determined by FIFO depth
+		wrerr       => open,                 -- 1-bit output write error
+		
+		rden        => seq_fifo_rden,        -- 1-bit input read enable
+		do          => seq_fifo_do,          -- Output data, width defined by DATA_WIDTH parameter
+		almostempty => seq_fifo_almostempty, -- 1-bit output almost empty
+		empty       => seq_fifo_empty,       -- 1-bit output empty
+		rdcount     => open,                 -- Output read count, width determined by FIFO depth
+		rderr       => open,                 -- 1-bit output read error
+		
+		clk         => aclk,                 -- 1-bit input clock
+		rst         => not seq_aresetn       -- 1-bit input reset
+	);
+	
+	seq_converter : xfifo_axis_rd
+	generic map (
+		AXIS_DATA_WIDTH => AXI_DATA_WIDTH
+	) port map (
+		fifo_rden     => seq_fifo_rden    ,
+		fifo_do       => seq_fifo_do      ,
+		fifo_empty    => seq_fifo_empty   ,
+		
+		m_axis_tdata  => seq_m_axis_tdata ,
+		m_axis_tvalid => seq_m_axis_tvalid,
+		m_axis_tready => seq_m_axis_tready,
+		
+		aclk          => aclk,
+		aresetn       => seq_aresetn
+	);
+	
+	process (
+		seq_frame,
+		seq_index,
+		seq_ready,
+		cfg_seq_mask,
+		seq_m_axis_tdata,
+		seq_m_axis_tvalid,
+		period_end
+	) begin
+		seq_frame_next <= seq_frame;
+		seq_index_next <= seq_index;
+		seq_ready_next <= seq_ready;
+		
+		seq_m_axis_tready <= '0';
+		
+		if (seq_ready) then
+			if (period_end) then
+				seq_index_next <= 0;
+				seq_ready_next <= false;
+			end if;
+		elsif (seq_index = NUM_OUTPUTS) then
+			seq_ready_next <= true;
+		elsif (cfg_seq_mask(seq_index) = '0') then
+			seq_index_next <= seq_index + 1;
+		else
+			seq_m_axis_tready <= '1';
+			
+			if (seq_m_axis_tvalid = '1') then
+				seq_frame_next(seq_index) <= seq_m_axis_tdata;
+				seq_index_next            <= seq_index + 1;
+			end if;
+		end if;
+	end process;
+	
+	process (aclk) begin
+		if (rising_edge(aclk)) then
+			if (seq_aresetn = '0') then
+				seq_frame <= (others => (others => '0'));
+				seq_index <= 0;
+				seq_ready <= false;
+			else
+				seq_frame <= seq_frame_next;
+				seq_index <= seq_index_next;
+				seq_ready <= seq_ready_next;
+			end if;
+		end if;
+	end process;
+	
 	------------------------
 	-- PWM Cell Instances --
 	------------------------
 	
 	GEN_CELLS : for i in 0 to NUM_OUTPUTS-1 generate
-		constant duty_reg_addr  : integer := 2*(i+2);
-		constant phase_reg_addr : integer := 2*(i+2)+1;
+		constant duty_reg_addr  : integer := OUTPUTS_REG+2*i;
+		constant phase_reg_addr : integer := OUTPUTS_REG+2*i+1;
 		
 		component pwm_cell is
 			generic (
@@ -439,8 +724,8 @@ begin
 			count_up_down => cfg_count_up_down,
 			polarity      => cfg_polarity(i),
 			
-			duty  => regs(duty_reg_addr ),
-			phase => regs(phase_reg_addr)
+			duty  => active(duty_reg_addr ),
+			phase => active(phase_reg_addr)
 		);
 	end generate GEN_CELLS;
 end arch;
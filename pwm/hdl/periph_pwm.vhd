@@ -14,6 +14,9 @@ entity periph_pwm is
 		
 		s_axi_awid    : in  std_logic_vector(AXI_ID_WIDTH-1 downto 0);
 		s_axi_awaddr  : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+		s_axi_awlen   : in  std_logic_vector(7 downto 0);
+		s_axi_awsize  : in  std_logic_vector(2 downto 0);
+		s_axi_awburst : in  std_logic_vector(1 downto 0);
 		s_axi_awprot  : in  std_logic_vector(2 downto 0);
 		s_axi_awvalid : in  std_logic;
 		s_axi_awready : out std_logic;
@@ -59,6 +62,9 @@ architecture arch of periph_pwm is
 			
 			s_axi_awid    : in  std_logic_vector(AXI_ID_WIDTH-1 downto 0);
 			s_axi_awaddr  : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+			s_axi_awlen   : in  std_logic_vector(7 downto 0);
+			s_axi_awsize  : in  std_logic_vector(2 downto 0);
+			s_axi_awburst : in  std_logic_vector(1 downto 0);
 			s_axi_awprot  : in  std_logic_vector(2 downto 0);
 			s_axi_awvalid : in  std_logic;
 			s_axi_awready : out std_logic;
@@ -102,6 +108,9 @@ begin
 		
 		s_axi_awid    => s_axi_awid   ,
 		s_axi_awaddr  => s_axi_awaddr ,
+		s_axi_awlen   => s_axi_awlen  ,
+		s_axi_awsize  => s_axi_awsize ,
+		s_axi_awburst => s_axi_awburst,
 		s_axi_awprot  => s_axi_awprot ,
 		s_axi_awvalid => s_axi_awvalid,
 		s_axi_awready => s_axi_awready,
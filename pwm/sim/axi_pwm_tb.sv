@@ -7,7 +7,7 @@ module axi_pwm_tb();
 	
 	localparam NUM_OUTPUTS    = 4;
 	
-	localparam [11:0][AXI_DATA_WIDTH-1:0] regs_values = {
+	localparam [13:0][AXI_DATA_WIDTH-1:0] regs_values = {
 		32'd0  ,
 		32'd150,
 		32'd0  ,
@@ -18,16 +18,29 @@ module axi_pwm_tb();
 		32'd450,
 		32'd0  ,
 		32'd0  ,
+		32'd0  ,
+		32'd0  ,
 		32'd500,
-		32'd0  
+		32'd1  
 	};
 	
+	localparam FIRST_OUTPUT_REG = 6;
+	localparam NUM_OUTPUT_REGS  = 2*NUM_OUTPUTS;
+	
 	integer reg_number;
+	integer cycle;
+	integer start_cycle;
+	integer single_cycles;
+	integer burst_cycles;
+	reg     free_run;
 	
 	wire [NUM_OUTPUTS-1:0]      pwm          ;
 	
 	reg  [AXI_ID_WIDTH-1:0]     s_axi_awid   ;
 	reg  [AXI_ADDR_WIDTH-1:0]   s_axi_awaddr ;
+	reg  [7:0]                  s_axi_awlen  ;
+	reg  [2:0]                  s_axi_awsize ;
+	reg  [1:0]                  s_axi_awburst;
 	reg  [2:0]                  s_axi_awprot ;
 	reg                         s_axi_awvalid;
 	wire                        s_axi_awready;
@@ -68,6 +81,9 @@ module axi_pwm_tb();
 		               
 		.s_axi_awid   (s_axi_awid   ), // : in  std_logic_vector(AXI_ID_WIDTH-1 downto 0);
 		.s_axi_awaddr (s_axi_awaddr ), // : in  std_logic_vector(AXI_ADDR_WIDTH-1 downto 0);
+		.s_axi_awlen  (s_axi_awlen  ), // : in  std_logic_vector(7 downto 0);
+		.s_axi_awsize (s_axi_awsize ), // : in  std_logic_vector(2 downto 0);
+		.s_axi_awburst(s_axi_awburst), // : in  std_logic_vector(1 downto 0);
 		.s_axi_awprot (s_axi_awprot ), // : in  std_logic_vector(2 downto 0);
 		.s_axi_awvalid(s_axi_awvalid), // : in  std_logic;
 		.s_axi_awready(s_axi_awready), // : out std_logic;
@@ -98,15 +114,39 @@ module axi_pwm_tb();
 		.aresetn      (aresetn      )  // : in std_logic
 	);
 	
+	// Write consecutive registers, starting at first_reg, in a single INCR burst.
+	task automatic write_burst(input integer first_reg, input integer num_beats);
+		integer beat;
+		begin
+			s_axi_awaddr  <= 4*first_reg;
+			s_axi_awlen   <= num_beats-1;
+			s_axi_awvalid <= 1;
+			@(posedge aclk iff s_axi_awready);
+			s_axi_awvalid <= 0;
+			
+			for (beat = 0; beat < num_beats; beat = beat + 1) begin
+				s_axi_wdata  <= regs_values[first_reg+beat];
+				s_axi_wvalid <= 1;
+				@(posedge aclk iff s_axi_wready);
+			end
+			s_axi_wvalid  <= 0;
+			
+			@(posedge aclk iff s_axi_bvalid);
+		end
+	endtask
+	
 	initial begin
 		s_axi_awid    <= 0;
 		s_axi_awaddr  <= 0;
+		s_axi_awlen   <= 0;
+		s_axi_awsize  <= 2;
+		s_axi_awburst <= 1;
 		s_axi_awprot  <= 0;
-		s_axi_awvalid <= 1;
+		s_axi_awvalid <= 0;
 		
 		s_axi_wdata   <= 0;
 		s_axi_wstrb   <= -1;
-		s_axi_wvalid  <= 1;
+		s_axi_wvalid  <= 0;
 		
 		s_axi_bready  <= 1;
 		
@@ -118,6 +158,7 @@ module axi_pwm_tb();
 		s_axi_rready  <= 1;
 		
 		reg_number    <= 0;
+		free_run      <= 0;
 		
 		aclk          <= 1;
 		aresetn       <= 0;
@@ -125,23 +166,59 @@ module axi_pwm_tb();
 		#20;
 		
 		aresetn       <= 1;
+		
+		@(posedge aclk);
+		
+		// Full output bank update, one single-beat transaction per register.
+		start_cycle = cycle;
+		for (reg_number = 0; reg_number < NUM_OUTPUT_REGS; reg_number = reg_number + 1) begin
+			write_burst(FIRST_OUTPUT_REG+reg_number, 1);
+		end
+		single_cycles = cycle - start_cycle;
+		
+		// Full output bank update as one INCR burst.
+		start_cycle = cycle;
+		write_burst(FIRST_OUTPUT_REG, NUM_OUTPUT_REGS);
+		burst_cycles = cycle - start_cycle;
+		
+		$display(
+			"full bank update: %0d cycles single-beat, %0d cycles burst",
+			single_cycles,
+			burst_cycles
+		);
+		
+		reg_number    <= 0;
+		s_axi_awlen   <= 0;
+		s_axi_awvalid <= 1;
+		s_axi_wvalid  <= 1;
+		free_run      <= 1;
 	end
 	
 	always #5 aclk <= !aclk;
 	
 	always @(posedge(aclk)) begin
-		if (s_axi_awready == 1 && s_axi_awvalid == 1 && aresetn == 1) begin
-			if (reg_number >= 11) begin
-				reg_number <= 0;
-			end else begin
-				reg_number <= reg_number + 1;
+		if (aresetn == 0) begin
+			cycle <= 0;
+		end else begin
+			cycle <= cycle + 1;
+		end
+	end
+	
+	always @(posedge(aclk)) begin
+		if (free_run == 1) begin
+			if (s_axi_awready == 1 && s_axi_awvalid == 1) begin
+				if (reg_number >= 13) begin
+					reg_number <= 0;
+				end else begin
+					reg_number <= reg_number + 1;
+				end
 			end
+			
+			s_axi_awaddr  <= 4*reg_number;
+			
+			s_axi_wdata   <= regs_values[reg_number];
+			
+			s_axi_araddr  <= 4*reg_number;
 		end
-		
-		s_axi_awaddr  <= 4*reg_number;
-		
-		s_axi_wdata   <= regs_values[reg_number];
-		
-		s_axi_araddr  <= 4*reg_number;
 	end
 endmodule